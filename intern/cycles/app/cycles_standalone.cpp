@@ -7,6 +7,7 @@
 #include "scene/camera.h"
 #include "scene/integrator.h"
 #include "scene/scene.h"
+#include "scene/stats.h"
 #include "session/buffers.h"
 #include "session/session.h"
 
@@ -18,6 +19,7 @@
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/string.h"
+#include "util/texture_cache.h"
 #include "util/time.h"
 #include "util/transform.h"
 #include "util/unique_ptr.h"
@@ -48,6 +50,7 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string profile_filepath;
 } options;
 
 static void session_print(const string &str)
@@ -161,6 +164,21 @@ static void session_init()
 
 static void session_exit()
 {
+  if (options.session && options.session_params.use_profiling) {
+    RenderStats stats;
+    options.session->collect_statistics(&stats);
+
+    if (!options.profile_filepath.empty()) {
+      string report = stats.trace_report();
+      if (!path_write_text(options.profile_filepath, report)) {
+        fprintf(stderr, "Failed to write profile to %s\n", options.profile_filepath.c_str());
+      }
+    }
+    else if (options.session_params.background && !options.quiet) {
+      printf("\nRender statistics:\n%s\n", stats.full_report().c_str());
+    }
+  }
+
   if (options.session) {
     delete options.session;
     options.session = NULL;
@@ -383,6 +401,7 @@ static void options_parse(int argc, const char **argv)
   ArgParse ap;
   bool help = false, profile = false, debug = false, version = false;
   int verbosity = 1;
+  string tiled_texture_filepath;
 
   ap.options("Usage: cycles [options] file.xml",
              "%*",
@@ -420,12 +439,21 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--texture-cache %d",
+             &options.scene_params.texture_cache_size,
+             "Load image textures on demand into a cache of this many MB (CPU only)",
+             "--make-tiled-texture %s",
+             &tiled_texture_filepath,
+             "Convert an image to a tiled and mip-mapped .tx file for the texture cache",
              "--list-devices",
              &list,
              "List information about all available devices",
              "--profile",
              &profile,
              "Enable profile logging",
+             "--profile-output %s",
+             &options.profile_filepath,
+             "Enable profiling and write the result as Chrome trace JSON to this file",
 #ifdef WITH_CYCLES_LOGGING
              "--debug",
              &debug,
@@ -470,12 +498,22 @@ static void options_parse(int argc, const char **argv)
     printf("%s\n", CYCLES_VERSION_STRING);
     exit(EXIT_SUCCESS);
   }
+  else if (!tiled_texture_filepath.empty()) {
+    const string output_filepath = TextureCache::tiled_filepath(tiled_texture_filepath);
+    string error;
+    if (!TextureCache::make_tiled(tiled_texture_filepath, output_filepath, &error)) {
+      fprintf(stderr, "Failed to convert %s: %s\n", tiled_texture_filepath.c_str(), error.c_str());
+      exit(EXIT_FAILURE);
+    }
+    printf("Written %s\n", output_filepath.c_str());
+    exit(EXIT_SUCCESS);
+  }
   else if (help || options.filepath == "") {
     ap.usage();
     exit(EXIT_SUCCESS);
   }
 
-  options.session_params.use_profiling = profile;
+  options.session_params.use_profiling = profile || !options.profile_filepath.empty();
 
   if (ssname == "osl")
     options.scene_params.shadingsystem = SHADINGSYSTEM_OSL;
@@ -11,14 +11,34 @@ def _configure_argument_parser():
     parser.add_argument("--cycles-print-stats",
                         help="Print rendering statistics to stderr",
                         action='store_true')
+    parser.add_argument("--cycles-profile-output",
+                        help="Profile CPU renders and write the result as Chrome trace JSON to this file, "
+                             "'#' characters are replaced by the frame number",
+                        default=None)
     parser.add_argument("--cycles-device",
                         help="Set the device to use for Cycles, overriding user preferences and the scene setting."
                              "Valid options are 'CPU', 'CUDA', 'OPTIX', 'HIP', 'ONEAPI', or 'METAL'."
                              "Additionally, you can append '+CPU' to any GPU type for hybrid rendering.",
                         default=None)
+    parser.add_argument("--cycles-persistent-data",
+                        help="Keep the render data of each scene between frames of an animation render, "
+                             "so only changes are synchronized and updated for the next frame",
+                        action='store_true')
     return parser
 
 
+def _enable_persistent_data_handler():
+    from bpy.app.handlers import persistent
+
+    @persistent
+    def enable_persistent_data(_):
+        import bpy
+        for scene in bpy.data.scenes:
+            scene.render.use_persistent_data = True
+
+    return enable_persistent_data
+
+
 def _parse_command_line():
     import sys
 
@@ -33,10 +53,20 @@ def _parse_command_line():
         import _cycles
         _cycles.enable_print_stats()
 
+    if args.cycles_profile_output:
+        import _cycles
+        _cycles.set_profile_output(args.cycles_profile_output)
+
     if args.cycles_device:
         import _cycles
         _cycles.set_device_override(args.cycles_device)
 
+    if args.cycles_persistent_data:
+        # Files given on the command line are loaded after the add-on is registered,
+        # so the setting has to be applied to every file when it is loaded.
+        import bpy
+        bpy.app.handlers.load_post.append(_enable_persistent_data_handler())
+
 
 def init():
     import bpy
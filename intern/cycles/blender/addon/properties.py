@@ -944,6 +944,18 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=8, max=8192,
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Load image textures on demand in mip-mapped tiles when rendering on the CPU, instead of loading them fully into memory. Converted tiled .tx files next to the images are used when available",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache in megabytes, least recently used tiles are discarded beyond it",
+        default=4096,
+        min=64, max=1048576,
+    )
+
     # Various fine-tuning debug flags
 
     def _devices_update_callback(self, context):
@@ -959,6 +971,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Render batches of paths one kernel at a time with shading sorted by shader, which can be faster for scenes with many materials",
+        default=False,
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
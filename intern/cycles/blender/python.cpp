@@ -66,6 +66,7 @@ static void debug_flags_sync_from_scene(BL::Scene b_scene)
   flags.cpu.sse41 = get_boolean(cscene, "debug_use_cpu_sse41");
   flags.cpu.sse2 = get_boolean(cscene, "debug_use_cpu_sse2");
   flags.cpu.bvh_layout = (BVHLayout)get_enum(cscene, "debug_bvh_layout");
+  flags.cpu.wavefront = get_boolean(cscene, "debug_use_cpu_wavefront");
   /* Synchronize CUDA flags. */
   flags.cuda.adaptive_compile = get_boolean(cscene, "debug_use_cuda_adaptive_compile");
   /* Synchronize OptiX flags. */
@@ -873,6 +874,15 @@ static PyObject *enable_print_stats_func(PyObject * /*self*/, PyObject * /*args*
   Py_RETURN_NONE;
 }
 
+static PyObject *set_profile_output_func(PyObject * /*self*/, PyObject *arg)
+{
+  PyObject *filepath_string = PyObject_Str(arg);
+  BlenderSession::profile_filepath = PyUnicode_AsUTF8(filepath_string);
+  Py_DECREF(filepath_string);
+
+  Py_RETURN_NONE;
+}
+
 static PyObject *get_device_types_func(PyObject * /*self*/, PyObject * /*args*/)
 {
   vector<DeviceType> device_types = Device::available_types();
@@ -966,6 +976,7 @@ static PyMethodDef methods[] = {
 
     /* Statistics. */
     {"enable_print_stats", enable_print_stats_func, METH_NOARGS, ""},
+    {"set_profile_output", set_profile_output_func, METH_O, ""},
 
     /* Compute Device selection */
     {"get_device_types", get_device_types_func, METH_VARARGS, ""},
@@ -40,6 +40,7 @@ CCL_NAMESPACE_BEGIN
 DeviceTypeMask BlenderSession::device_override = DEVICE_MASK_ALL;
 bool BlenderSession::headless = false;
 bool BlenderSession::print_render_stats = false;
+string BlenderSession::profile_filepath;
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -394,11 +395,13 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
     }
 
     /* update scene */
+    scoped_timer sync_timer;
     BL::Object b_camera_override(b_engine.camera_override());
     sync->sync_camera(b_render, b_camera_override, width, height, b_rview_name.c_str());
     sync->sync_data(
         b_render, b_depsgraph, b_v3d, b_camera_override, width, height, &python_thread_state);
     builtin_images_load();
+    session->progress.add_sync_time(sync_timer.get_time());
 
     /* Attempt to free all data which is held by Blender side, since at this
      * point we know that we've got everything to render current view layer.
@@ -444,6 +447,10 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
       printf("Render statistics:\n%s\n", stats.full_report().c_str());
     }
 
+    if (!b_engine.is_preview() && background && !profile_filepath.empty()) {
+      write_profile(b_view_layer.name(), b_rview_name);
+    }
+
     if (session->progress.get_cancel())
       break;
   }
@@ -463,6 +470,62 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
   session->progress.get_time(total_time, render_time);
   VLOG_INFO << "Total render time: " << total_time;
   VLOG_INFO << "Render time (without synchronization): " << render_time;
+
+  double sync_time, update_time;
+  session->progress.get_sync_update_time(sync_time, update_time);
+  VLOG_INFO << "Synchronization time: " << sync_time;
+  VLOG_INFO << "Scene update time: " << update_time;
+
+  /* With persistent data only the changes are synchronized and updated for every frame after
+   * the first one, report the times so the difference is visible for animation renders. */
+  if (!b_engine.is_preview() && background &&
+      (print_render_stats || b_render.use_persistent_data())) {
+    printf("Cycles: frame %d, synchronization %.2fs, scene update %.2fs, render %.2fs%s\n",
+           b_scene.frame_current(),
+           sync_time,
+           update_time,
+           render_time,
+           b_render.use_persistent_data() ? " (persistent data)" : "");
+  }
+}
+
+void BlenderSession::write_profile(const string &view_layer_name, const string &view_name)
+{
+  RenderStats stats;
+  session->collect_statistics(&stats);
+
+  /* Like for render output paths, replace `#` characters with the frame number, so that every
+   * frame of an animation gets its own file. Files of several layers and views are told apart by
+   * a suffix. */
+  string filepath = profile_filepath;
+  const size_t hash_start = filepath.find('#');
+  if (hash_start != string::npos) {
+    const size_t hash_end = filepath.find_first_not_of('#', hash_start);
+    const size_t num_digits = ((hash_end == string::npos) ? filepath.size() : hash_end) -
+                              hash_start;
+    filepath.replace(hash_start,
+                     num_digits,
+                     string_printf("%0*d", int(num_digits), b_scene.frame_current()));
+  }
+
+  if (b_scene.view_layers.length() > 1 || !view_name.empty()) {
+    string suffix = "_" + view_layer_name;
+    if (!view_name.empty()) {
+      suffix += "_" + view_name;
+    }
+    const size_t extension_start = filepath.rfind('.');
+    if (extension_start != string::npos && extension_start > filepath.rfind('/')) {
+      filepath.insert(extension_start, suffix);
+    }
+    else {
+      filepath += suffix;
+    }
+  }
+
+  string report = stats.trace_report();
+  if (!path_write_text(filepath, report)) {
+    fprintf(stderr, "Cycles: failed to write profile to %s\n", filepath.c_str());
+  }
 }
 
 void BlenderSession::render_frame_finish()
@@ -119,9 +119,14 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* Write kernel profiling information of renders to this file, see RenderStats::trace_report. */
+  static string profile_filepath;
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  void write_profile(const string &view_layer_name, const string &view_name);
+
   /* Check whether session error happened.
    * If so, it is reported to the render engine and true is returned.
    * Otherwise false is returned. */
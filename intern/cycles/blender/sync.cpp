@@ -825,9 +825,14 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene,
     params.texture_limit = 0;
   }
 
+  params.texture_cache_size = RNA_boolean_get(&cscene, "use_texture_cache") ?
+                                  RNA_int_get(&cscene, "texture_cache_size") :
+                                  0;
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
+  params.use_persistent_data = background && b_scene.render().use_persistent_data();
 
   return params;
 }
@@ -920,7 +925,8 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
 
   /* Profiling. */
   params.use_profiling = params.device.has_profiling && !b_engine.is_preview() && background &&
-                         BlenderSession::print_render_stats;
+                         (BlenderSession::print_render_stats ||
+                          !BlenderSession::profile_filepath.empty());
 
   if (background) {
     params.use_auto_tile = RNA_boolean_get(&cscene, "use_auto_tile");
@@ -81,6 +81,13 @@ class BVH {
     this->objects = objects;
   }
 
+  /* True when the last refit degraded the hierarchy too much compared to a fresh build, so it
+   * should be rebuilt. BVH types that can not measure this handle it while refitting, if at all. */
+  virtual bool need_rebuild_after_refit() const
+  {
+    return false;
+  }
+
  protected:
   BVH(const BVHParams &params,
       const vector<Geometry *> &geometry,
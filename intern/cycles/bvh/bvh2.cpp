@@ -55,6 +55,12 @@ void BVH2::build(Progress &progress, Stats *)
     return;
   }
 
+  /* Reference for the quality of later refits. */
+  if (!params.top_level) {
+    build_sah_cost = bvh2_root->computeSubtreeSAHCost(params);
+    refit_sah_cost = build_sah_cost;
+  }
+
   /* BVH builder returns tree in a binary mode (with two children per inner
    * node. Need to adopt that for a wider BVH implementations. */
   BVHNode *root = widen_children_nodes(bvh2_root);
@@ -98,6 +104,11 @@ void BVH2::refit(Progress &progress)
   refit_nodes();
 }
 
+bool BVH2::need_rebuild_after_refit() const
+{
+  return refit_sah_cost > build_sah_cost * params.refit_max_cost_ratio;
+}
+
 BVHNode *BVH2::widen_children_nodes(const BVHNode *root)
 {
   return const_cast<BVHNode *>(root);
@@ -307,10 +318,15 @@ void BVH2::refit_nodes()
 
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float area_cost = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility, area_cost);
+
+  /* Same as BVHNode::computeSubtreeSAHCost(), node probabilities relative to the root. */
+  const float root_area = bbox.safe_area();
+  refit_sah_cost = (root_area > 0.0f) ? area_cost / root_area : build_sah_cost;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &area_cost)
 {
   if (leaf) {
     /* refit leaf node */
@@ -320,6 +336,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c1 = data[0].y;
 
     refit_primitives(c0, c1, bbox, visibility);
+    area_cost += bbox.safe_area() * params.cost(0, c1 - c0);
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -340,8 +357,8 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0, area_cost);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1, area_cost);
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
@@ -355,6 +372,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    area_cost += bbox.safe_area() * params.cost(2, 0);
   }
 }
 
@@ -35,6 +35,8 @@ class BVH2 : public BVH {
   void build(Progress &progress, Stats *stats);
   void refit(Progress &progress);
 
+  virtual bool need_rebuild_after_refit() const;
+
   PackedBVH pack;
 
  protected:
@@ -79,7 +81,7 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &area_cost);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
@@ -90,6 +92,10 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+
+  /* SAH cost of the hierarchy after the last build and the last refit. */
+  float build_sah_cost = 0.0f;
+  float refit_sah_cost = 0.0f;
 };
 
 CCL_NAMESPACE_END
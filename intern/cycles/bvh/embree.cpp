@@ -34,6 +34,7 @@
 #  include "util/log.h"
 #  include "util/progress.h"
 #  include "util/stats.h"
+#  include "util/tbb.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -135,6 +136,9 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
                                                         RTC_BUILD_QUALITY_MEDIUM);
   rtcSetSceneBuildQuality(scene, build_quality);
 
+  refit_proxies.clear();
+  refit_proxies.resize(objects.size());
+
   int i = 0;
   foreach (Object *ob, objects) {
     if (params.top_level) {
@@ -165,9 +169,84 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
   rtcCommitScene(scene);
 }
 
+/* Primitives in a leaf of the refit proxy hierarchy. */
+static const int EMBREE_REFIT_PROXY_LEAF_SIZE = 4;
+/* Primitives per task when computing bounds and sort keys for the refit proxy. */
+static const size_t EMBREE_REFIT_PROXY_GRAIN_SIZE = 4096;
+
+static void geometry_primitive_bounds(const Geometry *geom, vector<BoundBox> &r_bounds)
+{
+  r_bounds.clear();
+  if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
+    const Mesh *mesh = static_cast<const Mesh *>(geom);
+    const float3 *verts = mesh->get_verts().data();
+    r_bounds.resize(mesh->num_triangles());
+    parallel_for(blocked_range<size_t>(0, r_bounds.size(), EMBREE_REFIT_PROXY_GRAIN_SIZE),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t j = r.begin(); j != r.end(); j++) {
+                     r_bounds[j] = BoundBox::empty;
+                     mesh->get_triangle(j).bounds_grow(verts, r_bounds[j]);
+                   }
+                 });
+  }
+  else if (geom->geometry_type == Geometry::HAIR) {
+    const Hair *hair = static_cast<const Hair *>(geom);
+    const float3 *keys = hair->get_curve_keys().data();
+    const float *radius = hair->get_curve_radius().data();
+    vector<size_t> segment_offsets(hair->num_curves());
+    size_t num_segments = 0;
+    for (size_t j = 0; j < hair->num_curves(); ++j) {
+      segment_offsets[j] = num_segments;
+      num_segments += hair->get_curve(j).num_segments();
+    }
+    r_bounds.resize(num_segments);
+    parallel_for(blocked_range<size_t>(0, hair->num_curves(), EMBREE_REFIT_PROXY_GRAIN_SIZE),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t j = r.begin(); j != r.end(); j++) {
+                     const Hair::Curve curve = hair->get_curve(j);
+                     for (int k = 0; k < curve.num_segments(); ++k) {
+                       BoundBox &bounds = r_bounds[segment_offsets[j] + k];
+                       bounds = BoundBox::empty;
+                       curve.bounds_grow(k, keys, radius, bounds);
+                     }
+                   }
+                 });
+  }
+  else if (geom->geometry_type == Geometry::POINTCLOUD) {
+    const PointCloud *pointcloud = static_cast<const PointCloud *>(geom);
+    const float3 *points = pointcloud->get_points().data();
+    const float *radius = pointcloud->get_radius().data();
+    r_bounds.resize(pointcloud->num_points());
+    parallel_for(blocked_range<size_t>(0, r_bounds.size(), EMBREE_REFIT_PROXY_GRAIN_SIZE),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t j = r.begin(); j != r.end(); j++) {
+                     r_bounds[j] = BoundBox::empty;
+                     pointcloud->get_point(j).bounds_grow(points, radius, r_bounds[j]);
+                   }
+                 });
+  }
+}
+
+/* Spread the lower 10 bits of x so there are two zero bits between each of them. */
+static uint morton_expand_bits(uint x)
+{
+  x = (x * 0x00010001u) & 0xFF0000FFu;
+  x = (x * 0x00000101u) & 0x0F00F00Fu;
+  x = (x * 0x00000011u) & 0xC30C30C3u;
+  x = (x * 0x00000005u) & 0x49249249u;
+  return x;
+}
+
 void BVHEmbree::add_object(Object *ob, int i)
 {
   Geometry *geom = ob->get_geometry();
+  /* Without persistent data a final render BVH is never refitted, in that case the proxy is only
+   * made on the first refit. */
+  if (params.bvh_type == BVH_TYPE_DYNAMIC || params.use_persistent_data) {
+    vector<BoundBox> prim_bounds;
+    geometry_primitive_bounds(geom, prim_bounds);
+    refit_proxy_build(prim_bounds, i);
+  }
 
   if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
     Mesh *mesh = static_cast<Mesh *>(geom);
@@ -569,12 +648,104 @@ void BVHEmbree::add_curves(const Object *ob, const Hair *hair, int i)
   rtcReleaseGeometry(geom_id);
 }
 
+void BVHEmbree::refit_proxy_build(const vector<BoundBox> &prim_bounds, int i)
+{
+  RefitProxy &proxy = refit_proxies[i];
+
+  BoundBox centroid_bounds = BoundBox::empty;
+  for (const BoundBox &bounds : prim_bounds) {
+    centroid_bounds.grow(bounds.center());
+  }
+  const float3 scale = 1023.0f / max(centroid_bounds.size(), make_float3(1e-30f));
+
+  vector<std::pair<uint, int>> keys(prim_bounds.size());
+  parallel_for(blocked_range<size_t>(0, prim_bounds.size(), EMBREE_REFIT_PROXY_GRAIN_SIZE),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t j = r.begin(); j != r.end(); j++) {
+                   const float3 p = min((prim_bounds[j].center() - centroid_bounds.min) * scale,
+                                        make_float3(1023.0f));
+                   const uint code = (morton_expand_bits(uint(p.x)) << 2) |
+                                     (morton_expand_bits(uint(p.y)) << 1) |
+                                     morton_expand_bits(uint(p.z));
+                   keys[j] = {code, int(j)};
+                 }
+               });
+  std::sort(keys.begin(), keys.end());
+
+  proxy.order.resize(keys.size());
+  for (size_t j = 0; j < keys.size(); ++j) {
+    proxy.order[j] = keys[j].second;
+  }
+  proxy.build_sah_cost = refit_proxy_cost(prim_bounds, proxy.order);
+  proxy.valid = true;
+}
+
+float BVHEmbree::refit_proxy_cost(const vector<BoundBox> &prim_bounds,
+                                  const vector<int> &order) const
+{
+  /* Leaves of consecutive primitives, then a binary hierarchy over consecutive nodes. */
+  vector<BoundBox> level;
+  float area_cost = 0.0f;
+  for (size_t start = 0; start < order.size(); start += EMBREE_REFIT_PROXY_LEAF_SIZE) {
+    const size_t end = min(start + EMBREE_REFIT_PROXY_LEAF_SIZE, order.size());
+    BoundBox bounds = BoundBox::empty;
+    for (size_t j = start; j < end; ++j) {
+      bounds.grow(prim_bounds[order[j]]);
+    }
+    area_cost += bounds.safe_area() * params.cost(0, int(end - start));
+    level.push_back(bounds);
+  }
+  while (level.size() > 1) {
+    for (size_t j = 0; j < level.size(); j += 2) {
+      BoundBox bounds = level[j];
+      if (j + 1 < level.size()) {
+        bounds.grow(level[j + 1]);
+      }
+      area_cost += bounds.safe_area() * params.cost(2, 0);
+      level[j / 2] = bounds;
+    }
+    level.resize((level.size() + 1) / 2);
+  }
+
+  /* Same as #BVH2::refit_nodes(), node probabilities relative to the root. */
+  const float root_area = level.empty() ? 0.0f : level[0].safe_area();
+  return (root_area > 0.0f) ? area_cost / root_area : 0.0f;
+}
+
+void BVHEmbree::set_refit_build_quality(RTCGeometry geom_id, const Geometry *geom, int i)
+{
+  /* Refitting keeps the topology of the BVH, which gets slower to trace as primitives move
+   * apart. Rebuild the geometry when the refitted proxy hierarchy got too expensive, with the
+   * same threshold as #BVH2::need_rebuild_after_refit(). */
+  const RefitProxy &proxy = refit_proxies[i];
+  vector<BoundBox> prim_bounds;
+  geometry_primitive_bounds(geom, prim_bounds);
+
+  if (!proxy.valid) {
+    /* Not made when the geometry was built, measure degradation from this refit on. */
+    rtcSetGeometryBuildQuality(geom_id, RTC_BUILD_QUALITY_REFIT);
+    refit_proxy_build(prim_bounds, i);
+    return;
+  }
+
+  const bool same_primitives = prim_bounds.size() == proxy.order.size();
+  if (!same_primitives || refit_proxy_cost(prim_bounds, proxy.order) >
+                              proxy.build_sah_cost * params.refit_max_cost_ratio) {
+    rtcSetGeometryBuildQuality(geom_id, build_quality);
+    refit_proxy_build(prim_bounds, i);
+  }
+  else {
+    rtcSetGeometryBuildQuality(geom_id, RTC_BUILD_QUALITY_REFIT);
+  }
+}
+
 void BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
   /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
   unsigned geom_id = 0;
+  int i = 0;
   foreach (Object *ob, objects) {
     if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
       Geometry *geom = ob->get_geometry();
@@ -584,6 +755,7 @@ void BVHEmbree::refit(Progress &progress)
         if (mesh->num_triangles() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
           set_tri_vertex_buffer(geom, mesh, true);
+          set_refit_build_quality(geom, mesh, i);
           rtcSetGeometryUserData(geom, (void *)mesh->prim_offset);
           rtcCommitGeometry(geom);
         }
@@ -593,6 +765,7 @@ void BVHEmbree::refit(Progress &progress)
         if (hair->num_curves() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id + 1);
           set_curve_vertex_buffer(geom, hair, true);
+          set_refit_build_quality(geom, hair, i);
           rtcSetGeometryUserData(geom, (void *)hair->curve_segment_offset);
           rtcCommitGeometry(geom);
         }
@@ -602,11 +775,13 @@ void BVHEmbree::refit(Progress &progress)
         if (pointcloud->num_points() > 0) {
           RTCGeometry geom = rtcGetGeometry(scene, geom_id);
           set_point_vertex_buffer(geom, pointcloud, true);
+          set_refit_build_quality(geom, pointcloud, i);
           rtcCommitGeometry(geom);
         }
       }
     }
     geom_id += 2;
+    i++;
   }
 
   rtcCommitScene(scene);
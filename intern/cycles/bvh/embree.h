@@ -12,6 +12,7 @@
 #  include "bvh/bvh.h"
 #  include "bvh/params.h"
 
+#  include "util/boundbox.h"
 #  include "util/thread.h"
 #  include "util/types.h"
 #  include "util/vector.h"
@@ -49,8 +50,25 @@ class BVHEmbree : public BVH {
                                const PointCloud *pointcloud,
                                const bool update);
 
+  void refit_proxy_build(const vector<BoundBox> &prim_bounds, int i);
+  float refit_proxy_cost(const vector<BoundBox> &prim_bounds, const vector<int> &order) const;
+  void set_refit_build_quality(RTCGeometry geom_id, const Geometry *geom, int i);
+
   RTCDevice rtc_device;
   enum RTCBuildQuality build_quality;
+
+  /* Stand-in for the hierarchy Embree built for a geometry, used to measure how much refitting
+   * degrades it. Embree does not expose its nodes, so the primitives are ordered along a Morton
+   * curve when the geometry is built, and a fixed hierarchy over that order is refitted and
+   * measured with the same SAH cost as #BVH2 instead. Like Embree's topology, the order is kept
+   * until the geometry is rebuilt. */
+  struct RefitProxy {
+    vector<int> order;
+    float build_sah_cost = 0.0f;
+    bool valid = false;
+  };
+  /* Indexed like objects. */
+  vector<RefitProxy> refit_proxies;
 };
 
 CCL_NAMESPACE_END
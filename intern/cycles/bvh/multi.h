@@ -22,6 +22,7 @@ class BVHMulti : public BVH {
 
   virtual void replace_geometry(const vector<Geometry *> &geometry,
                                 const vector<Object *> &objects);
+  virtual bool need_rebuild_after_refit() const;
 };
 
 CCL_NAMESPACE_END
@@ -64,6 +64,10 @@ class BVHParams {
   float sah_node_cost;
   float sah_primitive_cost;
 
+  /* Refitting keeps the topology of the hierarchy while primitives move, rebuild instead once
+   * the cost of the refitted hierarchy exceeds the cost after the build by this ratio. */
+  float refit_max_cost_ratio;
+
   /* number of primitives in leaf */
   int min_leaf_size;
   int max_triangle_leaf_size;
@@ -100,6 +104,7 @@ class BVHParams {
 
   /* Same as in SceneParams. */
   int bvh_type;
+  bool use_persistent_data;
 
   /* These are needed for Embree. */
   int curve_subdivisions;
@@ -119,6 +124,8 @@ class BVHParams {
     sah_node_cost = 1.0f;
     sah_primitive_cost = 1.0f;
 
+    refit_max_cost_ratio = 1.5f;
+
     min_leaf_size = 1;
     max_triangle_leaf_size = 8;
     max_motion_triangle_leaf_size = 8;
@@ -137,6 +144,7 @@ class BVHParams {
     num_motion_point_steps = 0;
 
     bvh_type = 0;
+    use_persistent_data = false;
 
     curve_subdivisions = 4;
   }
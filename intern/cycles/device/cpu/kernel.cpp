@@ -28,8 +28,12 @@ CPUKernels::CPUKernels()
       REGISTER_KERNEL(integrator_shade_light),
       REGISTER_KERNEL(integrator_shade_shadow),
       REGISTER_KERNEL(integrator_shade_surface),
+      REGISTER_KERNEL(integrator_shade_surface_raytrace),
+      REGISTER_KERNEL(integrator_shade_surface_mnee),
       REGISTER_KERNEL(integrator_shade_volume),
       REGISTER_KERNEL(integrator_megakernel),
+      REGISTER_KERNEL(integrator_intersect_shadow_ao),
+      REGISTER_KERNEL(integrator_shade_shadow_ao),
       /* Shader evaluation. */
       REGISTER_KERNEL(shader_eval_displace),
       REGISTER_KERNEL(shader_eval_background),
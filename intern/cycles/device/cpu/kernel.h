@@ -37,8 +37,12 @@ class CPUKernels {
   IntegratorShadeFunction integrator_shade_light;
   IntegratorShadeFunction integrator_shade_shadow;
   IntegratorShadeFunction integrator_shade_surface;
+  IntegratorShadeFunction integrator_shade_surface_raytrace;
+  IntegratorShadeFunction integrator_shade_surface_mnee;
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_megakernel;
+  IntegratorFunction integrator_intersect_shadow_ao;
+  IntegratorShadeFunction integrator_shade_shadow_ao;
 
   /* Shader evaluation. */
 
@@ -167,6 +167,7 @@ device_texture::device_texture(Device *device,
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
     case IMAGE_DATA_TYPE_NANOVDB_FPN:
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
       data_type = TYPE_UCHAR;
       data_elements = 1;
       break;
@@ -948,19 +948,19 @@ bool PathTrace::copy_render_tile_from_device()
   return success;
 }
 
-static string get_layer_view_name(const RenderBuffers &buffers)
+static string get_layer_view_name(const BufferParams &params)
 {
   string result;
 
-  if (buffers.params.layer.size()) {
-    result += string(buffers.params.layer);
+  if (params.layer.size()) {
+    result += string(params.layer);
   }
 
-  if (buffers.params.view.size()) {
+  if (params.view.size()) {
     if (!result.empty()) {
       result += ", ";
     }
-    result += string(buffers.params.view);
+    result += string(params.view);
   }
 
   return result;
@@ -972,28 +972,38 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
 
   progress_set_status("Reading full buffer from disk");
 
-  RenderBuffers full_frame_buffers(cpu_device_.get());
-
+  BufferParams full_params;
   DenoiseParams denoise_params;
-  if (!tile_manager_.read_full_buffer_from_disk(filename, &full_frame_buffers, &denoise_params)) {
-    const string error_message = "Error reading tiles from file";
-    if (progress_) {
-      progress_->set_error(error_message);
-      progress_->set_cancel(error_message);
-    }
-    else {
-      LOG(ERROR) << error_message;
-    }
+  int2 tile_size;
+  if (!tile_manager_.open_full_buffer_from_disk(
+          filename, &full_params, &denoise_params, &tile_size)) {
+    full_buffer_error("Error reading tiles from file");
     return;
   }
 
-  const string layer_view_name = get_layer_view_name(full_frame_buffers);
+  /* Process the full frame in tiles of the size it was rendered with, so that the peak memory
+   * usage is defined by the tile size rather than by the frame size. When denoising, every tile
+   * is read with the overscan around it, so the buffer holds (tile size + 2 * overscan) pixels in
+   * each dimension, which is about 13% more than the tile for the default 2048 tiles but several
+   * times the tile for very small tiles. Files which do not store the tile size are processed as
+   * a single tile. */
+  if (tile_size.x == 0 || tile_size.y == 0) {
+    tile_size = make_int2(full_params.width, full_params.height);
+  }
+  const int num_tiles_x = divide_up(full_params.width, tile_size.x);
+  const int num_tiles_y = divide_up(full_params.height, tile_size.y);
+  const int num_tiles = num_tiles_x * num_tiles_y;
+
+  /* Denoise tiles together with some of their neighborhood, avoiding seams between them. */
+  const int overscan = (denoise_params.use && num_tiles > 1) ?
+                           TileManager::DENOISE_TILE_OVERSCAN :
+                           0;
+
+  const string layer_view_name = get_layer_view_name(full_params);
 
   render_state_.has_denoised_result = false;
 
   if (denoise_params.use) {
-    progress_set_status(layer_view_name, "Denoising");
-
     /* Re-use the denoiser as much as possible, avoiding possible device re-initialization.
      *
      * It will not conflict with the regular rendering as:
@@ -1001,22 +1011,65 @@ void PathTrace::process_full_buffer_from_disk(string_view filename)
      *  - The next rendering will go via Session's `run_update_for_next_iteration` which will
      *    ensure proper denoiser is used. */
     set_denoiser_params(denoise_params);
+  }
 
-    /* Number of samples doesn't matter too much, since the samples count pass will be used. */
-    denoiser_->denoise_buffer(full_frame_buffers.params, &full_frame_buffers, 0, false);
+  RenderBuffers tile_buffers(cpu_device_.get());
 
-    render_state_.has_denoised_result = true;
-  }
+  bool success = true;
+  for (int tile_index = 0; tile_index < num_tiles; ++tile_index) {
+    const int tile_x = (tile_index % num_tiles_x) * tile_size.x;
+    const int tile_y = (tile_index / num_tiles_x) * tile_size.y;
+    const int tile_width = min(tile_size.x, full_params.width - tile_x);
+    const int tile_height = min(tile_size.y, full_params.height - tile_y);
+
+    const string tile_status = (num_tiles > 1) ?
+                                   string_printf(", Tile %d/%d", tile_index + 1, num_tiles) :
+                                   "";
+
+    if (!tile_manager_.read_full_buffer_region_from_disk(
+            tile_x, tile_y, tile_width, tile_height, overscan, &tile_buffers)) {
+      success = false;
+      break;
+    }
 
-  full_frame_state_.render_buffers = &full_frame_buffers;
+    if (denoise_params.use) {
+      progress_set_status(layer_view_name, "Denoising" + tile_status);
 
-  progress_set_status(layer_view_name, "Finishing");
+      /* Number of samples doesn't matter too much, since the samples count pass will be used. */
+      denoiser_->denoise_buffer(tile_buffers.params, &tile_buffers, 0, false);
 
-  /* Write the full result pretending that there is a single tile.
-   * Requires some state change, but allows to use same communication API with the software. */
-  tile_buffer_write();
+      render_state_.has_denoised_result = true;
+    }
+
+    full_frame_state_.render_buffers = &tile_buffers;
+    full_frame_state_.tile_offset = make_int2(tile_x, tile_y);
+
+    progress_set_status(layer_view_name, "Finishing" + tile_status);
+
+    /* Write the result pretending that the region of the full frame is a regular tile.
+     * Requires some state change, but allows to use same communication API with the software. */
+    tile_buffer_write();
+  }
 
   full_frame_state_.render_buffers = nullptr;
+  full_frame_state_.tile_offset = make_int2(0, 0);
+
+  tile_manager_.close_full_buffer_from_disk();
+
+  if (!success) {
+    full_buffer_error("Error reading tiles from file");
+  }
+}
+
+void PathTrace::full_buffer_error(const string &error_message)
+{
+  if (progress_) {
+    progress_->set_error(error_message);
+    progress_->set_cancel(error_message);
+  }
+  else {
+    LOG(ERROR) << error_message;
+  }
 }
 
 int PathTrace::get_num_render_tile_samples() const
@@ -1084,7 +1137,7 @@ int2 PathTrace::get_render_tile_size() const
 int2 PathTrace::get_render_tile_offset() const
 {
   if (full_frame_state_.render_buffers) {
-    return make_int2(0, 0);
+    return full_frame_state_.tile_offset;
   }
 
   const Tile &tile = tile_manager_.get_current_tile();
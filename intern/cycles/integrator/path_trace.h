@@ -238,6 +238,9 @@ class PathTrace {
   /* Write current tile into the file on disk. */
   void tile_buffer_write_to_disk();
 
+  /* Report an error which happened while processing full frame buffer from disk. */
+  void full_buffer_error(const string &error_message);
+
   /* Run the progress_update_cb callback if it is needed. */
   void progress_update_if_needed(const RenderWork &render_work);
 
@@ -348,6 +351,9 @@ class PathTrace {
   /* State of the full frame processing and writing to the software. */
   struct {
     RenderBuffers *render_buffers = nullptr;
+
+    /* Position of the render buffers window in the full frame. */
+    int2 tile_offset = make_int2(0, 0);
   } full_frame_state_;
 };
 
@@ -15,9 +15,12 @@
 #include "scene/scene.h"
 #include "session/buffers.h"
 
+#include "util/algorithm.h"
 #include "util/atomic.h"
+#include "util/debug.h"
 #include "util/log.h"
 #include "util/tbb.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -41,6 +44,13 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
   return &kernel_thread_globals[thread_index];
 }
 
+/* Number of pixels rendered together in wavefront mode. Every path needs a full
+ * #IntegratorStateCPU of about 50 KB, most of it the shadow intersection arrays, so one batch
+ * takes about 6.4 MB per thread, twice that with a shadow catcher. That is too much to stay in
+ * cache anyway, the states of a path are mostly touched by its own kernels. The batch size is a
+ * trade-off between having enough paths to sort by shader and the memory per thread. */
+static constexpr int WAVEFRONT_BATCH_PIXELS = 128;
+
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
@@ -55,6 +65,24 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  /* States are allocated by each thread on first use. */
+  wavefront_states_.clear();
+  wavefront_states_.resize(kernel_thread_globals_.size());
+}
+
+bool PathTraceWorkCPU::use_wavefront() const
+{
+  if (!DebugFlags().cpu.wavefront) {
+    return false;
+  }
+#ifdef WITH_PATH_GUIDING
+  /* Training collects the segments of one path at a time in the thread globals. */
+  if (!kernel_thread_globals_.empty() && kernel_thread_globals_[0].data.integrator.train_guiding) {
+    return false;
+  }
+#endif
+  return true;
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
@@ -66,45 +94,112 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
   const int64_t image_height = effective_buffer_params_.height;
   const int64_t total_pixels_num = image_width * image_height;
 
+  /* Only schedule pixels which are not converged yet, packed together, when the adaptive
+   * sampling filter found some of them converged. */
+  const bool use_active_pixels = active_pixels_valid();
+  const int64_t work_pixels_num = use_active_pixels ? int64_t(active_pixels_.size()) :
+                                                      total_pixels_num;
+  auto work_pixel_index = [&](const int64_t work_index) -> int64_t {
+    return use_active_pixels ? active_pixels_[work_index] : work_index;
+  };
+
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.start_profiling();
     }
   }
 
+  /* Time each thread spent rendering, to measure occupancy. */
+  vector<double> thread_busy_time(kernel_thread_globals_.size(), 0.0);
+  const double start_time = time_dt();
+
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
-  local_arena.execute([&]() {
-    parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
-      if (is_cancel_requested()) {
-        return;
-      }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+  if (use_wavefront()) {
+    const int64_t batches_num = divide_up(work_pixels_num, int64_t(WAVEFRONT_BATCH_PIXELS));
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), batches_num, [&](int64_t batch_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const double batch_start_time = time_dt();
+
+        const int64_t first_pixel = batch_index * WAVEFRONT_BATCH_PIXELS;
+        const int pixels_num = int(
+            std::min<int64_t>(WAVEFRONT_BATCH_PIXELS, work_pixels_num - first_pixel));
+
+        int64_t pixel_indices[WAVEFRONT_BATCH_PIXELS];
+        for (int i = 0; i < pixels_num; i++) {
+          pixel_indices[i] = work_pixel_index(first_pixel + i);
+        }
 
-      KernelWorkTile work_tile;
-      work_tile.x = effective_buffer_params_.full_x + x;
-      work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
-      work_tile.start_sample = start_sample;
-      work_tile.sample_offset = sample_offset;
-      work_tile.num_samples = 1;
-      work_tile.offset = effective_buffer_params_.offset;
-      work_tile.stride = effective_buffer_params_.stride;
+        const int thread_index = tbb::this_task_arena::current_thread_index();
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
 
-      CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+        render_samples_wavefront(kernel_globals,
+                                 wavefront_states_[thread_index],
+                                 pixel_indices,
+                                 pixels_num,
+                                 start_sample,
+                                 samples_num,
+                                 sample_offset);
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+        thread_busy_time[thread_index] += time_dt() - batch_start_time;
+      });
     });
-  });
+  }
+  else {
+    local_arena.execute([&]() {
+      parallel_for(int64_t(0), work_pixels_num, [&](int64_t work_index) {
+        if (is_cancel_requested()) {
+          return;
+        }
+
+        const double pixel_start_time = time_dt();
+
+        const int64_t pixel_index = work_pixel_index(work_index);
+        const int y = pixel_index / image_width;
+        const int x = pixel_index - y * image_width;
+
+        KernelWorkTile work_tile;
+        work_tile.x = effective_buffer_params_.full_x + x;
+        work_tile.y = effective_buffer_params_.full_y + y;
+        work_tile.w = 1;
+        work_tile.h = 1;
+        work_tile.start_sample = start_sample;
+        work_tile.sample_offset = sample_offset;
+        work_tile.num_samples = 1;
+        work_tile.offset = effective_buffer_params_.offset;
+        work_tile.stride = effective_buffer_params_.stride;
+
+        const int thread_index = tbb::this_task_arena::current_thread_index();
+        CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
+
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+
+        thread_busy_time[thread_index] += time_dt() - pixel_start_time;
+      });
+    });
+  }
   if (device_->profiler.active()) {
     for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
       kernel_globals.stop_profiling();
     }
   }
 
-  statistics.occupancy = 1.0f;
+  /* Similar to the GPU, where it is the fraction of path states which are busy, the occupancy is
+   * the fraction of the threads' time spent rendering. It drops when there are too few active
+   * pixels left to keep all threads busy, and the scheduler then renders more samples at once. */
+  const double wall_time = (time_dt() - start_time) * thread_busy_time.size();
+  double busy_time = 0.0;
+  for (const double time : thread_busy_time) {
+    busy_time += time;
+  }
+  statistics.occupancy = (wall_time > 0.0) ? float(min(busy_time / wall_time, 1.0)) : 1.0f;
+
+  VLOG_WORK << "Rendered " << work_pixels_num << " of " << total_pixels_num
+            << " pixels, occupancy " << statistics.occupancy;
 }
 
 void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_globals,
@@ -161,6 +256,254 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobalsCPU *kernel_glo
   }
 }
 
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                                vector<IntegratorStateCPU> &states,
+                                                const int64_t *pixel_indices,
+                                                const int pixels_num,
+                                                const int start_sample,
+                                                const int samples_num,
+                                                const int sample_offset)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const bool has_shadow_catcher = device_scene_->data.integrator.has_shadow_catcher;
+
+  /* The shadow catcher split writes the new path to the state after the main one, see
+   * #integrator_state_shadow_catcher_split, so states are allocated in pairs then. */
+  const int state_stride = has_shadow_catcher ? 2 : 1;
+  if (states.size() != WAVEFRONT_BATCH_PIXELS * state_stride) {
+    states = vector<IntegratorStateCPU>(WAVEFRONT_BATCH_PIXELS * state_stride);
+  }
+
+  const int64_t image_width = effective_buffer_params_.width;
+  float *render_buffer = buffers_->buffer.data();
+
+  KernelWorkTile work_tiles[WAVEFRONT_BATCH_PIXELS];
+  bool pixel_active[WAVEFRONT_BATCH_PIXELS];
+  for (int i = 0; i < pixels_num; i++) {
+    const int64_t pixel_index = pixel_indices[i];
+    const int y = pixel_index / image_width;
+    const int x = pixel_index - y * image_width;
+
+    KernelWorkTile &work_tile = work_tiles[i];
+    work_tile.x = effective_buffer_params_.full_x + x;
+    work_tile.y = effective_buffer_params_.full_y + y;
+    work_tile.w = 1;
+    work_tile.h = 1;
+    work_tile.start_sample = start_sample;
+    work_tile.sample_offset = sample_offset;
+    work_tile.num_samples = 1;
+    work_tile.offset = effective_buffer_params_.offset;
+    work_tile.stride = effective_buffer_params_.stride;
+
+    pixel_active[i] = true;
+  }
+
+  for (int sample = 0; sample < samples_num; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    for (int i = 0; i < pixels_num; i++) {
+      IntegratorStateCPU *state = &states[i * state_stride];
+      if (has_shadow_catcher) {
+        path_state_init_queues(state + 1);
+      }
+      if (!pixel_active[i]) {
+        path_state_init_queues(state);
+        continue;
+      }
+      /* Same as the full pipeline, a pixel which doesn't need samples anymore is skipped for
+       * the remaining samples. */
+      if (has_bake) {
+        pixel_active[i] = kernels_.integrator_init_from_bake(
+            kernel_globals, state, &work_tiles[i], render_buffer);
+      }
+      else {
+        pixel_active[i] = kernels_.integrator_init_from_camera(
+            kernel_globals, state, &work_tiles[i], render_buffer);
+      }
+      ++work_tiles[i].start_sample;
+    }
+
+    /* The megakernel finishes the main path of a pixel before its shadow catcher path, keep
+     * that order so the render buffer is accumulated the same way. */
+    wavefront_integrate(kernel_globals, states.data(), pixels_num, state_stride, 0, render_buffer);
+    if (has_shadow_catcher) {
+      wavefront_integrate(
+          kernel_globals, states.data(), pixels_num, state_stride, 1, render_buffer);
+    }
+  }
+}
+
+/* Queue the megakernel would pick next for a state: its shadow path, its AO path, and then the
+ * main path. */
+enum WavefrontQueue {
+  WAVEFRONT_QUEUE_SHADOW = 0,
+  WAVEFRONT_QUEUE_AO,
+  WAVEFRONT_QUEUE_MAIN,
+  WAVEFRONT_QUEUE_NUM,
+};
+
+static bool wavefront_kernel_is_sorted(const DeviceKernel kernel)
+{
+  return kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE ||
+         kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE ||
+         kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE;
+}
+
+void PathTraceWorkCPU::wavefront_integrate(KernelGlobalsCPU *kernel_globals,
+                                           IntegratorStateCPU *states,
+                                           const int pixels_num,
+                                           const int state_stride,
+                                           const int state_offset,
+                                           float *render_buffer)
+{
+  /* Each iteration executes one kernel for every path that isn't terminated yet, in the same
+   * order as the megakernel does for a single path. Paths are grouped by kernel so each kernel
+   * runs for many paths in a row, and shading is sorted by shader. As the paths of one batch
+   * belong to different pixels the render buffer receives exactly the same writes as with the
+   * megakernel. */
+  IntegratorQueueCounter queue_counter[WAVEFRONT_QUEUE_NUM];
+  int queue_offset[WAVEFRONT_QUEUE_NUM][DEVICE_KERNEL_INTEGRATOR_NUM];
+  uint8_t path_queue[WAVEFRONT_BATCH_PIXELS];
+  uint8_t path_kernel[WAVEFRONT_BATCH_PIXELS];
+  /* Paths grouped by queue and kernel, with their shader sort key. */
+  std::pair<uint32_t, int> queued_paths[WAVEFRONT_BATCH_PIXELS];
+
+  while (true) {
+    memset(queue_counter, 0, sizeof(queue_counter));
+
+    int paths_num = 0;
+    for (int i = 0; i < pixels_num; i++) {
+      const IntegratorStateCPU *state = &states[i * state_stride + state_offset];
+      int queue = WAVEFRONT_QUEUE_SHADOW;
+      uint32_t kernel = state->shadow.shadow_path.queued_kernel;
+      if (!kernel) {
+        queue = WAVEFRONT_QUEUE_AO;
+        kernel = state->ao.shadow_path.queued_kernel;
+      }
+      if (!kernel) {
+        queue = WAVEFRONT_QUEUE_MAIN;
+        kernel = state->path.queued_kernel;
+      }
+      path_queue[i] = queue;
+      path_kernel[i] = kernel;
+      if (kernel) {
+        queue_counter[queue].num_queued[kernel]++;
+        paths_num++;
+      }
+    }
+
+    if (paths_num == 0) {
+      break;
+    }
+
+    int offset = 0;
+    for (int queue = 0; queue < WAVEFRONT_QUEUE_NUM; queue++) {
+      for (int kernel = 0; kernel < DEVICE_KERNEL_INTEGRATOR_NUM; kernel++) {
+        queue_offset[queue][kernel] = offset;
+        offset += queue_counter[queue].num_queued[kernel];
+      }
+    }
+    for (int i = 0; i < pixels_num; i++) {
+      if (path_kernel[i]) {
+        const IntegratorStateCPU *state = &states[i * state_stride + state_offset];
+        queued_paths[queue_offset[path_queue[i]][path_kernel[i]]++] = {
+            state->path.shader_sort_key, i};
+      }
+    }
+
+    offset = 0;
+    for (int queue = 0; queue < WAVEFRONT_QUEUE_NUM; queue++) {
+      for (int kernel = 0; kernel < DEVICE_KERNEL_INTEGRATOR_NUM; kernel++) {
+        const int queued_num = queue_counter[queue].num_queued[kernel];
+        if (queued_num == 0) {
+          continue;
+        }
+        std::pair<uint32_t, int> *paths = queued_paths + offset;
+        offset += queued_num;
+
+        /* The key is only written for the kernels queued with #integrator_path_next_sorted. */
+        if (queue == WAVEFRONT_QUEUE_MAIN && wavefront_kernel_is_sorted(DeviceKernel(kernel))) {
+          std::sort(paths, paths + queued_num);
+        }
+
+        for (int j = 0; j < queued_num; j++) {
+          IntegratorStateCPU *state = &states[paths[j].second * state_stride + state_offset];
+          wavefront_execute_kernel(
+              kernel_globals, state, queue, DeviceKernel(kernel), render_buffer);
+        }
+      }
+    }
+  }
+}
+
+void PathTraceWorkCPU::wavefront_execute_kernel(KernelGlobalsCPU *kernel_globals,
+                                                IntegratorStateCPU *state,
+                                                const int queue,
+                                                const DeviceKernel kernel,
+                                                float *render_buffer)
+{
+  if (queue == WAVEFRONT_QUEUE_SHADOW || queue == WAVEFRONT_QUEUE_AO) {
+    const bool is_ao = (queue == WAVEFRONT_QUEUE_AO);
+    switch (kernel) {
+      case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW:
+        if (is_ao) {
+          kernels_.integrator_intersect_shadow_ao(kernel_globals, state);
+        }
+        else {
+          kernels_.integrator_intersect_shadow(kernel_globals, state);
+        }
+        break;
+      case DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW:
+        if (is_ao) {
+          kernels_.integrator_shade_shadow_ao(kernel_globals, state, render_buffer);
+        }
+        else {
+          kernels_.integrator_shade_shadow(kernel_globals, state, render_buffer);
+        }
+        break;
+      default:
+        LOG(FATAL) << "Unhandled shadow kernel " << device_kernel_as_string(kernel);
+        break;
+    }
+    return;
+  }
+
+  switch (kernel) {
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+      kernels_.integrator_intersect_closest(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+      kernels_.integrator_shade_background(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+      kernels_.integrator_shade_surface(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+      kernels_.integrator_shade_volume(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+      kernels_.integrator_shade_surface_raytrace(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_MNEE:
+      kernels_.integrator_shade_surface_mnee(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+      kernels_.integrator_shade_light(kernel_globals, state, render_buffer);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+      kernels_.integrator_intersect_subsurface(kernel_globals, state);
+      break;
+    case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+      kernels_.integrator_intersect_volume_stack(kernel_globals, state);
+      break;
+    default:
+      LOG(FATAL) << "Unhandled kernel " << device_kernel_as_string(kernel);
+      break;
+  }
+}
+
 void PathTraceWorkCPU::copy_to_display(PathTraceDisplay *display,
                                        PassMode pass_mode,
                                        int num_samples)
@@ -201,12 +544,16 @@ bool PathTraceWorkCPU::copy_render_buffers_from_device()
 bool PathTraceWorkCPU::copy_render_buffers_to_device()
 {
   buffers_->buffer.copy_to_device();
+
+  /* The buffers might come from another device, with different pixels converged. */
+  active_pixels_.clear();
   return true;
 }
 
 bool PathTraceWorkCPU::zero_render_buffers()
 {
   buffers_->zero();
+  active_pixels_.clear();
   return true;
 }
 
@@ -259,9 +606,86 @@ int PathTraceWorkCPU::adaptive_sampling_converge_filter_count_active(float thres
     });
   }
 
+  update_active_pixels(num_active_pixels);
+
   return num_active_pixels;
 }
 
+void PathTraceWorkCPU::update_active_pixels(const int num_active_pixels)
+{
+  const int width = effective_buffer_params_.width;
+  const int height = effective_buffer_params_.height;
+
+  active_pixels_.clear();
+
+  /* Nothing to compact when no or all pixels are active. */
+  if (num_active_pixels == 0 || num_active_pixels == width * height) {
+    return;
+  }
+
+  const KernelFilm &kfilm = device_scene_->data.film;
+  if (kfilm.pass_adaptive_aux_buffer == PASS_UNUSED) {
+    return;
+  }
+
+  const int64_t pass_stride = kfilm.pass_stride;
+  const int64_t aux_w_offset = kfilm.pass_adaptive_aux_buffer + 3;
+  const float *render_buffer = buffers_->buffer.data();
+
+  /* The filters mark neighbors of active pixels as active again, so read back the result from
+   * the buffer rather than using the convergence check. Count active pixels per row first so
+   * that every row can write its pixels into its own range of the list. */
+  auto pixel_is_active = [&](const int64_t pixel_index) {
+    return render_buffer[pixel_index * pass_stride + aux_w_offset] == 0.0f;
+  };
+
+  vector<int> row_offsets(height + 1, 0);
+
+  tbb::task_arena local_arena = local_tbb_arena_create(device_);
+  local_arena.execute([&]() {
+    parallel_for(0, height, [&](int y) {
+      int num_row_pixels_active = 0;
+      for (int64_t pixel_index = int64_t(y) * width; pixel_index < int64_t(y + 1) * width;
+           ++pixel_index) {
+        num_row_pixels_active += pixel_is_active(pixel_index);
+      }
+      row_offsets[y + 1] = num_row_pixels_active;
+    });
+  });
+
+  for (int y = 0; y < height; ++y) {
+    row_offsets[y + 1] += row_offsets[y];
+  }
+
+  active_pixels_.resize(row_offsets[height]);
+  active_pixels_params_ = effective_buffer_params_;
+
+  local_arena.execute([&]() {
+    parallel_for(0, height, [&](int y) {
+      int active_index = row_offsets[y];
+      for (int64_t pixel_index = int64_t(y) * width; pixel_index < int64_t(y + 1) * width;
+           ++pixel_index) {
+        if (pixel_is_active(pixel_index)) {
+          active_pixels_[active_index++] = pixel_index;
+        }
+      }
+    });
+  });
+}
+
+bool PathTraceWorkCPU::active_pixels_valid() const
+{
+  if (active_pixels_.empty()) {
+    return false;
+  }
+
+  /* The effective buffer changes for the resolution divider and rebalancing between devices. */
+  return active_pixels_params_.full_x == effective_buffer_params_.full_x &&
+         active_pixels_params_.full_y == effective_buffer_params_.full_y &&
+         active_pixels_params_.width == effective_buffer_params_.width &&
+         active_pixels_params_.height == effective_buffer_params_.height;
+}
+
 void PathTraceWorkCPU::cryptomatte_postproces()
 {
   const int width = effective_buffer_params_.width;
@@ -73,6 +73,40 @@ class PathTraceWorkCPU : public PathTraceWork {
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Whether to use #render_samples_wavefront instead of #render_samples_full_pipeline. */
+  bool use_wavefront() const;
+
+  /* Render #samples_num samples of #pixels_num pixels of the effective buffer with the given
+   * indices, as one batch of paths. */
+  void render_samples_wavefront(KernelGlobalsCPU *kernel_globals,
+                                vector<IntegratorStateCPU> &states,
+                                const int64_t *pixel_indices,
+                                const int pixels_num,
+                                const int start_sample,
+                                const int samples_num,
+                                const int sample_offset);
+
+  /* Integrate the paths of one sample of the batch until they're all terminated. Each pixel has
+   * #state_stride states, #state_offset selects the main (0) or shadow catcher (1) one. */
+  void wavefront_integrate(KernelGlobalsCPU *kernel_globals,
+                           IntegratorStateCPU *states,
+                           const int pixels_num,
+                           const int state_stride,
+                           const int state_offset,
+                           float *render_buffer);
+
+  /* Collect the pixels which are still active after the adaptive sampling filter. */
+  void update_active_pixels(const int num_active_pixels);
+
+  /* Whether the active pixels were collected for the current effective buffer. */
+  bool active_pixels_valid() const;
+
+  void wavefront_execute_kernel(KernelGlobalsCPU *kernel_globals,
+                                IntegratorStateCPU *state,
+                                const int queue,
+                                const DeviceKernel kernel,
+                                float *render_buffer);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -82,6 +116,14 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Per-thread path states of the wavefront mode, indexed like #kernel_thread_globals_. */
+  vector<vector<IntegratorStateCPU>> wavefront_states_;
+
+  /* Indices of the pixels of the effective buffer which are not converged yet, according to the
+   * last adaptive sampling filter. Empty when all pixels are to be rendered. */
+  vector<int64_t> active_pixels_;
+  BufferParams active_pixels_params_;
 };
 
 CCL_NAMESPACE_END
@@ -9,6 +9,8 @@
 #  include <nanovdb/util/SampleFromVoxels.h>
 #endif
 
+#include "util/texture_cache.h"
+
 CCL_NAMESPACE_BEGIN
 
 /* Make template functions private so symbols don't conflict between kernels with different
@@ -824,6 +826,17 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      if (UNLIKELY(!info.data)) {
+        return zero_float4();
+      }
+      return texture_cache_lookup(*(const TextureCacheImage *)info.data,
+                                  (InterpolationType)info.interpolation,
+                                  (ExtensionType)info.extension,
+                                  x,
+                                  y,
+                                  zero_float2(),
+                                  zero_float2());
     default:
       assert(0);
       return make_float4(
@@ -831,6 +844,30 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals kg, int id, float x, flo
   }
 }
 
+/* Lookup with the derivatives of the texture coordinates, used to select the mip level of images
+ * in the texture cache. Images loaded into memory ignore them. */
+ccl_device float4 kernel_tex_image_interp_filtered(
+    KernelGlobals kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_data_fetch(texture_info, id);
+
+  if (info.data_type != IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    return kernel_tex_image_interp(kg, id, x, y);
+  }
+
+  if (UNLIKELY(!info.data)) {
+    return zero_float4();
+  }
+
+  return texture_cache_lookup(*(const TextureCacheImage *)info.data,
+                              (InterpolationType)info.interpolation,
+                              (ExtensionType)info.extension,
+                              x,
+                              y,
+                              dx,
+                              dy);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals kg,
                                              int id,
                                              float3 P,
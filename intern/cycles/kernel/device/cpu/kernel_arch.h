@@ -32,8 +32,13 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_background);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_light);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_shadow);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface_raytrace);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface_mnee);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_volume);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
+/* Same as the shadow kernels, for the AO path of the state. */
+KERNEL_INTEGRATOR_FUNCTION(intersect_shadow_ao);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_shadow_ao);
 
 #undef KERNEL_INTEGRATOR_FUNCTION
 #undef KERNEL_INTEGRATOR_INIT_FUNCTION
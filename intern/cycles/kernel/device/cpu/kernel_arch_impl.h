@@ -97,6 +97,20 @@ CCL_NAMESPACE_BEGIN
     KERNEL_INVOKE(name, kg, &state->shadow, render_buffer); \
   }
 
+#define DEFINE_INTEGRATOR_AO_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name##_ao)(const KernelGlobalsCPU *kg, \
+                                                         IntegratorStateCPU *state) \
+  { \
+    KERNEL_INVOKE(name, kg, &state->ao); \
+  }
+
+#define DEFINE_INTEGRATOR_AO_SHADE_KERNEL(name) \
+  void KERNEL_FUNCTION_FULL_NAME(integrator_##name##_ao)( \
+      const KernelGlobalsCPU *kg, IntegratorStateCPU *state, ccl_global float *render_buffer) \
+  { \
+    KERNEL_INVOKE(name, kg, &state->ao, render_buffer); \
+  }
+
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_camera)
 DEFINE_INTEGRATOR_INIT_KERNEL(init_from_bake)
 DEFINE_INTEGRATOR_SHADE_KERNEL(intersect_closest)
@@ -105,10 +119,14 @@ DEFINE_INTEGRATOR_KERNEL(intersect_volume_stack)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_background)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_light)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface)
+DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface_raytrace)
+DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface_mnee)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_volume)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 DEFINE_INTEGRATOR_SHADOW_KERNEL(intersect_shadow)
 DEFINE_INTEGRATOR_SHADOW_SHADE_KERNEL(shade_shadow)
+DEFINE_INTEGRATOR_AO_KERNEL(intersect_shadow)
+DEFINE_INTEGRATOR_AO_SHADE_KERNEL(shade_shadow)
 
 /* --------------------------------------------------------------------
  * Shader evaluation.
@@ -5,14 +5,19 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture(
+    KernelGlobals kg, int id, float x, float y, float2 dx, float2 dy, uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
+#ifdef __KERNEL_GPU__
   float4 r = kernel_tex_image_interp(kg, id, x, y);
+#else
+  float4 r = kernel_tex_image_interp_filtered(kg, id, x, y, dx, dy);
+#endif
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -27,6 +32,32 @@ ccl_device float4 svm_image_texture(KernelGlobals kg, int id, float x, float y,
   return r;
 }
 
+#ifndef __KERNEL_GPU__
+/* Derivatives of the texture coordinate for mip selection in the CPU texture cache. They are only
+ * known when the coordinate is a UV map as is, in which case the compiler passes its attribute.
+ * For anything else the lookup falls back to the full resolution. */
+ccl_device_inline void svm_image_texture_derivatives(KernelGlobals kg,
+                                                     ccl_private const ShaderData *sd,
+                                                     uint uv_attribute,
+                                                     ccl_private float2 *dx,
+                                                     ccl_private float2 *dy)
+{
+  *dx = zero_float2();
+  *dy = zero_float2();
+
+  if (uv_attribute == ATTR_STD_NONE) {
+    return;
+  }
+
+  const AttributeDescriptor desc = find_attribute(kg, sd, uv_attribute);
+  if (desc.offset == ATTR_STD_NOT_FOUND) {
+    return;
+  }
+
+  primitive_surface_attribute_float2(kg, sd, desc, dx, dy);
+}
+#endif
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -40,6 +71,9 @@ ccl_device_noinline int svm_node_tex_image(
 
   svm_unpack_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &flags);
 
+  /* Attribute of the UV map the coordinate comes from unchanged, if any. */
+  const uint uv_attribute = read_node(kg, &offset).x;
+
   float3 co = stack_load_float3(stack, co_offset);
   float2 tex_co;
   if (node.w == NODE_IMAGE_PROJ_SPHERE) {
@@ -97,7 +131,17 @@ ccl_device_noinline int svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float2 tex_dx = zero_float2(), tex_dy = zero_float2();
+#ifndef __KERNEL_GPU__
+  if (id != -1 &&
+      kernel_data_fetch(texture_info, id).data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    svm_image_texture_derivatives(kg, sd, uv_attribute, &tex_dx, &tex_dy);
+  }
+#else
+  (void)uv_attribute;
+#endif
+
+  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, tex_dx, tex_dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -191,15 +235,15 @@ ccl_device_noinline void svm_node_tex_image_box(KernelGlobals kg,
   /* Map so that no textures are flipped, rotation is somewhat arbitrary. */
   if (weight.x > 0.0f) {
     float2 uv = make_float2((signed_N.x < 0.0f) ? 1.0f - co.y : co.y, co.z);
-    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.x * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.y > 0.0f) {
     float2 uv = make_float2((signed_N.y > 0.0f) ? 1.0f - co.x : co.x, co.z);
-    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.y * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
   if (weight.z > 0.0f) {
     float2 uv = make_float2((signed_N.z > 0.0f) ? 1.0f - co.y : co.y, co.x);
-    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, flags);
+    f += weight.z * svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
   }
 
   if (stack_valid(out_offset))
@@ -229,7 +273,7 @@ ccl_device_noinline void svm_node_tex_environment(KernelGlobals kg,
   else
     uv = direction_to_mirrorball(co);
 
-  float4 f = svm_image_texture(kg, id, uv.x, uv.y, flags);
+  float4 f = svm_image_texture(kg, id, uv.x, uv.y, zero_float2(), zero_float2(), flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
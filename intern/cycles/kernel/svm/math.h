@@ -23,6 +23,43 @@ ccl_device_noinline void svm_node_math(KernelGlobals kg,
   stack_store_float(stack, result_stack_offset, result);
 }
 
+/* Consecutive math nodes evaluated in a single dispatch. Every operation is stored in one node,
+ * with constant inputs embedded in the node rather than loaded from the stack. The result of an
+ * operation is passed on in a register when the next operation reads it. */
+ccl_device_noinline int svm_node_math_chain(KernelGlobals kg,
+                                            ccl_private float *stack,
+                                            uint num_operations,
+                                            int offset)
+{
+  float result = 0.0f;
+  uint result_stack_offset = SVM_STACK_INVALID;
+
+  for (uint i = 0; i < num_operations; i++) {
+    uint4 node = read_node(kg, &offset);
+
+    uint type, constant_flags, a_stack_offset, b_stack_offset, c_stack_offset,
+        out_stack_offset;
+    svm_unpack_node_uchar2(node.x, &type, &constant_flags);
+    svm_unpack_node_uchar4(
+        node.y, &a_stack_offset, &b_stack_offset, &c_stack_offset, &out_stack_offset);
+
+    float a = (constant_flags & NODE_MATH_CHAIN_CONSTANT_A) ? __uint_as_float(node.z) :
+              (a_stack_offset == result_stack_offset)      ? result :
+                                                              stack_load_float(stack, a_stack_offset);
+    float b = (constant_flags & NODE_MATH_CHAIN_CONSTANT_B) ? __uint_as_float(node.w) :
+              (b_stack_offset == result_stack_offset)      ? result :
+                                                              stack_load_float(stack, b_stack_offset);
+    float c = stack_valid(c_stack_offset) ? stack_load_float(stack, c_stack_offset) : 0.0f;
+
+    result = svm_math((NodeMathType)type, a, b, c);
+    result_stack_offset = out_stack_offset;
+
+    stack_store_float(stack, out_stack_offset, result);
+  }
+
+  return offset;
+}
+
 ccl_device_noinline int svm_node_vector_math(KernelGlobals kg,
                                              ccl_private ShaderData *sd,
                                              ccl_private float *stack,
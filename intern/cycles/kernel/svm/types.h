@@ -183,6 +183,12 @@ typedef enum NodeMathType {
   NODE_MATH_SMOOTH_MAX,
 } NodeMathType;
 
+/* Inputs of an operation in NODE_MATH_CHAIN which are stored in the node. */
+typedef enum NodeMathChainConstant {
+  NODE_MATH_CHAIN_CONSTANT_A = (1 << 0),
+  NODE_MATH_CHAIN_CONSTANT_B = (1 << 1),
+} NodeMathChainConstant;
+
 typedef enum NodeVectorMathType {
   NODE_VECTOR_MATH_ADD,
   NODE_VECTOR_MATH_SUBTRACT,
@@ -87,7 +87,7 @@ void Background::device_update(Device *device, DeviceScene *dscene, Scene *scene
   kbackground->volume_step_size = volume_step_size * scene->integrator->get_volume_step_rate();
 
   /* No background node, make world shader invisible to all rays, to skip evaluation in kernel. */
-  if (bg_shader->graph->nodes.size() <= 1) {
+  if (!bg_shader->has_graph_nodes) {
     kbackground->surface_shader |= SHADER_EXCLUDE_ANY;
   }
   /* Background present, check visibilities */
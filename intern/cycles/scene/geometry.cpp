@@ -217,14 +217,23 @@ void Geometry::compute_bvh(Device *device,
     vector<Object *> objects;
     objects.push_back(&object);
 
+    bool refit = false;
     if (bvh && !need_update_rebuild) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->replace_geometry(geometry, objects);
 
       device->build_bvh(bvh, *progress, true);
+
+      /* Deformation can move primitives far enough that the refitted hierarchy is much slower
+       * to trace than a new one. */
+      refit = !bvh->need_rebuild_after_refit();
+      if (!refit) {
+        VLOG_INFO << "Rebuilding BVH of " << name << ", refit degraded its quality.";
+      }
     }
-    else {
+
+    if (!refit) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -237,6 +246,7 @@ void Geometry::compute_bvh(Device *device,
       bparams.num_motion_curve_steps = params->num_bvh_time_steps;
       bparams.num_motion_point_steps = params->num_bvh_time_steps;
       bparams.bvh_type = params->bvh_type;
+      bparams.use_persistent_data = params->use_persistent_data;
       bparams.curve_subdivisions = params->curve_subdivisions();
 
       delete bvh;
@@ -1246,13 +1256,19 @@ void GeometryManager::device_update_bvh(Device *device,
   bparams.num_motion_curve_steps = scene->params.num_bvh_time_steps;
   bparams.num_motion_point_steps = scene->params.num_bvh_time_steps;
   bparams.bvh_type = scene->params.bvh_type;
+  bparams.use_persistent_data = scene->params.use_persistent_data;
   bparams.curve_subdivisions = scene->params.curve_subdivisions();
 
   VLOG_INFO << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
+  /* The scene BVH only survives updates that keep the primitives the same, see
+   * device_update_preprocess(). Embree bakes instance transforms and visibility masks into the
+   * scene at build time, so it can only refit for deformation. */
+  const bool can_refit_embree = bparams.bvh_layout == BVHLayout::BVH_LAYOUT_EMBREE &&
+                                (update_flags & (TRANSFORM_MODIFIED | VISIBILITY_MODIFIED)) == 0;
   const bool can_refit = scene->bvh != nullptr &&
                          (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
-                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL);
+                          bparams.bvh_layout == BVHLayout::BVH_LAYOUT_METAL || can_refit_embree);
 
   BVH *bvh = scene->bvh;
   if (!scene->bvh) {
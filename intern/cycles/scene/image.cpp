@@ -17,6 +17,7 @@
 #include "util/progress.h"
 #include "util/task.h"
 #include "util/texture.h"
+#include "util/texture_cache.h"
 #include "util/unique_ptr.h"
 
 #ifdef WITH_OSL
@@ -68,6 +69,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_fpn";
     case IMAGE_DATA_TYPE_NANOVDB_FP16:
       return "nanovdb_fp16";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -329,6 +332,7 @@ ImageManager::ImageManager(const DeviceInfo &info)
 
   /* Set image limits */
   features.has_nanovdb = info.has_nanovdb;
+  features.has_texture_cache = (info.type == DEVICE_CPU);
 }
 
 ImageManager::~ImageManager()
@@ -686,6 +690,34 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+bool ImageManager::texture_cache_image(Image *img, Scene *scene, TextureCacheImage *cache_image)
+{
+  const int texture_cache_size = scene->params.texture_cache_size;
+  if (texture_cache_size <= 0 || !features.has_texture_cache) {
+    return false;
+  }
+
+  /* Only 2D image files that need no conversion besides what the kernel does on lookup. The
+   * texture limit stays an explicit cap on the resolution. */
+  const ustring filepath = img->loader->osl_filepath();
+  const ImageMetaData &metadata = img->metadata;
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  if (filepath.empty() || metadata.depth > 1 || scene->params.texture_limit > 0 ||
+      !(metadata.colorspace == u_colorspace_raw || metadata.colorspace == u_colorspace_srgb) ||
+      (has_alpha && !image_associate_alpha(img))) {
+    return false;
+  }
+
+  {
+    thread_scoped_lock device_lock(device_mutex);
+    if (!texture_cache) {
+      texture_cache = make_unique<TextureCache>(texture_cache_size);
+    }
+  }
+
+  return texture_cache->add_image(filepath.string(), metadata.channels, cache_image);
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -701,6 +733,11 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
+  TextureCacheImage cache_image;
+  if (texture_cache_image(img, scene, &cache_image)) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+  }
+
   /* Name for debugging. */
   img->mem_name = string_printf("tex_image_%s_%03d", name_from_type(type), slot);
 
@@ -801,6 +838,15 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
       pixels[0] = TEX_IMAGE_MISSING_R;
     }
   }
+  else if (type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    /* Pixels are paged in by the kernel on lookup. */
+    thread_scoped_lock device_lock(device_mutex);
+    void *pixels = img->mem->alloc(sizeof(TextureCacheImage), 0);
+
+    if (pixels != NULL) {
+      memcpy(pixels, &cache_image, sizeof(TextureCacheImage));
+    }
+  }
 #ifdef WITH_NANOVDB
   else if (type == IMAGE_DATA_TYPE_NANOVDB_FLOAT || type == IMAGE_DATA_TYPE_NANOVDB_FLOAT3 ||
            type == IMAGE_DATA_TYPE_NANOVDB_FPN || type == IMAGE_DATA_TYPE_NANOVDB_FP16) {
@@ -840,6 +886,10 @@ void ImageManager::device_free_image(Device *, int slot)
   }
 
   if (img->mem) {
+    if (texture_cache && img->mem->info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+      texture_cache->invalidate(img->loader->osl_filepath().string());
+    }
+
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
   }
@@ -927,6 +977,11 @@ void ImageManager::device_free(Device *device)
     device_free_image(device, slot);
   }
   images.clear();
+
+  if (texture_cache) {
+    VLOG_INFO << "Texture cache statistics:\n" << texture_cache->stats();
+    texture_cache.reset();
+  }
 }
 
 void ImageManager::collect_statistics(RenderStats *stats)
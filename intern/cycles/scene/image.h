@@ -26,6 +26,8 @@ class Progress;
 class RenderStats;
 class Scene;
 class ColorSpaceProcessor;
+class TextureCache;
+struct TextureCacheImage;
 class VDBImageLoader;
 
 /* Image Parameters */
@@ -89,6 +91,7 @@ class ImageMetaData {
 class ImageDeviceFeatures {
  public:
   bool has_nanovdb;
+  bool has_texture_cache;
 };
 
 /* Image loader base class, that can be subclassed to load image data
@@ -222,6 +225,7 @@ class ImageManager {
 
   vector<Image *> images;
   void *osl_texture_system;
+  unique_ptr<TextureCache> texture_cache;
 
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
@@ -232,6 +236,8 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  bool texture_cache_image(Image *img, Scene *scene, TextureCacheImage *cache_image);
+
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
 
@@ -24,6 +24,8 @@
 #include "util/path.h"
 #include "util/progress.h"
 #include "util/task.h"
+#include "util/tbb.h"
+#include "util/time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -470,17 +472,22 @@ void LightManager::device_update_tree(Device *,
     dscene->light_to_tree.free();
     dscene->object_lookup_offset.free();
     dscene->triangle_to_tree.free();
+
+    light_tree_.reset();
+    light_tree_prims_.clear();
+    light_tree_prim_ids_.clear();
     return;
   }
 
   /* Update light tree. */
   progress.set_status("Updating Lights", "Computing tree");
 
-  /* Add both lights and emissive triangles to this vector for light tree construction. */
-  vector<LightTreePrimitive> light_prims;
-  light_prims.reserve(kintegrator->num_distribution);
-  vector<LightTreePrimitive> distant_lights;
-  distant_lights.reserve(kintegrator->num_distant_lights);
+  /* Collect the (prim_id, object_id) pairs of both lights and emissive triangles for light tree
+   * construction, so the primitive measures can be computed in parallel afterwards. */
+  vector<int2> prim_ids;
+  prim_ids.reserve(kintegrator->num_distribution);
+  vector<int2> distant_light_ids;
+  distant_light_ids.reserve(kintegrator->num_distant_lights);
   vector<uint> object_lookup_offsets(scene->objects.size());
 
   /* When we keep track of the light index, only contributing lights will be added to the device.
@@ -491,10 +498,10 @@ void LightManager::device_update_tree(Device *,
   foreach (Light *light, scene->lights) {
     if (light->is_enabled) {
       if (light->light_type == LIGHT_BACKGROUND || light->light_type == LIGHT_DISTANT) {
-        distant_lights.emplace_back(scene, ~device_light_index, scene_light_index);
+        distant_light_ids.push_back(make_int2(~device_light_index, scene_light_index));
       }
       else {
-        light_prims.emplace_back(scene, ~device_light_index, scene_light_index);
+        prim_ids.push_back(make_int2(~device_light_index, scene_light_index));
       }
 
       device_light_index++;
@@ -528,7 +535,7 @@ void LightManager::device_update_tree(Device *,
                            scene->default_surface;
 
       if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
-        light_prims.emplace_back(scene, i, object_id);
+        prim_ids.push_back(make_int2(i, object_id));
       }
     }
 
@@ -536,15 +543,46 @@ void LightManager::device_update_tree(Device *,
     object_id++;
   }
 
-  /* Append distant lights to the end of `light_prims` */
-  std::move(distant_lights.begin(), distant_lights.end(), std::back_inserter(light_prims));
+  /* Append distant lights to the end of `prim_ids` */
+  prim_ids.insert(prim_ids.end(), distant_light_ids.begin(), distant_light_ids.end());
 
   /* Update integrator state. */
-  kintegrator->use_direct_light = !light_prims.empty();
+  kintegrator->use_direct_light = !prim_ids.empty();
+
+  /* When the same primitives emit light as in the previous update, only their measures changed,
+   * so the existing tree is refit instead of rebuilt, unless its quality degraded too much. */
+  bool need_build = true;
+  if (light_tree_ && prim_ids == light_tree_prim_ids_ &&
+      kintegrator->num_distant_lights == light_tree_num_distant_lights_)
+  {
+    scoped_timer timer;
+    parallel_for((size_t)0, light_tree_prims_.size(), [&](const size_t i) {
+      LightTreePrimitive &prim = light_tree_prims_[i];
+      prim = LightTreePrimitive(scene, prim.prim_id, prim.object_id);
+    });
+
+    need_build = !light_tree_->refit(light_tree_prims_);
+    VLOG_INFO << "Light tree " << (need_build ? "refit rejected" : "refit") << " in "
+              << timer.get_time() << " seconds.";
+  }
+
+  if (need_build) {
+    scoped_timer timer;
+    light_tree_prims_.resize(prim_ids.size());
+    parallel_for((size_t)0, prim_ids.size(), [&](const size_t i) {
+      light_tree_prims_[i] = LightTreePrimitive(scene, prim_ids[i].x, prim_ids[i].y);
+    });
+
+    /* TODO: For now, we'll start with a smaller number of max lights in a node.
+     * More benchmarking is needed to determine what number works best. */
+    light_tree_ = make_unique<LightTree>(light_tree_prims_, kintegrator->num_distant_lights, 8);
+    light_tree_prim_ids_ = std::move(prim_ids);
+    light_tree_num_distant_lights_ = kintegrator->num_distant_lights;
+    VLOG_INFO << "Light tree built in " << timer.get_time() << " seconds.";
+  }
 
-  /* TODO: For now, we'll start with a smaller number of max lights in a node.
-   * More benchmarking is needed to determine what number works best. */
-  LightTree light_tree(light_prims, kintegrator->num_distant_lights, 8);
+  const LightTree &light_tree = *light_tree_;
+  vector<LightTreePrimitive> &light_prims = light_tree_prims_;
 
   /* We want to create separate arrays corresponding to triangles and lights,
    * which will be used to index back into the light tree for PDF calculations. */
@@ -746,6 +784,9 @@ void LightManager::device_update_background(Device *device,
   Shader *shader = scene->background->get_shader(scene);
   int num_suns = 0;
   float sun_average_radiance = 0.0f;
+  /* Environment and sky textures hold resources, compiled code is never reused for a graph with
+   * them. So such graphs were finalized, graphs reusing code have none of the nodes looked for. */
+  assert(shader->graph->finalized || !shader->graph->hash_has_resources);
   foreach (ShaderNode *node, shader->graph->nodes) {
     if (node->type == EnvironmentTextureNode::get_node_type()) {
       EnvironmentTextureNode *env = (EnvironmentTextureNode *)node;
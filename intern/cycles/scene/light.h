@@ -15,12 +15,15 @@
 #include "util/ies.h"
 #include "util/thread.h"
 #include "util/types.h"
+#include "util/unique_ptr.h"
 #include "util/vector.h"
 
 CCL_NAMESPACE_BEGIN
 
 class Device;
 class DeviceScene;
+class LightTree;
+struct LightTreePrimitive;
 class Object;
 class Progress;
 class Scene;
@@ -155,6 +158,13 @@ class LightManager {
   bool last_background_enabled;
   int last_background_resolution;
 
+  /* Light tree of the previous update, with its primitives in tree order and the
+   * (prim_id, object_id) pairs it was built from in scene order, for refitting. */
+  unique_ptr<LightTree> light_tree_;
+  vector<LightTreePrimitive> light_tree_prims_;
+  vector<int2> light_tree_prim_ids_;
+  int light_tree_num_distant_lights_ = 0;
+
   uint32_t update_flags;
 };
 
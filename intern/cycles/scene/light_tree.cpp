@@ -5,6 +5,8 @@
 #include "scene/mesh.h"
 #include "scene/object.h"
 
+#include "util/tbb.h"
+
 CCL_NAMESPACE_BEGIN
 
 float OrientationBounds::calculate_measure() const
@@ -232,6 +234,163 @@ LightTree::LightTree(vector<LightTreePrimitive> &prims,
     root_->children[right]->add(prims[i]);
   }
   root_->children[right]->make_leaf(num_local_lights, num_distant_lights);
+
+  build_cost_ = calculate_cost();
+}
+
+bool LightTree::refit(const vector<LightTreePrimitive> &prims)
+{
+  if (!root_) {
+    return true;
+  }
+
+  /* The root only separates local and distant lights, its measure is not used. */
+  refit_node(root_->children[left].get(), prims);
+  refit_node(root_->children[right].get(), prims);
+
+  const float cost = calculate_cost();
+  VLOG_INFO << "Light tree refit cost " << cost << ", built cost " << build_cost_ << ".";
+
+  return cost <= build_cost_ * max_refit_cost_ratio;
+}
+
+void LightTree::refit_node(LightTreeNode *node, const vector<LightTreePrimitive> &prims)
+{
+  node->measure = LightTreePrimitivesMeasure::empty;
+
+  if (node->is_leaf()) {
+    for (int i = 0; i < node->num_prims; i++) {
+      node->add(prims[node->first_prim_index + i]);
+    }
+    return;
+  }
+
+  refit_node(node->children[left].get(), prims);
+  refit_node(node->children[right].get(), prims);
+
+  node->measure = node->children[left]->measure + node->children[right]->measure;
+}
+
+float LightTree::calculate_cost() const
+{
+  /* Sum of the SAOH of all inner nodes below the local lights node, relative to the local lights
+   * node, so that the cost does not depend on the overall scale and energy of the lights. */
+  const LightTreeNode *local_node = root_->children[left].get();
+  const float local_cost = LightTreePrimitivesMeasure(local_node->measure).calculate();
+  if (local_cost == 0.0f) {
+    return 0.0f;
+  }
+
+  float cost = 0.0f;
+  vector<const LightTreeNode *> stack = {local_node};
+  while (!stack.empty()) {
+    const LightTreeNode *node = stack.back();
+    stack.pop_back();
+
+    if (node->is_leaf()) {
+      continue;
+    }
+
+    for (int child = left; child <= right; child++) {
+      const LightTreeNode *child_node = node->children[child].get();
+      cost += LightTreePrimitivesMeasure(child_node->measure).calculate();
+      stack.push_back(child_node);
+    }
+  }
+
+  return cost / local_cost;
+}
+
+/* Bounds of the primitive centroids, computed in chunks of a fixed size so the result does not
+ * depend on the number of threads. */
+static BoundBox light_tree_centroid_bounds(const vector<LightTreePrimitive> &prims,
+                                           const int start,
+                                           const int end,
+                                           const int chunk_size)
+{
+  const int num_chunks = divide_up(end - start, chunk_size);
+  if (num_chunks <= 1) {
+    BoundBox centroid_bounds = BoundBox::empty;
+    for (int i = start; i < end; i++) {
+      centroid_bounds.grow(prims[i].centroid);
+    }
+    return centroid_bounds;
+  }
+
+  vector<BoundBox> chunk_bounds(num_chunks, BoundBox::empty);
+  parallel_for(0, num_chunks, [&](const int chunk) {
+    const int chunk_end = min(start + (chunk + 1) * chunk_size, end);
+    for (int i = start + chunk * chunk_size; i < chunk_end; i++) {
+      chunk_bounds[chunk].grow(prims[i].centroid);
+    }
+  });
+
+  BoundBox centroid_bounds = BoundBox::empty;
+  for (const BoundBox &bounds : chunk_bounds) {
+    centroid_bounds.grow(bounds);
+  }
+  return centroid_bounds;
+}
+
+/* Buckets along each of the three dimensions. */
+using LightTreeBins = std::array<std::array<LightTreeBucket, LightTreeBucket::num_buckets>, 3>;
+
+static void light_tree_fill_bins(const vector<LightTreePrimitive> &prims,
+                                 const int start,
+                                 const int end,
+                                 const BoundBox &centroid_bbox,
+                                 LightTreeBins &bins)
+{
+  const float3 extent = centroid_bbox.size();
+  const float3 inv_extent = make_float3(1.0f / extent.x, 1.0f / extent.y, 1.0f / extent.z);
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &prim = prims[i];
+
+    for (int dim = 0; dim < 3; dim++) {
+      /* Place primitive into the appropriate bucket, where the centroid box is split into equal
+       * partitions. A flat dimension is not split, use a single bucket. */
+      int bucket_idx = 0;
+      if (extent[dim] != 0.0f) {
+        bucket_idx = LightTreeBucket::num_buckets * (prim.centroid[dim] - centroid_bbox.min[dim]) *
+                     inv_extent[dim];
+        bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
+      }
+
+      bins[dim][bucket_idx].add(prim);
+    }
+  }
+}
+
+/* Fill buckets for all dimensions in one pass over the primitives. Large ranges are binned in
+ * parallel in chunks of a fixed size, merged in order so the tree is deterministic. */
+static void light_tree_bins(const vector<LightTreePrimitive> &prims,
+                            const int start,
+                            const int end,
+                            const BoundBox &centroid_bbox,
+                            const int chunk_size,
+                            LightTreeBins &bins)
+{
+  const int num_chunks = divide_up(end - start, chunk_size);
+  if (num_chunks <= 1) {
+    light_tree_fill_bins(prims, start, end, centroid_bbox, bins);
+    return;
+  }
+
+  vector<LightTreeBins> chunk_bins(num_chunks);
+  parallel_for(0, num_chunks, [&](const int chunk) {
+    const int chunk_start = start + chunk * chunk_size;
+    const int chunk_end = min(chunk_start + chunk_size, end);
+    light_tree_fill_bins(prims, chunk_start, chunk_end, centroid_bbox, chunk_bins[chunk]);
+  });
+
+  for (const LightTreeBins &other : chunk_bins) {
+    for (int dim = 0; dim < 3; dim++) {
+      for (int i = 0; i < LightTreeBucket::num_buckets; i++) {
+        bins[dim][i] = bins[dim][i] + other[dim][i];
+      }
+    }
+  }
 }
 
 void LightTree::recursive_build(const Child child,
@@ -242,10 +401,8 @@ void LightTree::recursive_build(const Child child,
                                 const uint bit_trail,
                                 const int depth)
 {
-  BoundBox centroid_bounds = BoundBox::empty;
-  for (int i = start; i < end; i++) {
-    centroid_bounds.grow((*prims)[i].centroid);
-  }
+  const BoundBox centroid_bounds = light_tree_centroid_bounds(
+      *prims, start, end, MIN_PRIMS_PER_THREAD);
 
   parent->children[child] = create_node(LightTreePrimitivesMeasure::empty, bit_trail);
   LightTreeNode *node = parent->children[child].get();
@@ -302,6 +459,10 @@ bool LightTree::should_split(const vector<LightTreePrimitive> &prims,
   const float3 extent = centroid_bbox.size();
   const float max_extent = max4(extent.x, extent.y, extent.z, 0.0f);
 
+  /* Fill in buckets with primitives. */
+  LightTreeBins bins;
+  light_tree_bins(prims, start, end, centroid_bbox, MIN_PRIMS_PER_THREAD, bins);
+
   /* Check each dimension to find the minimum splitting cost. */
   float total_cost = 0.0f;
   float min_cost = FLT_MAX;
@@ -312,20 +473,7 @@ bool LightTree::should_split(const vector<LightTreePrimitive> &prims,
     }
 
     const float inv_extent = 1 / (centroid_bbox.size()[dim]);
-
-    /* Fill in buckets with primitives. */
-    std::array<LightTreeBucket, LightTreeBucket::num_buckets> buckets;
-    for (int i = start; i < end; i++) {
-      const LightTreePrimitive &prim = prims[i];
-
-      /* Place primitive into the appropriate bucket, where the centroid box is split into equal
-       * partitions. */
-      int bucket_idx = LightTreeBucket::num_buckets *
-                       (prim.centroid[dim] - centroid_bbox.min[dim]) * inv_extent;
-      bucket_idx = clamp(bucket_idx, 0, LightTreeBucket::num_buckets - 1);
-
-      buckets[bucket_idx].add(prim);
-    }
+    const std::array<LightTreeBucket, LightTreeBucket::num_buckets> &buckets = bins[dim];
 
     /* Precompute the left bucket measure cumulatively. */
     std::array<LightTreeBucket, LightTreeBucket::num_buckets - 1> left_buckets;
@@ -122,6 +122,7 @@ struct LightTreePrimitive {
 
   LightTreePrimitivesMeasure measure;
 
+  LightTreePrimitive() = default;
   LightTreePrimitive(Scene *scene, int prim_id, int object_id);
 
   __forceinline bool is_triangle() const
@@ -194,6 +195,7 @@ class LightTree {
   unique_ptr<LightTreeNode> root_;
   std::atomic<int> num_nodes_ = 0;
   uint max_lights_in_leaf_;
+  float build_cost_ = 0.0f;
 
  public:
   /* Left or right child of an inner node. */
@@ -206,6 +208,12 @@ class LightTree {
             const int &num_distant_lights,
             uint max_lights_in_leaf);
 
+  /* Update the measures of all nodes after the measures of the primitives changed, for example
+   * because lights moved, keeping the structure of the tree. The primitives must be the same and
+   * in the same order as after construction. Returns false when the tree became too costly to
+   * sample compared to the built tree, in which case it should be built again. */
+  bool refit(const vector<LightTreePrimitive> &prims);
+
   int size() const
   {
     return num_nodes_;
@@ -230,6 +238,9 @@ class LightTree {
   /* Do not spawn a thread if less than this amount of primitives are to be processed. */
   enum { MIN_PRIMS_PER_THREAD = 4096 };
 
+  /* Refit is accepted as long as the cost of the tree did not grow more than this. */
+  static constexpr float max_refit_cost_ratio = 1.5f;
+
   void recursive_build(Child child,
                        LightTreeNode *parent,
                        int start,
@@ -238,6 +249,9 @@ class LightTree {
                        uint bit_trail,
                        int depth);
 
+  void refit_node(LightTreeNode *node, const vector<LightTreePrimitive> &prims);
+  float calculate_cost() const;
+
   bool should_split(const vector<LightTreePrimitive> &prims,
                     const int start,
                     int &middle,
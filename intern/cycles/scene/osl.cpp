@@ -1260,6 +1260,8 @@ void OSLCompiler::compile(OSLGlobals *og, Shader *shader)
 
     current_shader = shader;
 
+    shader->has_graph_nodes = shader->graph->nodes.size() > 1;
+
     shader->has_surface = false;
     shader->has_surface_transparent = false;
     shader->has_surface_raytrace = false;
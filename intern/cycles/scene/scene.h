@@ -160,8 +160,12 @@ class SceneParams {
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  /* Memory budget in MB of the CPU texture cache, zero to load images into memory. */
+  int texture_cache_size;
 
   bool background;
+  /* The scene is kept between renders, so its BVHs can be refitted. */
+  bool use_persistent_data;
 
   SceneParams()
   {
@@ -175,7 +179,9 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_cache_size = 0;
     background = true;
+    use_persistent_data = false;
   }
 
   bool modified(const SceneParams &params) const
@@ -187,7 +193,8 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size);
   }
 
   int curve_subdivisions()
@@ -101,6 +101,7 @@ Shader::Shader() : Node(get_node_type())
   has_volume_spatial_varying = false;
   has_volume_attribute_dependency = false;
   has_integrator_dependency = false;
+  has_graph_nodes = false;
   has_volume_connected = false;
   prev_volume_step_rate = 0.0f;
 
@@ -761,10 +762,11 @@ string ShaderManager::get_cryptomatte_materials(Scene *scene)
   return manifest;
 }
 
-void ShaderManager::tag_update(Scene * /*scene*/, uint32_t /*flag*/)
+void ShaderManager::tag_update(Scene * /*scene*/, uint32_t flag)
 {
-  /* update everything for now */
-  update_flags = ShaderManager::UPDATE_ALL;
+  /* All shaders are updated, the flags only tell the shader compiler which of the previously
+   * compiled shaders are still valid. */
+  update_flags |= flag;
 }
 
 bool ShaderManager::need_update() const
@@ -113,6 +113,9 @@ class Shader : public Node {
   bool has_volume_spatial_varying;
   bool has_volume_attribute_dependency;
   bool has_integrator_dependency;
+  /* The finalized graph has nodes besides the output. The graph itself is not finalized when the
+   * compiled code of an identical graph is reused, so use this instead of counting its nodes. */
+  bool has_graph_nodes;
 
   float3 emission_estimate;
   EmissionSampling emission_sampling;
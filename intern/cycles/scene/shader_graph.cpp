@@ -207,6 +207,7 @@ ShaderGraph::ShaderGraph()
 {
   finalized = false;
   simplified = false;
+  hash_has_resources = false;
   num_node_ids = 0;
   add(create_node<OutputNode>());
 }
@@ -764,6 +765,40 @@ void ShaderGraph::compute_displacement_hash()
   displacement_hash = md5.get_hex();
 }
 
+static bool shader_node_has_resources(const ShaderNode *node)
+{
+  return node->special_type == SHADER_SPECIAL_TYPE_IMAGE_SLOT ||
+         node->special_type == SHADER_SPECIAL_TYPE_OSL ||
+         node->special_type == SHADER_SPECIAL_TYPE_OUTPUT_AOV ||
+         node->type == SkyTextureNode::get_node_type() ||
+         node->type == PointDensityTextureNode::get_node_type() ||
+         node->type == IESLightNode::get_node_type();
+}
+
+void ShaderGraph::compute_hash()
+{
+  MD5Hash md5;
+  hash_has_resources = false;
+
+  foreach (ShaderNode *node, nodes) {
+    node->hash(md5);
+    foreach (ShaderInput *input, node->inputs) {
+      int link_id = (input->link) ? input->link->parent->id : 0;
+      md5.append((uint8_t *)&link_id, sizeof(link_id));
+      md5.append((input->link) ? input->link->name().c_str() : "");
+    }
+
+    if (shader_node_has_resources(node)) {
+      /* Image handles, IES slots and AOV offsets are resolved by the node itself, the compiled
+       * code of another graph can not be used. */
+      md5.append((uint8_t *)&node, sizeof(node));
+      hash_has_resources = true;
+    }
+  }
+
+  hash = md5.get_hex();
+}
+
 void ShaderGraph::clean(Scene *scene)
 {
   /* Graph simplification */
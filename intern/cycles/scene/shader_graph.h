@@ -302,6 +302,12 @@ class ShaderGraph : public NodeOwner {
   bool simplified;
   string displacement_hash;
 
+  /* Hash of all nodes, links and socket values, computed before finalization so that identical
+   * graphs can share compiled code. Graphs with nodes that hold image or IES slots hash the node
+   * addresses as well, since the slots are only kept alive by the graph itself. */
+  string hash;
+  bool hash_has_resources;
+
   ShaderGraph();
   ~ShaderGraph();
 
@@ -317,6 +323,7 @@ class ShaderGraph : public NodeOwner {
 
   void remove_proxy_nodes();
   void compute_displacement_hash();
+  void compute_hash();
   void simplify(Scene *scene);
   void finalize(Scene *scene,
                 bool do_bump = false,
@@ -351,6 +351,38 @@ void ImageTextureNode::attributes(Shader *shader, AttributeRequestSet *attribute
   ShaderNode::attributes(shader, attributes);
 }
 
+/* Attribute of the UV map that the vector input is linked to without any change in between, so
+ * the kernel can use its derivatives for mip selection in the texture cache. */
+static int image_texture_uv_attribute(SVMCompiler &compiler,
+                                      ShaderInput *vector_in,
+                                      TextureMapping &tex_mapping)
+{
+  if (vector_in->link == nullptr || !tex_mapping.skip()) {
+    return ATTR_STD_NONE;
+  }
+
+  const ShaderNode *from_node = vector_in->link->parent;
+  if (from_node->type == UVMapNode::get_node_type()) {
+    const UVMapNode *uv_node = static_cast<const UVMapNode *>(from_node);
+    if (uv_node->get_from_dupli()) {
+      return ATTR_STD_NONE;
+    }
+    return (uv_node->get_attribute().empty()) ? compiler.attribute(ATTR_STD_UV) :
+                                                compiler.attribute(uv_node->get_attribute());
+  }
+  if (from_node->type == TextureCoordinateNode::get_node_type() &&
+      vector_in->link->name() == "UV") {
+    const TextureCoordinateNode *texco_node = static_cast<const TextureCoordinateNode *>(
+        from_node);
+    if (texco_node->get_from_dupli()) {
+      return ATTR_STD_NONE;
+    }
+    return compiler.attribute(ATTR_STD_UV);
+  }
+
+  return ATTR_STD_NONE;
+}
+
 void ImageTextureNode::compile(SVMCompiler &compiler)
 {
   ShaderInput *vector_in = input("Vector");
@@ -402,6 +434,11 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              flags),
                       projection);
 
+    const int uv_attribute = (projection == NODE_IMAGE_PROJ_FLAT) ?
+                                 image_texture_uv_attribute(compiler, vector_in, tex_mapping) :
+                                 ATTR_STD_NONE;
+    compiler.add_node(uv_attribute, 0, 0, 0);
+
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
         int4 node;
@@ -6616,16 +6653,7 @@ void MathNode::compile(SVMCompiler &compiler)
   ShaderInput *value3_in = input("Value3");
   ShaderOutput *value_out = output("Value");
 
-  int value1_stack_offset = compiler.stack_assign(value1_in);
-  int value2_stack_offset = compiler.stack_assign(value2_in);
-  int value3_stack_offset = compiler.stack_assign(value3_in);
-  int value_stack_offset = compiler.stack_assign(value_out);
-
-  compiler.add_node(
-      NODE_MATH,
-      math_type,
-      compiler.encode_uchar4(value1_stack_offset, value2_stack_offset, value3_stack_offset),
-      value_stack_offset);
+  compiler.add_math_node(math_type, value1_in, value2_in, value3_in, value_out);
 }
 
 void MathNode::compile(OSLCompiler &compiler)
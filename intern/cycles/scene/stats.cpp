@@ -3,8 +3,10 @@
 
 #include "scene/stats.h"
 #include "scene/object.h"
+#include "scene/shader.h"
 #include "util/algorithm.h"
 #include "util/foreach.h"
+#include "util/function.h"
 #include "util/string.h"
 
 CCL_NAMESPACE_BEGIN
@@ -246,39 +248,91 @@ RenderStats::RenderStats()
   has_profiling = false;
 }
 
+/* Kernel events in the hierarchy they are reported in, events of a group are consecutive. */
+static const struct {
+  const char *group;
+  const char *name;
+  ProfilingEvent event;
+} kernel_events[] = {
+    {nullptr, "Ray setup", PROFILING_RAY_SETUP},
+    {nullptr, "Intersect Closest", PROFILING_INTERSECT_CLOSEST},
+    {nullptr, "Intersect Shadow", PROFILING_INTERSECT_SHADOW},
+    {nullptr, "Intersect Subsurface", PROFILING_INTERSECT_SUBSURFACE},
+    {nullptr, "Intersect Volume Stack", PROFILING_INTERSECT_VOLUME_STACK},
+
+    {"Shade Surface", "Setup", PROFILING_SHADE_SURFACE_SETUP},
+    {"Shade Surface", "Shader Evaluation", PROFILING_SHADE_SURFACE_EVAL},
+    {"Shade Surface", "Render Passes", PROFILING_SHADE_SURFACE_PASSES},
+    {"Shade Surface", "Direct Light", PROFILING_SHADE_SURFACE_DIRECT_LIGHT},
+    {"Shade Surface", "Indirect Light", PROFILING_SHADE_SURFACE_INDIRECT_LIGHT},
+    {"Shade Surface", "Ambient Occlusion", PROFILING_SHADE_SURFACE_AO},
+
+    {"Shade Volume", "Setup", PROFILING_SHADE_VOLUME_SETUP},
+    {"Shade Volume", "Integrate", PROFILING_SHADE_VOLUME_INTEGRATE},
+    {"Shade Volume", "Direct Light", PROFILING_SHADE_VOLUME_DIRECT_LIGHT},
+    {"Shade Volume", "Indirect Light", PROFILING_SHADE_VOLUME_INDIRECT_LIGHT},
+
+    {"Shade Shadow", "Setup", PROFILING_SHADE_SHADOW_SETUP},
+    {"Shade Shadow", "Surface", PROFILING_SHADE_SHADOW_SURFACE},
+    {"Shade Shadow", "Volume", PROFILING_SHADE_SHADOW_VOLUME},
+
+    {"Shade Light", "Setup", PROFILING_SHADE_LIGHT_SETUP},
+    {"Shade Light", "Shader Evaluation", PROFILING_SHADE_LIGHT_EVAL},
+};
+
+/* Build kernel statistics from the samples of every event. The optional split function can add
+ * sub-entries to the entry of an event. */
+static NamedNestedSampleStats kernel_sample_stats(
+    const string &name,
+    const function<uint64_t(ProfilingEvent)> &get_event,
+    const function<void(NamedNestedSampleStats &, ProfilingEvent)> &split_event = nullptr)
+{
+  NamedNestedSampleStats kernel(name, get_event(PROFILING_UNKNOWN));
+
+  for (const auto &kernel_event : kernel_events) {
+    NamedNestedSampleStats *parent = &kernel;
+    if (kernel_event.group) {
+      if (kernel.entries.empty() || kernel.entries.back().name != kernel_event.group) {
+        kernel.add_entry(kernel_event.group, 0);
+      }
+      parent = &kernel.entries.back();
+    }
+
+    NamedNestedSampleStats &entry = parent->add_entry(kernel_event.name,
+                                                      get_event(kernel_event.event));
+    if (split_event) {
+      split_event(entry, kernel_event.event);
+    }
+  }
+
+  return kernel;
+}
+
 void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
 {
   has_profiling = true;
 
-  kernel = NamedNestedSampleStats("Total render time", prof.get_event(PROFILING_UNKNOWN));
-  kernel.add_entry("Ray setup", prof.get_event(PROFILING_RAY_SETUP));
-  kernel.add_entry("Intersect Closest", prof.get_event(PROFILING_INTERSECT_CLOSEST));
-  kernel.add_entry("Intersect Shadow", prof.get_event(PROFILING_INTERSECT_SHADOW));
-  kernel.add_entry("Intersect Subsurface", prof.get_event(PROFILING_INTERSECT_SUBSURFACE));
-  kernel.add_entry("Intersect Volume Stack", prof.get_event(PROFILING_INTERSECT_VOLUME_STACK));
-
-  NamedNestedSampleStats &surface = kernel.add_entry("Shade Surface", 0);
-  surface.add_entry("Setup", prof.get_event(PROFILING_SHADE_SURFACE_SETUP));
-  surface.add_entry("Shader Evaluation", prof.get_event(PROFILING_SHADE_SURFACE_EVAL));
-  surface.add_entry("Render Passes", prof.get_event(PROFILING_SHADE_SURFACE_PASSES));
-  surface.add_entry("Direct Light", prof.get_event(PROFILING_SHADE_SURFACE_DIRECT_LIGHT));
-  surface.add_entry("Indirect Light", prof.get_event(PROFILING_SHADE_SURFACE_INDIRECT_LIGHT));
-  surface.add_entry("Ambient Occlusion", prof.get_event(PROFILING_SHADE_SURFACE_AO));
-
-  NamedNestedSampleStats &volume = kernel.add_entry("Shade Volume", 0);
-  volume.add_entry("Setup", prof.get_event(PROFILING_SHADE_VOLUME_SETUP));
-  volume.add_entry("Integrate", prof.get_event(PROFILING_SHADE_VOLUME_INTEGRATE));
-  volume.add_entry("Direct Light", prof.get_event(PROFILING_SHADE_VOLUME_DIRECT_LIGHT));
-  volume.add_entry("Indirect Light", prof.get_event(PROFILING_SHADE_VOLUME_INDIRECT_LIGHT));
-
-  NamedNestedSampleStats &shadow = kernel.add_entry("Shade Shadow", 0);
-  shadow.add_entry("Setup", prof.get_event(PROFILING_SHADE_SHADOW_SETUP));
-  shadow.add_entry("Surface", prof.get_event(PROFILING_SHADE_SHADOW_SURFACE));
-  shadow.add_entry("Volume", prof.get_event(PROFILING_SHADE_SHADOW_VOLUME));
-
-  NamedNestedSampleStats &light = kernel.add_entry("Shade Light", 0);
-  light.add_entry("Setup", prof.get_event(PROFILING_SHADE_LIGHT_SETUP));
-  light.add_entry("Shader Evaluation", prof.get_event(PROFILING_SHADE_LIGHT_EVAL));
+  auto get_event = [&](ProfilingEvent event) { return prof.get_event(event); };
+
+  kernel = kernel_sample_stats("Total render time", get_event);
+
+  kernel_shaders = kernel_sample_stats(
+      "Total render time", get_event, [&](NamedNestedSampleStats &entry, ProfilingEvent event) {
+        foreach (Shader *shader, scene->shaders) {
+          const uint64_t samples = prof.get_event_shader(event, shader->id);
+          if (samples != 0) {
+            entry.self_samples -= samples;
+            entry.add_entry(shader->name.string(), samples);
+          }
+        }
+      });
+
+  kernel_threads.clear();
+  for (int thread = 0; thread < prof.get_num_threads(); thread++) {
+    kernel_threads.push_back(kernel_sample_stats(
+        string_printf("Thread %d", thread),
+        [&](ProfilingEvent event) { return prof.get_thread_event(thread, event); }));
+  }
 
   shaders.entries.clear();
   foreach (Shader *shader, scene->shaders) {
@@ -297,6 +351,137 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
   }
 }
 
+/* Per-thread time and share of the top level kernel entries. */
+static string thread_report(NamedNestedSampleStats &thread, int indent_level)
+{
+  thread.update_sum();
+
+  const string indent(indent_level * kIndentNumSpaces, ' ');
+  string result = indent + string_printf(
+                                "%-32s: %.2fs", thread.name.c_str(), thread.sum_samples * 0.001);
+
+  if (thread.sum_samples != 0) {
+    foreach (const NamedNestedSampleStats &entry, thread.entries) {
+      if (entry.sum_samples != 0) {
+        result += string_printf(", %s %3.2f%%",
+                                entry.name.c_str(),
+                                100 * ((double)entry.sum_samples) / thread.sum_samples);
+      }
+    }
+  }
+
+  return result + "\n";
+}
+
+static string json_escape(const string &str)
+{
+  string result;
+  result.reserve(str.size());
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    }
+    else if ((unsigned char)c < 0x20) {
+      result += string_printf("\\u%04x", c);
+    }
+    else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+/* Append complete events of the entry and its sub-entries, laid out next to each other from the
+ * given start in descending order of time, as in a flame graph. */
+static void trace_events_append(vector<string> &events,
+                                const NamedNestedSampleStats &stats,
+                                const int tid,
+                                const uint64_t start_samples)
+{
+  if (stats.sum_samples == 0) {
+    return;
+  }
+
+  /* Samples are taken every millisecond, trace timestamps are in microseconds. */
+  events.push_back(
+      string_printf("{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                    "\"ts\": %llu, \"dur\": %llu}",
+                    json_escape(stats.name).c_str(),
+                    tid,
+                    (unsigned long long)(start_samples * 1000),
+                    (unsigned long long)(stats.sum_samples * 1000)));
+
+  uint64_t entry_start_samples = start_samples;
+  foreach (const NamedNestedSampleStats &entry, stats.entries) {
+    trace_events_append(events, entry, tid, entry_start_samples);
+    entry_start_samples += entry.sum_samples;
+  }
+}
+
+static void sort_sample_stats(NamedNestedSampleStats &stats)
+{
+  sort(stats.entries.begin(), stats.entries.end(), namedTimeSampleEntryComparator);
+  foreach (NamedNestedSampleStats &entry, stats.entries) {
+    sort_sample_stats(entry);
+  }
+}
+
+static void trace_thread_append(vector<string> &events,
+                                NamedNestedSampleStats &stats,
+                                const int tid,
+                                const string &thread_name)
+{
+  events.push_back(
+      string_printf("{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, "
+                    "\"args\": {\"name\": \"%s\"}}",
+                    tid,
+                    json_escape(thread_name).c_str()));
+
+  stats.update_sum();
+  sort_sample_stats(stats);
+
+  trace_events_append(events, stats, tid, 0);
+}
+
+static string trace_sample_count_stats(const NamedSampleCountStats &stats)
+{
+  string result;
+  foreach (NamedSampleCountStats::entry_map::const_reference entry, stats.entries) {
+    const NamedSampleCountPair &pair = entry.second;
+    if (!result.empty()) {
+      result += ",\n";
+    }
+    result += string_printf("    {\"name\": \"%s\", \"seconds\": %.3f, \"hits\": %llu}",
+                            json_escape(pair.name.string()).c_str(),
+                            pair.samples * 0.001,
+                            (unsigned long long)pair.hits);
+  }
+  return result;
+}
+
+string RenderStats::trace_report()
+{
+  vector<string> events;
+  if (has_profiling) {
+    trace_thread_append(events, kernel_shaders, 0, "All threads");
+    for (int thread = 0; thread < kernel_threads.size(); thread++) {
+      trace_thread_append(events, kernel_threads[thread], thread + 1, kernel_threads[thread].name);
+    }
+  }
+
+  string result = "{\n  \"traceEvents\": [\n";
+  for (size_t i = 0; i < events.size(); i++) {
+    result += "    " + events[i] + ((i + 1 < events.size()) ? ",\n" : "\n");
+  }
+  result += "  ],\n";
+  result += "  \"displayTimeUnit\": \"ms\",\n";
+  result += "  \"shaders\": [\n" + trace_sample_count_stats(shaders) + "\n  ],\n";
+  result += "  \"objects\": [\n" + trace_sample_count_stats(objects) + "\n  ]\n";
+  result += "}\n";
+  return result;
+}
+
 string RenderStats::full_report()
 {
   string result = "";
@@ -306,6 +491,10 @@ string RenderStats::full_report()
     result += "Kernel statistics:\n" + kernel.full_report(1);
     result += "Shader statistics:\n" + shaders.full_report(1);
     result += "Object statistics:\n" + objects.full_report(1);
+    result += "Thread statistics:\n";
+    foreach (NamedNestedSampleStats &thread, kernel_threads) {
+      result += thread_report(thread, 1);
+    }
   }
   else {
     result += "Profiling information not available (only works with CPU rendering)";
@@ -171,11 +171,19 @@ class RenderStats {
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
+  /* Return kernel sampling information as JSON in the Chrome trace event format, with the time
+   * of kernel events laid out as a flame graph for all threads together and every thread on its
+   * own. Can be viewed with chrome://tracing, Perfetto or Speedscope. */
+  string trace_report();
+
   bool has_profiling;
 
   MeshStats mesh;
   ImageStats image;
   NamedNestedSampleStats kernel;
+  /* Same as kernel, with the time of every event further split up per evaluated shader. */
+  NamedNestedSampleStats kernel_shaders;
+  vector<NamedNestedSampleStats> kernel_threads;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
 };
@@ -15,6 +15,7 @@
 
 #include "util/foreach.h"
 #include "util/log.h"
+#include "util/md5.h"
 #include "util/progress.h"
 #include "util/task.h"
 
@@ -34,6 +35,66 @@ void SVMShaderManager::reset(Scene * /*scene*/)
 {
 }
 
+void SVMShaderManager::CompiledShader::store(const Shader *shader)
+{
+  has_surface = shader->has_surface;
+  has_surface_transparent = shader->has_surface_transparent;
+  has_surface_raytrace = shader->has_surface_raytrace;
+  has_volume = shader->has_volume;
+  has_displacement = shader->has_displacement;
+  has_surface_bssrdf = shader->has_surface_bssrdf;
+  has_bump = shader->has_bump;
+  has_bssrdf_bump = shader->has_bssrdf_bump;
+  has_surface_spatial_varying = shader->has_surface_spatial_varying;
+  has_volume_spatial_varying = shader->has_volume_spatial_varying;
+  has_volume_attribute_dependency = shader->has_volume_attribute_dependency;
+  has_integrator_dependency = shader->has_integrator_dependency;
+  has_graph_nodes = shader->has_graph_nodes;
+
+  emission_estimate = shader->emission_estimate;
+  emission_sampling = shader->emission_sampling;
+  emission_is_constant = shader->emission_is_constant;
+}
+
+void SVMShaderManager::CompiledShader::restore(Shader *shader) const
+{
+  shader->has_surface = has_surface;
+  shader->has_surface_transparent = has_surface_transparent;
+  shader->has_surface_raytrace = has_surface_raytrace;
+  shader->has_volume = has_volume;
+  shader->has_displacement = has_displacement;
+  shader->has_surface_bssrdf = has_surface_bssrdf;
+  shader->has_bump = has_bump;
+  shader->has_bssrdf_bump = has_bssrdf_bump;
+  shader->has_surface_spatial_varying = has_surface_spatial_varying;
+  shader->has_volume_spatial_varying = has_volume_spatial_varying;
+  shader->has_volume_attribute_dependency = has_volume_attribute_dependency;
+  shader->has_integrator_dependency = has_integrator_dependency;
+  shader->has_graph_nodes = has_graph_nodes;
+
+  shader->emission_estimate = emission_estimate;
+  shader->emission_sampling = emission_sampling;
+  shader->emission_is_constant = emission_is_constant;
+}
+
+string SVMShaderManager::compiled_shader_key(Scene *scene, Shader *shader)
+{
+  ShaderGraph *graph = shader->graph;
+  if (graph->hash.empty()) {
+    graph->compute_hash();
+  }
+
+  /* Shader settings like the displacement method change the compiled code as well. */
+  MD5Hash md5;
+  shader->hash(md5);
+
+  const bool background = (shader == scene->background->get_shader(scene));
+  md5.append((uint8_t *)&background, sizeof(background));
+  md5.append(graph->hash);
+
+  return md5.get_hex();
+}
+
 void SVMShaderManager::device_update_shader(Scene *scene,
                                             Shader *shader,
                                             Progress *progress,
@@ -77,10 +138,44 @@ void SVMShaderManager::device_update_specific(Device *device,
   /* test if we need to update */
   device_free(device, dscene, scene);
 
-  /* Build all shaders. */
+  /* Find the shaders to compile. Shaders with identical graphs and settings are compiled only
+   * once, and shaders which did not change since the last update are not compiled again. */
+  const bool integrator_modified = (update_flags & INTEGRATOR_MODIFIED) != 0;
+  vector<string> shader_keys(num_shaders);
+  vector<int> compile_shaders;
+  set<string> compile_keys;
+
+  for (auto &it : compiled_shaders) {
+    it.second.used = false;
+  }
+
+  for (int i = 0; i < num_shaders; i++) {
+    Shader *shader = scene->shaders[i];
+    const string &key = shader_keys[i] = compiled_shader_key(scene, shader);
+
+    auto it = compiled_shaders.find(key);
+    if (it != compiled_shaders.end()) {
+      const CompiledShader &compiled = it->second;
+      /* Image slots are only valid while the graph that was compiled holds them. */
+      const bool resources_modified = shader->graph->hash_has_resources && shader->is_modified();
+      if (!resources_modified && !(integrator_modified && compiled.has_integrator_dependency)) {
+        it->second.used = true;
+        continue;
+      }
+      compiled_shaders.erase(it);
+    }
+
+    if (compile_keys.insert(key).second) {
+      compile_shaders.push_back(i);
+    }
+  }
+
+  VLOG_INFO << "Compiling " << compile_shaders.size() << " of " << num_shaders << " shaders.";
+
+  /* Build shaders. */
   TaskPool task_pool;
   vector<array<int4>> shader_svm_nodes(num_shaders);
-  for (int i = 0; i < num_shaders; i++) {
+  for (const int i : compile_shaders) {
     task_pool.push(function_bind(&SVMShaderManager::device_update_shader,
                                  this,
                                  scene,
@@ -94,12 +189,34 @@ void SVMShaderManager::device_update_specific(Device *device,
     return;
   }
 
+  for (const int i : compile_shaders) {
+    CompiledShader &compiled = compiled_shaders[shader_keys[i]];
+    compiled.svm_nodes.steal_data(shader_svm_nodes[i]);
+    compiled.store(scene->shaders[i]);
+    compiled.used = true;
+  }
+
+  /* Forget shaders which are no longer used. */
+  for (auto it = compiled_shaders.begin(); it != compiled_shaders.end();) {
+    if (it->second.used) {
+      ++it;
+    }
+    else {
+      it = compiled_shaders.erase(it);
+    }
+  }
+
+  vector<const CompiledShader *> shader_compiled(num_shaders);
+  for (int i = 0; i < num_shaders; i++) {
+    shader_compiled[i] = &compiled_shaders[shader_keys[i]];
+  }
+
   /* The global node list contains a jump table (one node per shader)
    * followed by the nodes of all shaders. */
   int svm_nodes_size = num_shaders;
   for (int i = 0; i < num_shaders; i++) {
     /* Since we're not copying the local jump node, the size ends up being one node lower. */
-    svm_nodes_size += shader_svm_nodes[i].size() - 1;
+    svm_nodes_size += shader_compiled[i]->svm_nodes.size() - 1;
   }
 
   int4 *svm_nodes = dscene->svm_nodes.alloc(svm_nodes_size);
@@ -107,7 +224,9 @@ void SVMShaderManager::device_update_specific(Device *device,
   int node_offset = num_shaders;
   for (int i = 0; i < num_shaders; i++) {
     Shader *shader = scene->shaders[i];
+    const array<int4> &compiled_svm_nodes = shader_compiled[i]->svm_nodes;
 
+    shader_compiled[i]->restore(shader);
     shader->clear_modified();
     if (shader->emission_sampling != EMISSION_SAMPLING_NONE) {
       scene->light_manager->tag_update(scene, LightManager::SHADER_COMPILED);
@@ -117,22 +236,23 @@ void SVMShaderManager::device_update_specific(Device *device,
      * Each compiled shader starts with a jump node that has offsets local
      * to the shader, so copy those and add the offset into the global node list. */
     int4 &global_jump_node = svm_nodes[shader->id];
-    int4 &local_jump_node = shader_svm_nodes[i][0];
+    const int4 &local_jump_node = compiled_svm_nodes[0];
 
     global_jump_node.x = NODE_SHADER_JUMP;
     global_jump_node.y = local_jump_node.y - 1 + node_offset;
     global_jump_node.z = local_jump_node.z - 1 + node_offset;
     global_jump_node.w = local_jump_node.w - 1 + node_offset;
 
-    node_offset += shader_svm_nodes[i].size() - 1;
+    node_offset += compiled_svm_nodes.size() - 1;
   }
 
   /* Copy the nodes of each shader into the correct location. */
   svm_nodes += num_shaders;
   for (int i = 0; i < num_shaders; i++) {
-    int shader_size = shader_svm_nodes[i].size() - 1;
+    const array<int4> &compiled_svm_nodes = shader_compiled[i]->svm_nodes;
+    int shader_size = compiled_svm_nodes.size() - 1;
 
-    memcpy(svm_nodes, &shader_svm_nodes[i][1], sizeof(int4) * shader_size);
+    memcpy(svm_nodes, &compiled_svm_nodes[1], sizeof(int4) * shader_size);
     svm_nodes += shader_size;
   }
 
@@ -168,6 +288,9 @@ SVMCompiler::SVMCompiler(Scene *scene) : scene(scene)
   background = false;
   mix_weight_offset = SVM_STACK_INVALID;
   compile_failed = false;
+  math_chain_offset = -1;
+  math_chain_end = -1;
+  num_fused_nodes = 0;
 
   /* This struct has one entry for every node, in order of ShaderNodeType definition. */
   svm_node_types_used = (std::atomic_int *)&scene->dscene.data.svm_usage;
@@ -396,6 +519,72 @@ void SVMCompiler::add_node(const float4 &f)
       __float_as_int(f.x), __float_as_int(f.y), __float_as_int(f.z), __float_as_int(f.w)));
 }
 
+static bool svm_math_uses_third_input(const NodeMathType type)
+{
+  return type == NODE_MATH_WRAP || type == NODE_MATH_COMPARE || type == NODE_MATH_MULTIPLY_ADD ||
+         type == NODE_MATH_SMOOTH_MIN || type == NODE_MATH_SMOOTH_MAX;
+}
+
+void SVMCompiler::add_math_node(NodeMathType type,
+                                ShaderInput *a_in,
+                                ShaderInput *b_in,
+                                ShaderInput *c_in,
+                                ShaderOutput *out)
+{
+  /* Unconnected first and second inputs are stored in the node, which saves a NODE_VALUE_F
+   * for each of them. The third input is only used by a few operations. */
+  uint constant_flags = 0;
+  float a = 0.0f, b = 0.0f;
+  int a_stack_offset = SVM_STACK_INVALID, b_stack_offset = SVM_STACK_INVALID;
+  int c_stack_offset = SVM_STACK_INVALID;
+
+  if (a_in->link) {
+    a_stack_offset = stack_assign(a_in);
+  }
+  else {
+    constant_flags |= NODE_MATH_CHAIN_CONSTANT_A;
+    a = a_in->parent->get_float(a_in->socket_type);
+  }
+
+  if (b_in->link) {
+    b_stack_offset = stack_assign(b_in);
+  }
+  else {
+    constant_flags |= NODE_MATH_CHAIN_CONSTANT_B;
+    b = b_in->parent->get_float(b_in->socket_type);
+  }
+
+  if (svm_math_uses_third_input(type)) {
+    c_stack_offset = stack_assign(c_in);
+  }
+
+  const int out_stack_offset = stack_assign(out);
+
+  /* Append to the preceding chain when nothing else was added after it, otherwise start a new
+   * chain. Either way the operation follows in the next node. */
+  if (math_chain_offset != -1 && math_chain_end == (int)current_svm_nodes.size()) {
+    current_svm_nodes[math_chain_offset].y++;
+    num_fused_nodes++;
+  }
+  else {
+    math_chain_offset = current_svm_nodes.size();
+    add_node(NODE_MATH_CHAIN, 1);
+  }
+
+  add_node(encode_uchar4(type, constant_flags),
+           encode_uchar4(a_stack_offset, b_stack_offset, c_stack_offset, out_stack_offset),
+           __float_as_int(a),
+           __float_as_int(b));
+
+  math_chain_end = current_svm_nodes.size();
+}
+
+void SVMCompiler::end_node_chain()
+{
+  math_chain_offset = -1;
+  math_chain_end = -1;
+}
+
 uint SVMCompiler::attribute(ustring name)
 {
   return scene->shader_manager->get_attribute_id(name);
@@ -673,6 +862,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Fill in jump instruction location to be after closure. */
         current_svm_nodes[node_jump_skip_index].y = current_svm_nodes.size() -
                                                     node_jump_skip_index - 1;
+        end_node_chain();
       }
 
       /* generate instructions for input closure 2 */
@@ -689,6 +879,7 @@ void SVMCompiler::generate_multi_closure(ShaderNode *root_node,
         /* Fill in jump instruction location to be after closure. */
         current_svm_nodes[node_jump_skip_index].y = current_svm_nodes.size() -
                                                     node_jump_skip_index - 1;
+        end_node_chain();
       }
 
       /* unassign */
@@ -758,6 +949,7 @@ void SVMCompiler::compile_type(Shader *shader, ShaderGraph *graph, ShaderType ty
   /* clear all compiler state */
   memset((void *)&active_stack, 0, sizeof(active_stack));
   current_svm_nodes.clear();
+  end_node_chain();
 
   foreach (ShaderNode *node, graph->nodes) {
     foreach (ShaderInput *input, node->inputs)
@@ -870,6 +1062,8 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
 
   current_shader = shader;
 
+  shader->has_graph_nodes = shader->graph->nodes.size() > 1;
+
   shader->has_surface = false;
   shader->has_surface_transparent = false;
   shader->has_surface_raytrace = false;
@@ -923,6 +1117,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
   if (summary != NULL) {
     summary->time_total = time_dt() - time_start;
     summary->peak_stack_usage = max_stack_use;
+    summary->num_fused_nodes = num_fused_nodes;
     summary->num_svm_nodes = svm_nodes.size() - start_num_svm_nodes;
   }
 
@@ -935,6 +1130,7 @@ void SVMCompiler::compile(Shader *shader, array<int4> &svm_nodes, int index, Sum
 SVMCompiler::Summary::Summary()
     : num_svm_nodes(0),
       peak_stack_usage(0),
+      num_fused_nodes(0),
       time_finalize(0.0),
       time_generate_surface(0.0),
       time_generate_bump(0.0),
@@ -949,6 +1145,7 @@ string SVMCompiler::Summary::full_report() const
   string report = "";
   report += string_printf("Number of SVM nodes: %d\n", num_svm_nodes);
   report += string_printf("Peak stack usage:    %d\n", peak_stack_usage);
+  report += string_printf("Fused nodes:         %d\n", num_fused_nodes);
 
   report += string_printf("Time (in seconds):\n");
   report += string_printf("Finalize:            %f\n", time_finalize);
@@ -9,6 +9,7 @@
 #include "scene/shader_graph.h"
 
 #include "util/array.h"
+#include "util/map.h"
 #include "util/set.h"
 #include "util/string.h"
 #include "util/thread.h"
@@ -40,10 +41,45 @@ class SVMShaderManager : public ShaderManager {
   void device_free(Device *device, DeviceScene *dscene, Scene *scene) override;
 
  protected:
+  /* Compiled code of a shader along with the shader information determined while compiling,
+   * reused for shaders with identical graphs and for shaders unchanged since the last update. */
+  struct CompiledShader {
+    array<int4> svm_nodes;
+
+    bool has_surface;
+    bool has_surface_transparent;
+    bool has_surface_raytrace;
+    bool has_volume;
+    bool has_displacement;
+    bool has_surface_bssrdf;
+    bool has_bump;
+    bool has_bssrdf_bump;
+    bool has_surface_spatial_varying;
+    bool has_volume_spatial_varying;
+    bool has_volume_attribute_dependency;
+    bool has_integrator_dependency;
+    bool has_graph_nodes;
+
+    float3 emission_estimate;
+    EmissionSampling emission_sampling;
+    bool emission_is_constant;
+
+    /* Used by a shader in the last update. */
+    bool used;
+
+    void store(const Shader *shader);
+    void restore(Shader *shader) const;
+  };
+
+  string compiled_shader_key(Scene *scene, Shader *shader);
+
   void device_update_shader(Scene *scene,
                             Shader *shader,
                             Progress *progress,
                             array<int4> *svm_nodes);
+
+  /* Compiled shaders by hash of the shader settings and graph. */
+  unordered_map<string, CompiledShader> compiled_shaders;
 };
 
 /* Graph Compiler */
@@ -59,6 +95,9 @@ class SVMCompiler {
     /* Peak stack usage during shader evaluation. */
     int peak_stack_usage;
 
+    /* Number of nodes evaluated as part of a preceding node instead of being dispatched. */
+    int num_fused_nodes;
+
     /* Time spent on surface graph finalization. */
     double time_finalize;
 
@@ -97,6 +136,11 @@ class SVMCompiler {
   void add_node(int a = 0, int b = 0, int c = 0, int d = 0);
   void add_node(ShaderNodeType type, const float3 &f);
   void add_node(const float4 &f);
+  void add_math_node(NodeMathType type,
+                     ShaderInput *a_in,
+                     ShaderInput *b_in,
+                     ShaderInput *c_in,
+                     ShaderOutput *out);
   uint attribute(ustring name);
   uint attribute(AttributeStandard std);
   uint attribute_standard(ustring name);
@@ -208,6 +252,10 @@ class SVMCompiler {
   /* multi closure */
   void generate_multi_closure(ShaderNode *root_node, ShaderNode *node, CompilerState *state);
 
+  /* Stop appending nodes to the current node chain, for example when the next node is a jump
+   * target. */
+  void end_node_chain();
+
   /* compile */
   void compile_type(Shader *shader, ShaderGraph *graph, ShaderType type);
 
@@ -219,6 +267,12 @@ class SVMCompiler {
   int max_stack_use;
   uint mix_weight_offset;
   bool compile_failed;
+
+  /* Offset of the last NODE_MATH_CHAIN in current_svm_nodes, and the size of current_svm_nodes
+   * after its last operation. Math nodes added right after are appended to the chain. */
+  int math_chain_offset;
+  int math_chain_end;
+  int num_fused_nodes;
 };
 
 CCL_NAMESPACE_END
@@ -669,7 +669,13 @@ bool Session::update_scene(int width, int height)
   Camera *cam = scene->camera;
   cam->set_screen_size(width, height);
 
-  return scene->update(progress);
+  scoped_timer update_timer;
+  if (!scene->update(progress)) {
+    return false;
+  }
+
+  progress.add_update_time(update_timer.get_time());
+  return true;
 }
 
 static string status_append(const string &status, const string &suffix)
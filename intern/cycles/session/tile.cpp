@@ -31,6 +31,8 @@ static const char *ATTR_PASSES_COUNT = "cycles.passes.count";
 static const char *ATTR_PASS_SOCKET_PREFIX_FORMAT = "cycles.passes.%d.";
 static const char *ATTR_BUFFER_SOCKET_PREFIX = "cycles.buffer.";
 static const char *ATTR_DENOISE_SOCKET_PREFIX = "cycles.denoise.";
+static const char *ATTR_TILE_WIDTH = "cycles.tile.width";
+static const char *ATTR_TILE_HEIGHT = "cycles.tile.height";
 
 /* Global counter of ToleManager object instances. */
 static std::atomic<uint64_t> g_instance_index = 0;
@@ -368,6 +370,9 @@ void TileManager::update(const BufferParams &params, const Scene *scene)
     node_to_image_spec_atttributes(
         &write_state_.image_spec, &denoise_params, ATTR_DENOISE_SOCKET_PREFIX);
 
+    write_state_.image_spec.attribute(ATTR_TILE_WIDTH, tile_size_.x);
+    write_state_.image_spec.attribute(ATTR_TILE_HEIGHT, tile_size_.y);
+
     /* Not adaptive sampling overscan yet for baking, would need overscan also
      * for buffers read from the output driver. */
     if (adaptive_sampling.use && !scene->bake_manager->get_baking()) {
@@ -624,10 +629,13 @@ void TileManager::finish_write_tiles()
   write_state_.filename = "";
 }
 
-bool TileManager::read_full_buffer_from_disk(const string_view filename,
-                                             RenderBuffers *buffers,
-                                             DenoiseParams *denoise_params)
+bool TileManager::open_full_buffer_from_disk(const string_view filename,
+                                             BufferParams *buffer_params,
+                                             DenoiseParams *denoise_params,
+                                             int2 *tile_size)
 {
+  close_full_buffer_from_disk();
+
   unique_ptr<ImageInput> in(ImageInput::open(filename));
   if (!in) {
     LOG(ERROR) << "Error opening tile file " << filename;
@@ -636,28 +644,100 @@ bool TileManager::read_full_buffer_from_disk(const string_view filename,
 
   const ImageSpec &image_spec = in->spec();
 
-  BufferParams buffer_params;
-  if (!buffer_params_from_image_spec_atttributes(&buffer_params, image_spec)) {
+  if (!buffer_params_from_image_spec_atttributes(buffer_params, image_spec)) {
     return false;
   }
-  buffers->reset(buffer_params);
+  buffer_params->update_offset_stride();
 
   if (!node_from_image_spec_atttributes(denoise_params, image_spec, ATTR_DENOISE_SOCKET_PREFIX)) {
     return false;
   }
 
-  const int num_channels = in->spec().nchannels;
-  if (!in->read_image(0, 0, 0, num_channels, TypeDesc::FLOAT, buffers->buffer.data())) {
-    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
+  *tile_size = make_int2(image_spec.get_int_attribute(ATTR_TILE_WIDTH, 0),
+                         image_spec.get_int_attribute(ATTR_TILE_HEIGHT, 0));
+
+  read_state_.tile_in = std::move(in);
+  read_state_.buffer_params = *buffer_params;
+
+  return true;
+}
+
+bool TileManager::read_full_buffer_region_from_disk(const int x,
+                                                    const int y,
+                                                    const int width,
+                                                    const int height,
+                                                    const int overscan,
+                                                    RenderBuffers *buffers)
+{
+  ImageInput *in = read_state_.tile_in.get();
+  if (!in) {
+    LOG(ERROR) << "Tile file is not open for reading.";
     return false;
   }
 
-  if (!in->close()) {
-    LOG(ERROR) << "Error closing tile file " << in->geterror();
+  const ImageSpec &image_spec = in->spec();
+  const BufferParams &full_params = read_state_.buffer_params;
+
+  /* Tiles can only be read from the file as a whole, so align the region to them. */
+  const int image_tile_width = max(image_spec.tile_width, 1);
+  const int image_tile_height = max(image_spec.tile_height, 1);
+
+  const int region_x = max(x - overscan, 0) / image_tile_width * image_tile_width;
+  const int region_y = max(y - overscan, 0) / image_tile_height * image_tile_height;
+  const int region_end_x = min(int(align_up(x + width + overscan, image_tile_width)),
+                               full_params.width);
+  const int region_end_y = min(int(align_up(y + height + overscan, image_tile_height)),
+                               full_params.height);
+
+  BufferParams buffer_params = full_params;
+  buffer_params.width = region_end_x - region_x;
+  buffer_params.height = region_end_y - region_y;
+  buffer_params.window_x = x - region_x;
+  buffer_params.window_y = y - region_y;
+  buffer_params.window_width = width;
+  buffer_params.window_height = height;
+  buffer_params.full_x = full_params.full_x + region_x;
+  buffer_params.full_y = full_params.full_y + region_y;
+  buffer_params.update_offset_stride();
+
+  buffers->reset(buffer_params);
+
+  const double time_start = time_dt();
+
+  if (!in->read_tiles(0,
+                      0,
+                      region_x,
+                      region_end_x,
+                      region_y,
+                      region_end_y,
+                      0,
+                      1,
+                      0,
+                      image_spec.nchannels,
+                      TypeDesc::FLOAT,
+                      buffers->buffer.data())) {
+    LOG(ERROR) << "Error reading pixels from the tile file " << in->geterror();
     return false;
   }
 
+  VLOG_WORK << "Read region at " << region_x << ", " << region_y << " of size "
+            << buffer_params.width << "x" << buffer_params.height << " in "
+            << time_dt() - time_start << " seconds.";
+
   return true;
 }
 
+void TileManager::close_full_buffer_from_disk()
+{
+  if (!read_state_.tile_in) {
+    return;
+  }
+
+  if (!read_state_.tile_in->close()) {
+    LOG(ERROR) << "Error closing tile file " << read_state_.tile_in->geterror();
+  }
+
+  read_state_.tile_in = nullptr;
+}
+
 CCL_NAMESPACE_END
@@ -98,18 +98,39 @@ class TileManager {
     return write_state_.num_tiles_written != 0;
   }
 
-  /* Read full frame render buffer from tiles file on disk.
+  /* Open tiles file on disk for reading the full frame render buffer from it region by region,
+   * so that the full frame does not need to fit into memory.
+   *
+   * The buffer and denoise parameters of the full frame are read from the file, as well as the
+   * size of the tiles it was rendered with. The tile size is zero for files which do not store it.
+   *
+   * Returns true on success. */
+  bool open_full_buffer_from_disk(string_view filename,
+                                  BufferParams *buffer_params,
+                                  DenoiseParams *denoise_params,
+                                  int2 *tile_size);
+
+  /* Read a region of the full frame render buffer from the file opened by
+   * open_full_buffer_from_disk().
+   *
+   * The buffers are extended by the overscan on every side, clamped to the frame and aligned to
+   * the tiles in the file (IMAGE_TILE_SIZE, unless the render tiles are smaller). The window of
+   * the buffers corresponds to the requested region.
    *
    * Returns true on success. */
-  bool read_full_buffer_from_disk(string_view filename,
-                                  RenderBuffers *buffers,
-                                  DenoiseParams *denoise_params);
+  bool read_full_buffer_region_from_disk(
+      int x, int y, int width, int height, int overscan, RenderBuffers *buffers);
+
+  void close_full_buffer_from_disk();
 
   /* Compute valid tile size compatible with image saving. */
   int compute_render_tile_size(const int suggested_tile_size) const;
 
-  /* Tile size in the image file. */
-  static const int IMAGE_TILE_SIZE = 128;
+  /* Tile size in the image file.
+   * Tiles can only be read from the file as a whole, so this is kept equal to the
+   * DENOISE_TILE_OVERSCAN: reading a render tile with its overscan then only reads the overscan
+   * strips of the neighbor tiles instead of whole image tiles around it. */
+  static const int IMAGE_TILE_SIZE = 64;
 
   /* Maximum supported tile size.
    * Needs to be safe from allocation on a GPU point of view: the display driver needs to be able
@@ -117,6 +138,10 @@ class TileManager {
    * Use conservative value which is safe for most of OpenGL drivers and GPUs. */
   static const int MAX_TILE_SIZE = 8192;
 
+  /* Number of pixels around a tile which are denoised together with it when the full frame
+   * buffer is processed tile by tile, giving the denoiser enough context to avoid seams. */
+  static const int DENOISE_TILE_OVERSCAN = 64;
+
  protected:
   /* Get tile configuration for its index.
    * The tile index must be within [0, state_.tile_state_). */
@@ -174,6 +199,15 @@ class TileManager {
 
     int num_tiles_written = 0;
   } write_state_;
+
+  /* State of reading the full frame render buffer from a tiles file on disk. */
+  struct {
+    /* Input handle for the tile file, open until all regions of interest have been read. */
+    unique_ptr<ImageInput> tile_in;
+
+    /* Parameters of the full frame render buffer stored in the file. */
+    BufferParams buffer_params;
+  } read_state_;
 };
 
 CCL_NAMESPACE_END
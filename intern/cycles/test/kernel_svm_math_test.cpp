@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "kernel/device/cpu/compat.h"
+#include "kernel/device/cpu/globals.h"
+#include "kernel/device/cpu/image.h"
+
+#include "kernel/integrator/state.h"
+#include "kernel/integrator/path_state.h"
+#include "kernel/integrator/state_util.h"
+
+#include "kernel/svm/svm.h"
+
+#include "util/vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Stack offsets of the inputs and outputs, as the compiler would assign them. */
+enum { STACK_A = 0, STACK_B = 1, STACK_C = 2, STACK_RESULT = 3, STACK_CHAIN = 4 };
+
+static const float math_inputs[] = {-2.5f, -1.0f, -0.3f, 0.0f, 0.4f, 1.0f, 3.7f};
+
+static uint encode_uchar4(uint x, uint y = 0, uint z = 0, uint w = 0)
+{
+  return x | (y << 8) | (z << 16) | (w << 24);
+}
+
+static bool floats_equal(const float a, const float b)
+{
+  return (isnan_safe(a) && isnan_safe(b)) || __float_as_uint(a) == __float_as_uint(b);
+}
+
+/* Node list of a NODE_MATH_CHAIN, encoded the same way as #SVMCompiler::add_math_node. */
+class MathChain {
+ public:
+  void add(const NodeMathType type,
+           const uint a_offset,
+           const uint b_offset,
+           const uint c_offset,
+           const uint out_offset,
+           const float a = 0.0f,
+           const float b = 0.0f)
+  {
+    const uint constant_flags = (a_offset == SVM_STACK_INVALID ? NODE_MATH_CHAIN_CONSTANT_A : 0) |
+                                (b_offset == SVM_STACK_INVALID ? NODE_MATH_CHAIN_CONSTANT_B : 0);
+    nodes.push_back(make_uint4(encode_uchar4(type, constant_flags),
+                               encode_uchar4(a_offset, b_offset, c_offset, out_offset),
+                               __float_as_uint(a),
+                               __float_as_uint(b)));
+  }
+
+  /* Evaluate all operations, returns the offset after the last node. */
+  int eval(float *stack) const
+  {
+    KernelGlobalsCPU kg = {};
+    kg.svm_nodes.data = const_cast<uint4 *>(nodes.data());
+    kg.svm_nodes.width = nodes.size();
+    return svm_node_math_chain(&kg, stack, nodes.size(), 0);
+  }
+
+  vector<uint4> nodes;
+};
+
+/* Evaluate one operation the way it was done before fusing: constant inputs are stored on the
+ * stack by NODE_VALUE_F, and NODE_MATH loads all three inputs. */
+static float eval_unfused(const NodeMathType type, const float a, const float b, const float c)
+{
+  float stack[SVM_STACK_SIZE] = {};
+  stack[STACK_A] = a;
+  stack[STACK_B] = b;
+  stack[STACK_C] = c;
+  svm_node_math(nullptr,
+                nullptr,
+                stack,
+                type,
+                encode_uchar4(STACK_A, STACK_B, STACK_C),
+                STACK_RESULT);
+  return stack[STACK_RESULT];
+}
+
+/* Every math operation, with every combination of constant and linked first two inputs, with and
+ * without a third input, gives exactly the same result as the unfused NODE_MATH. */
+TEST(kernel_svm_math, chain_matches_math_node)
+{
+  for (int type = NODE_MATH_ADD; type <= NODE_MATH_SMOOTH_MAX; type++) {
+    for (const float a : math_inputs) {
+      for (const float b : math_inputs) {
+        for (const float c : math_inputs) {
+          for (int variant = 0; variant < 8; variant++) {
+            const bool constant_a = variant & 1;
+            const bool constant_b = variant & 2;
+            const bool has_c = variant & 4;
+
+            MathChain chain;
+            chain.add(NodeMathType(type),
+                      constant_a ? SVM_STACK_INVALID : STACK_A,
+                      constant_b ? SVM_STACK_INVALID : STACK_B,
+                      has_c ? STACK_C : SVM_STACK_INVALID,
+                      STACK_RESULT,
+                      constant_a ? a : 0.0f,
+                      constant_b ? b : 0.0f);
+
+            /* Constant inputs must not be read from the stack. */
+            float stack[SVM_STACK_SIZE] = {};
+            stack[STACK_A] = constant_a ? 100.0f : a;
+            stack[STACK_B] = constant_b ? 100.0f : b;
+            stack[STACK_C] = c;
+            EXPECT_EQ(chain.eval(stack), 1);
+
+            /* Without a third input the chain uses zero, like an unconnected default value. */
+            const float expected = eval_unfused(NodeMathType(type), a, b, has_c ? c : 0.0f);
+            EXPECT_PRED2(floats_equal, stack[STACK_RESULT], expected)
+                << "type " << type << ", a " << a << ", b " << b << ", c " << c << ", variant "
+                << variant;
+          }
+        }
+      }
+    }
+  }
+}
+
+/* Operations reading the result of the previous one get it passed on directly, which must give
+ * the same result as loading it from the stack. Also when the result is used as both inputs, or
+ * only as the second input. */
+TEST(kernel_svm_math, chain_passes_results)
+{
+  for (int type = NODE_MATH_ADD; type <= NODE_MATH_SMOOTH_MAX; type++) {
+    for (const float a : math_inputs) {
+      for (const float b : math_inputs) {
+        MathChain chain;
+        chain.add(NODE_MATH_MULTIPLY,
+                  STACK_A,
+                  SVM_STACK_INVALID,
+                  SVM_STACK_INVALID,
+                  STACK_CHAIN,
+                  0.0f,
+                  0.5f);
+        chain.add(NodeMathType(type), STACK_CHAIN, STACK_B, STACK_C, STACK_CHAIN + 1);
+        chain.add(NodeMathType(type), STACK_A, STACK_CHAIN + 1, STACK_C, STACK_CHAIN + 2);
+        chain.add(NodeMathType(type), STACK_CHAIN + 2, STACK_CHAIN + 2, STACK_C, STACK_RESULT);
+
+        float stack[SVM_STACK_SIZE] = {};
+        stack[STACK_A] = a;
+        stack[STACK_B] = b;
+        stack[STACK_C] = 0.25f;
+        EXPECT_EQ(chain.eval(stack), 4);
+
+        const float first = eval_unfused(NODE_MATH_MULTIPLY, a, 0.5f, 0.0f);
+        const float second = eval_unfused(NodeMathType(type), first, b, 0.25f);
+        const float third = eval_unfused(NodeMathType(type), a, second, 0.25f);
+        const float fourth = eval_unfused(NodeMathType(type), third, third, 0.25f);
+        EXPECT_PRED2(floats_equal, stack[STACK_CHAIN], first);
+        EXPECT_PRED2(floats_equal, stack[STACK_CHAIN + 1], second);
+        EXPECT_PRED2(floats_equal, stack[STACK_CHAIN + 2], third);
+        EXPECT_PRED2(floats_equal, stack[STACK_RESULT], fourth)
+            << "type " << type << ", a " << a << ", b " << b;
+      }
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,109 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "scene/light_tree.h"
+
+#include "util/hash.h"
+#include "util/task.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Enough lights for the binning to be split into chunks that are processed in parallel. */
+static const int num_lights = 20000;
+
+/* Point lights scattered in a box, with random strengths. */
+static vector<LightTreePrimitive> make_point_lights(const uint seed)
+{
+  vector<LightTreePrimitive> prims(num_lights);
+  for (int i = 0; i < num_lights; i++) {
+    const float3 co = make_float3(hash_uint3_to_float(i, seed, 0),
+                                  hash_uint3_to_float(i, seed, 1),
+                                  hash_uint3_to_float(i, seed, 2)) *
+                      100.0f;
+    LightTreePrimitive &prim = prims[i];
+    prim.prim_id = ~i;
+    prim.object_id = i;
+    prim.centroid = co;
+    prim.measure.bbox = BoundBox(co - make_float3(0.1f), co + make_float3(0.1f));
+    prim.measure.bcone = OrientationBounds(make_float3(0.0f, 0.0f, 1.0f), M_PI_F, M_PI_2_F);
+    prim.measure.energy = 0.5f + hash_uint3_to_float(i, seed, 3);
+  }
+  return prims;
+}
+
+static void expect_nodes_equal(const LightTreeNode *a, const LightTreeNode *b)
+{
+  ASSERT_EQ(a->num_prims, b->num_prims);
+  EXPECT_EQ(a->bit_trail, b->bit_trail);
+  EXPECT_EQ(a->measure.energy, b->measure.energy);
+  EXPECT_EQ(a->measure.bbox.min, b->measure.bbox.min);
+  EXPECT_EQ(a->measure.bbox.max, b->measure.bbox.max);
+  if (a->is_leaf()) {
+    EXPECT_EQ(a->first_prim_index, b->first_prim_index);
+    return;
+  }
+  expect_nodes_equal(a->children[LightTree::left].get(), b->children[LightTree::left].get());
+  expect_nodes_equal(a->children[LightTree::right].get(), b->children[LightTree::right].get());
+}
+
+TEST(render_light_tree, build_does_not_depend_on_thread_count)
+{
+  vector<LightTreePrimitive> prims_single = make_point_lights(0);
+  vector<LightTreePrimitive> prims_multi = prims_single;
+
+  TaskScheduler::init(1);
+  LightTree tree_single(prims_single, 0, 8);
+  TaskScheduler::exit();
+
+  TaskScheduler::init(0);
+  LightTree tree_multi(prims_multi, 0, 8);
+  TaskScheduler::exit();
+
+  EXPECT_EQ(tree_single.size(), tree_multi.size());
+  for (int i = 0; i < num_lights; i++) {
+    EXPECT_EQ(prims_single[i].prim_id, prims_multi[i].prim_id);
+  }
+  expect_nodes_equal(tree_single.get_root(), tree_multi.get_root());
+}
+
+TEST(render_light_tree, refit)
+{
+  TaskScheduler::init(0);
+
+  vector<LightTreePrimitive> prims = make_point_lights(0);
+  LightTree tree(prims, 0, 8);
+
+  /* Moving all lights by the same offset keeps the tree as good as it was. */
+  const float3 offset = make_float3(10.0f, -5.0f, 2.0f);
+  vector<LightTreePrimitive> moved = prims;
+  for (LightTreePrimitive &prim : moved) {
+    prim.centroid += offset;
+    prim.measure.bbox = BoundBox(prim.measure.bbox.min + offset, prim.measure.bbox.max + offset);
+  }
+  EXPECT_TRUE(tree.refit(moved));
+
+  /* The node measures follow the moved lights. */
+  const LightTreeNode *local = tree.get_root()->children[LightTree::left].get();
+  BoundBox expected_bbox = BoundBox::empty;
+  for (const LightTreePrimitive &prim : moved) {
+    expected_bbox.grow(prim.measure.bbox);
+  }
+  EXPECT_NEAR(local->measure.bbox.min.x, expected_bbox.min.x, 1e-4f);
+  EXPECT_NEAR(local->measure.bbox.max.x, expected_bbox.max.x, 1e-4f);
+  EXPECT_NEAR(local->measure.bbox.min.y, expected_bbox.min.y, 1e-4f);
+  EXPECT_NEAR(local->measure.bbox.max.y, expected_bbox.max.y, 1e-4f);
+
+  /* Scattering the lights to unrelated positions makes the tree much worse than a new build. */
+  vector<LightTreePrimitive> scattered = make_point_lights(1);
+  for (int i = 0; i < num_lights; i++) {
+    scattered[i].prim_id = prims[i].prim_id;
+    scattered[i].object_id = prims[i].object_id;
+  }
+  EXPECT_FALSE(tree.refit(scattered));
+
+  TaskScheduler::exit();
+}
+
+CCL_NAMESPACE_END
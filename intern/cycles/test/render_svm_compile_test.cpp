@@ -0,0 +1,151 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "scene/colorspace.h"
+#include "scene/scene.h"
+#include "scene/shader.h"
+#include "scene/shader_graph.h"
+#include "scene/shader_nodes.h"
+#include "scene/svm.h"
+
+#include "util/array.h"
+#include "util/stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+class RenderSVMCompile : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+
+  virtual void SetUp()
+  {
+    ColorSpaceManager::init_fallback_config();
+
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+
+  /* Compile the graph as surface shader of a new shader. */
+  void compile(ShaderGraph *graph, array<int4> &svm_nodes, SVMCompiler::Summary &summary)
+  {
+    Shader *shader = scene->create_node<Shader>();
+    shader->set_graph(graph);
+    shader->reference();
+
+    SVMCompiler compiler(scene);
+    compiler.compile(shader, svm_nodes, 0, &summary);
+  }
+
+  /* Append a math node with a constant second input. */
+  static MathNode *add_math(ShaderGraph *graph,
+                            ShaderOutput *from,
+                            const NodeMathType type,
+                            const float value)
+  {
+    MathNode *math = graph->create_node<MathNode>();
+    math->set_math_type(type);
+    math->set_value2(value);
+    graph->add(math);
+    graph->connect(from, math->input("Value1"));
+    return math;
+  }
+
+  static int count_nodes(const array<int4> &svm_nodes, const ShaderNodeType type)
+  {
+    int count = 0;
+    for (size_t i = 0; i < svm_nodes.size(); i++) {
+      if (svm_nodes[i].x == type) {
+        count++;
+      }
+    }
+    return count;
+  }
+};
+
+/*
+ * Tests:
+ *  - A cascade of math nodes is evaluated with a single dispatch.
+ *  - Constant inputs are stored in the operations instead of loaded with NODE_VALUE_F.
+ */
+TEST_F(RenderSVMCompile, math_chain)
+{
+  ShaderGraph *graph = new ShaderGraph();
+
+  AttributeNode *attribute = graph->create_node<AttributeNode>();
+  attribute->set_attribute(ustring("weight"));
+  graph->add(attribute);
+
+  /* Typical remapping of a texture or attribute value, as found in production materials. */
+  MathNode *scale = add_math(graph, attribute->output("Fac"), NODE_MATH_MULTIPLY, 2.0f);
+  MathNode *offset = add_math(graph, scale->output("Value"), NODE_MATH_ADD, 0.5f);
+  MathNode *gamma = add_math(graph, offset->output("Value"), NODE_MATH_POWER, 2.2f);
+  MathNode *limit = add_math(graph, gamma->output("Value"), NODE_MATH_MINIMUM, 1.0f);
+
+  EmissionNode *emission = graph->create_node<EmissionNode>();
+  graph->add(emission);
+  graph->connect(limit->output("Value"), emission->input("Strength"));
+  graph->connect(emission->output("Emission"), graph->output()->input("Surface"));
+
+  array<int4> svm_nodes;
+  SVMCompiler::Summary summary;
+  compile(graph, svm_nodes, summary);
+
+  EXPECT_EQ(summary.num_fused_nodes, 3);
+  EXPECT_EQ(count_nodes(svm_nodes, NODE_MATH_CHAIN), 1);
+  EXPECT_EQ(count_nodes(svm_nodes, NODE_MATH), 0);
+  EXPECT_EQ(count_nodes(svm_nodes, NODE_VALUE_F), 0);
+}
+
+/*
+ * Tests:
+ *  - Math nodes separated by other nodes start a new chain.
+ */
+TEST_F(RenderSVMCompile, math_chain_interrupted)
+{
+  ShaderGraph *graph = new ShaderGraph();
+
+  AttributeNode *attribute = graph->create_node<AttributeNode>();
+  attribute->set_attribute(ustring("weight"));
+  graph->add(attribute);
+
+  MathNode *scale = add_math(graph, attribute->output("Fac"), NODE_MATH_MULTIPLY, 2.0f);
+
+  InvertNode *invert = graph->create_node<InvertNode>();
+  graph->add(invert);
+  graph->connect(scale->output("Value"), invert->input("Color"));
+
+  RGBToBWNode *bw = graph->create_node<RGBToBWNode>();
+  graph->add(bw);
+  graph->connect(invert->output("Color"), bw->input("Color"));
+
+  MathNode *offset = add_math(graph, bw->output("Val"), NODE_MATH_ADD, 0.5f);
+
+  EmissionNode *emission = graph->create_node<EmissionNode>();
+  graph->add(emission);
+  graph->connect(offset->output("Value"), emission->input("Strength"));
+  graph->connect(emission->output("Emission"), graph->output()->input("Surface"));
+
+  array<int4> svm_nodes;
+  SVMCompiler::Summary summary;
+  compile(graph, svm_nodes, summary);
+
+  EXPECT_EQ(summary.num_fused_nodes, 0);
+  EXPECT_EQ(count_nodes(svm_nodes, NODE_MATH_CHAIN), 2);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,144 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "testing/testing.h"
+
+#include "util/path.h"
+#include "util/texture_cache.h"
+#include "util/unique_ptr.h"
+
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imageio.h>
+
+CCL_NAMESPACE_BEGIN
+
+OIIO_NAMESPACE_USING
+
+/* Write a small image of a single color. */
+static bool write_test_image(const string &filepath, const float color[4])
+{
+  const int size = 16;
+  vector<float> pixels(size * size * 4);
+  for (int i = 0; i < size * size; i++) {
+    for (int c = 0; c < 4; c++) {
+      pixels[i * 4 + c] = color[c];
+    }
+  }
+
+  unique_ptr<ImageOutput> out = ImageOutput::create(filepath);
+  if (!out) {
+    return false;
+  }
+  const ImageSpec spec(size, size, 4, TypeDesc::FLOAT);
+  if (!out->open(filepath, spec)) {
+    return false;
+  }
+  const bool ok = out->write_image(TypeDesc::FLOAT, pixels.data());
+  return out->close() && ok;
+}
+
+class TextureCacheTest : public testing::Test {
+ protected:
+  string dir_;
+
+  void SetUp() override
+  {
+    dir_ = path_join(Filesystem::temp_directory_path(),
+                     Filesystem::unique_path("cycles_texture_cache_%%%%%%%%"));
+    string error;
+    ASSERT_TRUE(Filesystem::create_directory(dir_, error)) << error;
+  }
+
+  void TearDown() override
+  {
+    string error;
+    Filesystem::remove_all(dir_, error);
+  }
+};
+
+TEST(util_texture_cache, tiled_filepath)
+{
+  EXPECT_EQ(TextureCache::tiled_filepath("/textures/wood.png"), "/textures/wood.png.tx");
+  EXPECT_EQ(TextureCache::tiled_filepath("/textures/wood.jpg"), "/textures/wood.jpg.tx");
+  EXPECT_EQ(TextureCache::tiled_filepath("wood"), "wood.tx");
+}
+
+TEST_F(TextureCacheTest, resolve_converted_file)
+{
+  const float red[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+  const string filepath = path_join(dir_, "red.exr");
+  ASSERT_TRUE(write_test_image(filepath, red));
+
+  TextureCache cache(16);
+  /* Not converted yet. */
+  EXPECT_EQ(cache.resolve_filepath(filepath), filepath);
+
+  const string tiled = TextureCache::tiled_filepath(filepath);
+  string error;
+  ASSERT_TRUE(TextureCache::make_tiled(filepath, tiled, &error)) << error;
+  EXPECT_EQ(cache.resolve_filepath(filepath), tiled);
+}
+
+TEST_F(TextureCacheTest, ignore_file_converted_from_other_image)
+{
+  const float red[4] = {1.0f, 0.0f, 0.0f, 1.0f};
+  const float green[4] = {0.0f, 1.0f, 0.0f, 1.0f};
+  const string red_filepath = path_join(dir_, "red.exr");
+  const string green_filepath = path_join(dir_, "green.exr");
+  ASSERT_TRUE(write_test_image(red_filepath, red));
+  ASSERT_TRUE(write_test_image(green_filepath, green));
+
+  /* A file converted from another image, placed where the converted green image would be. */
+  string error;
+  ASSERT_TRUE(TextureCache::make_tiled(
+      red_filepath, TextureCache::tiled_filepath(green_filepath), &error))
+      << error;
+
+  TextureCache cache(16);
+  EXPECT_EQ(cache.resolve_filepath(green_filepath), green_filepath);
+}
+
+TEST_F(TextureCacheTest, lookup)
+{
+  const float color[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+  const string filepath = path_join(dir_, "color.exr");
+  ASSERT_TRUE(write_test_image(filepath, color));
+
+  TextureCache cache(16);
+  TextureCacheImage image;
+  ASSERT_TRUE(cache.add_image(filepath, 4, &image));
+
+  /* Both the full resolution and a lower mip level hold the same color. */
+  const float4 full = texture_cache_lookup(image,
+                                           INTERPOLATION_LINEAR,
+                                           EXTENSION_REPEAT,
+                                           0.5f,
+                                           0.5f,
+                                           zero_float2(),
+                                           zero_float2());
+  const float4 mip = texture_cache_lookup(image,
+                                          INTERPOLATION_LINEAR,
+                                          EXTENSION_REPEAT,
+                                          0.5f,
+                                          0.5f,
+                                          make_float2(0.25f, 0.0f),
+                                          make_float2(0.0f, 0.25f));
+  for (const float4 &result : {full, mip}) {
+    EXPECT_NEAR(result.x, color[0], 1e-4f);
+    EXPECT_NEAR(result.y, color[1], 1e-4f);
+    EXPECT_NEAR(result.z, color[2], 1e-4f);
+    EXPECT_NEAR(result.w, color[3], 1e-4f);
+  }
+
+  /* Outside of the image with clip extension. */
+  const float4 clipped = texture_cache_lookup(image,
+                                              INTERPOLATION_LINEAR,
+                                              EXTENSION_CLIP,
+                                              1.5f,
+                                              0.5f,
+                                              zero_float2(),
+                                              zero_float2());
+  EXPECT_EQ(clipped.w, 0.0f);
+}
+
+CCL_NAMESPACE_END
@@ -51,6 +51,10 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout = BVH_LAYOUT_AUTO;
+
+    /* Render batches of paths one kernel at a time, with shading sorted by shader, instead of
+     * running the megakernel for one path at a time. */
+    bool wavefront = false;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
@@ -23,7 +23,12 @@ void Profiler::run()
   auto start_time = std::chrono::system_clock::now();
   while (!do_stop_worker) {
     thread_scoped_lock lock(mutex);
-    foreach (ProfilingState *state, states) {
+    if (thread_event_samples.size() < states.size()) {
+      thread_event_samples.resize(states.size(), vector<uint64_t>(PROFILING_NUM_EVENTS, 0));
+    }
+
+    for (size_t thread_index = 0; thread_index < states.size(); thread_index++) {
+      const ProfilingState *state = states[thread_index];
       uint32_t cur_event = state->event;
       int32_t cur_shader = state->shader;
       int32_t cur_object = state->object;
@@ -32,10 +37,15 @@ void Profiler::run()
        * check the values for validity anyways. */
       if (cur_event < PROFILING_NUM_EVENTS) {
         event_samples[cur_event]++;
+        thread_event_samples[thread_index][cur_event]++;
       }
 
       if (cur_shader >= 0 && cur_shader < shader_samples.size()) {
         shader_samples[cur_shader]++;
+
+        if (cur_event < PROFILING_NUM_EVENTS) {
+          event_shader_samples[cur_event * shader_samples.size() + cur_shader]++;
+        }
       }
 
       if (cur_object >= 0 && cur_object < object_samples.size()) {
@@ -67,6 +77,8 @@ void Profiler::reset(int num_shaders, int num_objects)
   event_samples.assign(PROFILING_NUM_EVENTS, 0);
   shader_samples.assign(num_shaders, 0);
   object_samples.assign(num_objects, 0);
+  event_shader_samples.assign(PROFILING_NUM_EVENTS * num_shaders, 0);
+  thread_event_samples.clear();
 
   if (running) {
     start();
@@ -158,6 +170,23 @@ bool Profiler::get_object(int object, uint64_t &samples, uint64_t &hits)
   return true;
 }
 
+uint64_t Profiler::get_event_shader(ProfilingEvent event, int shader)
+{
+  assert(worker == NULL);
+  return event_shader_samples[event * shader_samples.size() + shader];
+}
+
+int Profiler::get_num_threads() const
+{
+  return thread_event_samples.size();
+}
+
+uint64_t Profiler::get_thread_event(int thread, ProfilingEvent event)
+{
+  assert(worker == NULL);
+  return thread_event_samples[thread][event];
+}
+
 bool Profiler::active() const
 {
   return (worker != nullptr);
@@ -83,6 +83,13 @@ class Profiler {
   bool get_shader(int shader, uint64_t &samples, uint64_t &hits);
   bool get_object(int object, uint64_t &samples, uint64_t &hits);
 
+  /* Samples of the event while the given shader was being evaluated. */
+  uint64_t get_event_shader(ProfilingEvent event, int shader);
+
+  /* Samples of the event per worker thread, in the order the worker states were added. */
+  int get_num_threads() const;
+  uint64_t get_thread_event(int thread, ProfilingEvent event);
+
   bool active() const;
 
  protected:
@@ -95,6 +102,12 @@ class Profiler {
   vector<uint64_t> shader_samples;
   vector<uint64_t> object_samples;
 
+  /* Samples per event and shader, indexed by `event * num_shaders + shader`. */
+  vector<uint64_t> event_shader_samples;
+
+  /* Samples per event for every worker thread. */
+  vector<vector<uint64_t>> thread_event_samples;
+
   /* Tracks the total amounts every object/shader was hit.
    * Used to evaluate relative cost, written by the render thread.
    * Indexed by the shader and object IDs that the kernel also uses
@@ -30,6 +30,8 @@ class Progress {
     render_start_time = time_dt();
     time_limit = 0.0;
     end_time = 0.0;
+    sync_time = 0.0;
+    update_time = 0.0;
     status = "Initializing";
     substatus = "";
     sync_status = "";
@@ -71,6 +73,8 @@ class Progress {
     render_start_time = time_dt();
     time_limit = 0.0;
     end_time = 0.0;
+    sync_time = 0.0;
+    update_time = 0.0;
     status = "Initializing";
     substatus = "";
     sync_status = "";
@@ -174,6 +178,31 @@ class Progress {
     render_time_ = time - render_start_time;
   }
 
+  /* Time spent synchronizing the scene from the host application and updating the device
+   * scene, accumulated since the last reset. Used to report how much work is redone per frame
+   * when render data is kept between frames. */
+  void add_sync_time(double time)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    sync_time += time;
+  }
+
+  void add_update_time(double time)
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    update_time += time;
+  }
+
+  void get_sync_update_time(double &sync_time_, double &update_time_) const
+  {
+    thread_scoped_lock lock(progress_mutex);
+
+    sync_time_ = sync_time;
+    update_time_ = update_time;
+  }
+
   void set_end_time()
   {
     end_time = time_dt();
@@ -352,6 +381,8 @@ class Progress {
   double start_time, render_start_time, time_limit;
   /* End time written when render is done, so it doesn't keep increasing on redraws. */
   double end_time;
+  /* Accumulated synchronization and device scene update time. */
+  double sync_time, update_time;
 
   string status;
   string substatus;
@@ -0,0 +1,214 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#include "util/texture_cache.h"
+#include "util/log.h"
+#include "util/path.h"
+
+#include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+OIIO_NAMESPACE_USING
+
+/* Tile size used for untiled files opened through the cache, and for converted files. */
+static const int TEXTURE_CACHE_TILE_SIZE = 64;
+
+/* Metadata of converted files holding the name of the file they were converted from. */
+static const char *TEXTURE_CACHE_SOURCE_ATTRIBUTE = "cycles:source_filename";
+
+TextureCache::TextureCache(const size_t max_memory_mb)
+{
+  /* Not shared with OSL, so the memory budget only applies to images rendered through here. */
+  TextureSystem *texture_system = TextureSystem::create(false);
+
+  texture_system->attribute("automip", 1);
+  texture_system->attribute("autotile", TEXTURE_CACHE_TILE_SIZE);
+  texture_system->attribute("accept_untiled", 1);
+  texture_system->attribute("accept_unmipped", 1);
+
+  texture_system_ = texture_system;
+  set_max_memory(max_memory_mb);
+}
+
+TextureCache::~TextureCache()
+{
+  TextureSystem *texture_system = (TextureSystem *)texture_system_;
+  texture_system->invalidate_all(true);
+  TextureSystem::destroy(texture_system);
+}
+
+void TextureCache::set_max_memory(const size_t max_memory_mb)
+{
+  TextureSystem *texture_system = (TextureSystem *)texture_system_;
+  texture_system->attribute("max_memory_MB", (float)max_memory_mb);
+}
+
+string TextureCache::resolve_filepath(const string &filepath) const
+{
+  /* Prefer a converted file next to the original, unless the original changed since. */
+  const string tiled = tiled_filepath(filepath);
+  if (!path_exists(tiled) || path_modified_time(tiled) < path_modified_time(filepath)) {
+    return filepath;
+  }
+
+  /* Only use files converted from this image, not one that happens to have the same name. The
+   * directory is not compared, so converted files stay valid when moved together with the
+   * image. */
+  TextureSystem *texture_system = (TextureSystem *)texture_system_;
+  ustring source_filename;
+  if (!texture_system->get_texture_info(ustring(tiled),
+                                        0,
+                                        ustring(TEXTURE_CACHE_SOURCE_ATTRIBUTE),
+                                        TypeDesc::STRING,
+                                        &source_filename) ||
+      source_filename != path_filename(filepath)) {
+    VLOG_WARNING << "Texture cache ignores " << tiled << ", it was not converted from "
+                 << filepath << ".";
+    texture_system->invalidate(ustring(tiled));
+    return filepath;
+  }
+
+  return tiled;
+}
+
+bool TextureCache::add_image(const string &filepath,
+                             const int channels,
+                             TextureCacheImage *image)
+{
+  TextureSystem *texture_system = (TextureSystem *)texture_system_;
+
+  const string resolved_filepath = resolve_filepath(filepath);
+  TextureSystem::TextureHandle *handle = texture_system->get_texture_handle(
+      ustring(resolved_filepath));
+
+  if (handle == nullptr || !texture_system->good(handle)) {
+    VLOG_WARNING << "Texture cache failed to open " << resolved_filepath << ": "
+                 << texture_system->geterror();
+    return false;
+  }
+
+  VLOG_INFO << "Texture cache serving " << filepath << " from " << resolved_filepath << ".";
+
+  image->texture_system = texture_system;
+  image->handle = handle;
+  image->channels = channels;
+  return true;
+}
+
+void TextureCache::invalidate(const string &filepath)
+{
+  TextureSystem *texture_system = (TextureSystem *)texture_system_;
+  texture_system->invalidate(ustring(filepath));
+  texture_system->invalidate(ustring(tiled_filepath(filepath)));
+}
+
+string TextureCache::stats() const
+{
+  const TextureSystem *texture_system = (const TextureSystem *)texture_system_;
+  return texture_system->getstats(1);
+}
+
+string TextureCache::tiled_filepath(const string &filepath)
+{
+  /* Keep the original extension, so images that only differ in it get different files. */
+  return filepath + ".tx";
+}
+
+bool TextureCache::make_tiled(const string &filepath, const string &tiled_filepath, string *error)
+{
+  ImageSpec config;
+  config.tile_width = TEXTURE_CACHE_TILE_SIZE;
+  config.tile_height = TEXTURE_CACHE_TILE_SIZE;
+  config.tile_depth = 1;
+  config.attribute(TEXTURE_CACHE_SOURCE_ATTRIBUTE, path_filename(filepath));
+
+  if (!ImageBufAlgo::make_texture(ImageBufAlgo::MakeTxTexture, filepath, tiled_filepath, config)) {
+    if (error) {
+      *error = OIIO::geterror();
+    }
+    return false;
+  }
+
+  return true;
+}
+
+float4 texture_cache_lookup(const TextureCacheImage &image,
+                            const InterpolationType interpolation,
+                            const ExtensionType extension,
+                            const float x,
+                            const float y,
+                            const float2 dx,
+                            const float2 dy)
+{
+  TextureSystem *texture_system = (TextureSystem *)image.texture_system;
+  TextureSystem::TextureHandle *handle = (TextureSystem::TextureHandle *)image.handle;
+
+  TextureOpt options;
+
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      /* Keep the pixelated look at any distance. */
+      options.interpmode = TextureOpt::InterpClosest;
+      options.mipmode = TextureOpt::MipModeNoMIP;
+      break;
+    case INTERPOLATION_CUBIC:
+    case INTERPOLATION_SMART:
+      options.interpmode = TextureOpt::InterpBicubic;
+      break;
+    default:
+      options.interpmode = TextureOpt::InterpBilinear;
+      break;
+  }
+
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      options.swrap = options.twrap = TextureOpt::WrapPeriodic;
+      break;
+    case EXTENSION_CLIP:
+      if (x < 0.0f || x > 1.0f || y < 0.0f || y > 1.0f) {
+        return zero_float4();
+      }
+      options.swrap = options.twrap = TextureOpt::WrapBlack;
+      break;
+    case EXTENSION_MIRROR:
+      options.swrap = options.twrap = TextureOpt::WrapMirror;
+      break;
+    default:
+      options.swrap = options.twrap = TextureOpt::WrapClamp;
+      break;
+  }
+
+  /* OpenImageIO has the origin in the top left corner. */
+  const int num_channels = min(image.channels, 4);
+  float result[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  if (!texture_system->texture(handle,
+                               nullptr,
+                               options,
+                               x,
+                               1.0f - y,
+                               dx.x,
+                               -dx.y,
+                               dy.x,
+                               -dy.y,
+                               num_channels,
+                               result)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  /* Expand to RGBA the same way as images loaded into memory. */
+  switch (num_channels) {
+    case 1:
+      return make_float4(result[0], result[0], result[0], 1.0f);
+    case 2:
+      return make_float4(result[0], result[0], result[0], result[1]);
+    case 3:
+      return make_float4(result[0], result[1], result[2], 1.0f);
+    default:
+      return make_float4(result[0], result[1], result[2], result[3]);
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright 2011-2022 Blender Foundation */
+
+#ifndef __UTIL_TEXTURE_CACHE_H__
+#define __UTIL_TEXTURE_CACHE_H__
+
+/* On-demand texture cache for CPU rendering.
+ *
+ * Instead of loading image files into memory at full resolution, images are served from an
+ * OpenImageIO texture system that reads tiles of the mip level selected by the lookup
+ * footprint on first access, and evicts the least recently used tiles once the memory budget
+ * is exceeded. Files that are not tiled and mip-mapped already get tiled and mip-mapped in
+ * memory when opened, so for the memory savings to apply to large scenes the images should be
+ * converted up front with make_tiled(). */
+
+#include "util/string.h"
+#include "util/texture.h"
+#include "util/types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Image served from the texture cache. Stored in device texture memory in place of the pixels,
+ * so the kernel can find the texture system and file for a texture slot. */
+struct TextureCacheImage {
+  void *texture_system;
+  void *handle;
+  int channels;
+};
+
+class TextureCache {
+ public:
+  explicit TextureCache(const size_t max_memory_mb);
+  ~TextureCache();
+
+  TextureCache(const TextureCache &other) = delete;
+  TextureCache &operator=(const TextureCache &other) = delete;
+
+  void set_max_memory(const size_t max_memory_mb);
+
+  /* Open an image file for lookups through the cache. Uses a tiled version of the file written
+   * by make_tiled() when it exists and is up to date. Returns false if the file can not be
+   * read. */
+  bool add_image(const string &filepath, const int channels, TextureCacheImage *image);
+
+  /* Release all cached tiles of an image file. */
+  void invalidate(const string &filepath);
+
+  /* Human readable cache statistics. */
+  string stats() const;
+
+  /* Offline conversion of an image file to a tiled and mip-mapped file. The converted file is
+   * named after the image with ".tx" appended, and stores the name of the image it was converted
+   * from. */
+  static string tiled_filepath(const string &filepath);
+  static bool make_tiled(const string &filepath, const string &tiled_filepath, string *error);
+
+  /* File that lookups of an image are served from: its converted file when that exists, is newer
+   * than the image and was converted from it, otherwise the image itself. */
+  string resolve_filepath(const string &filepath) const;
+
+ private:
+
+  void *texture_system_;
+};
+
+/* Filtered lookup of an image in the cache. Coordinates are in the 0..1 range with the origin in
+ * the bottom left corner, as for regular image textures. The derivatives of the coordinates with
+ * respect to screen space select the mip level, zero derivatives sample the full resolution. */
+float4 texture_cache_lookup(const TextureCacheImage &image,
+                            const InterpolationType interpolation,
+                            const ExtensionType extension,
+                            const float x,
+                            const float y,
+                            const float2 dx,
+                            const float2 dy);
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TEXTURE_CACHE_H__ */
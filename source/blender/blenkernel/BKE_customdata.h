@@ -78,9 +78,16 @@ typedef enum eCDAllocType {
   CD_ASSIGN = 0,
   /** Allocate and set to default, which is usually just zeroed memory. */
   CD_SET_DEFAULT = 2,
-  /** Use data pointers, set layer flag NOFREE. */
+  /**
+   * Use data pointers, set layer flag NOFREE. When copying layers that track their users, the data
+   * is shared like with #CD_DUPLICATE instead.
+   */
   CD_REFERENCE = 3,
-  /** Do a full copy of all layers, only allowed if source has same number of elements. */
+  /**
+   * Copy all layers, only allowed if source has same number of elements. Layers that track their
+   * users share the data with the source, which is only copied when either of them is accessed
+   * for writing (see #CustomData_ensure_data_is_mutable).
+   */
   CD_DUPLICATE = 4,
   /**
    * Default construct new layer values. Does nothing for trivial types. This should be used
@@ -297,10 +304,25 @@ int CustomData_number_of_anonymous_layers(const struct CustomData *data, int typ
 int CustomData_number_of_layers_typemask(const struct CustomData *data, eCustomDataMask mask);
 
 /**
- * Duplicate all the layers with flag NOFREE, and remove the flag from duplicated layers.
+ * Duplicate all the layers with flag NOFREE or with data shared with other layers, and remove the
+ * flag from duplicated layers.
  */
 void CustomData_duplicate_referenced_layers(CustomData *data, int totelem);
 
+/**
+ * Make sure the data of the layer can be modified in place, by copying it if it is referenced
+ * (#CD_FLAG_NOFREE) or shared with layers of other #CustomData. Has to be called before writing
+ * to #CustomDataLayer.data directly, the `_for_write` accessors do this already.
+ */
+void CustomData_ensure_data_is_mutable(struct CustomDataLayer *layer, int totelem);
+
+/**
+ * Give up the layer's user of its array, without freeing the data its elements point to, for
+ * callers that keep a copy of the elements. The array is only freed when it isn't shared with
+ * other layers, referenced or external.
+ */
+void CustomData_layer_release_array(struct CustomDataLayer *layer);
+
 /**
  * Set the #CD_FLAG_NOCOPY flag in custom data layers where the mask is
  * zero for the layer type, so only layer types specified by the mask will be copied
@@ -311,6 +333,9 @@ void CustomData_set_only_copy(const struct CustomData *data, eCustomDataMask mas
  * Copies data from one CustomData object to another
  * objects need not be compatible, each source layer is copied to the
  * first dest layer of correct type (if there is none, the layer is skipped).
+ *
+ * \note Like all functions that modify elements in place, destination layers that share their
+ * data with other #CustomData are copied first (see #CustomData_ensure_data_is_mutable).
  */
 void CustomData_copy_data(const struct CustomData *source,
                           struct CustomData *dest,
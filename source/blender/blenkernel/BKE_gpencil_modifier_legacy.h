@@ -239,6 +239,14 @@ typedef struct GpencilModifierTypeInfo {
  * Initialize modifier's global data (type info and some common global storage).
  */
 void BKE_gpencil_modifier_init(void);
+/**
+ * Free modifier's global data.
+ */
+void BKE_gpencil_modifier_exit(void);
+/**
+ * Free data modifiers keep for later evaluations, when it isn't needed anymore (loading a file).
+ */
+void BKE_gpencil_modifier_free_caches(void);
 
 /**
  * Get the idname of the modifier type's panel, which was defined in the #panelRegister callback.
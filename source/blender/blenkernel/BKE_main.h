@@ -121,6 +121,14 @@ typedef struct Main {
   bool recovered;
   /** All current ID's exist in the last memfile undo step. */
   bool is_memfile_undo_written;
+  /**
+   * The IDs are still at the addresses stored in the last memfile undo step, and all changes
+   * since are tracked in their `recalc_after_undo_push` or #LIB_TAG_UNDO_CHANGED. Then the next
+   * undo step can reuse the stored data of unchanged IDs instead of writing them again. Only set
+   * when enabled in the experimental preferences, and cleared when other undo systems changed
+   * data since the last memfile undo step.
+   */
+  bool is_memfile_undo_reusable;
   /**
    * An ID needs its data to be flushed back.
    * use "needs_flush_to_id" in edit data to flag data which needs updating.
@@ -640,6 +640,7 @@ std::optional<GMutableSpan> CustomDataAttributes::get_for_write(const AttributeI
     if (custom_data_layer_matches_attribute_id(layer, attribute_id)) {
       const CPPType *cpp_type = custom_data_type_to_cpp_type((eCustomDataType)layer.type);
       BLI_assert(cpp_type != nullptr);
+      CustomData_ensure_data_is_mutable(&layer, size_);
       return GMutableSpan(*cpp_type, layer.data, size_);
     }
   }
@@ -29,6 +29,7 @@
 #include "BKE_cachefile.h"
 #include "BKE_callbacks.h"
 #include "BKE_global.h"
+#include "BKE_gpencil_modifier_legacy.h"
 #include "BKE_idprop.h"
 #include "BKE_image.h"
 #include "BKE_layer.h"
@@ -75,6 +76,7 @@ void BKE_blender_free(void)
   DEG_free_node_types();
 
   BKE_brush_system_exit();
+  BKE_gpencil_modifier_exit();
   RE_texture_rng_exit();
 
   BKE_callback_global_finalize();
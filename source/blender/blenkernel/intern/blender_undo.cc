@@ -23,6 +23,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
@@ -135,6 +136,9 @@ MemFileUndoData *BKE_memfile_undo_encode(Main *bmain, MemFileUndoData *mfu_prev)
   }
 
   bmain->is_memfile_undo_written = true;
+  /* A memfile undo step read back creates a new Main, which starts out as not reusable. */
+  bmain->is_memfile_undo_reusable = !UNDO_DISK &&
+                                    USER_EXPERIMENTAL_TEST(&U, use_undo_skip_unchanged);
 
   return mfu;
 }
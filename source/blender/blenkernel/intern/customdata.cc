@@ -20,6 +20,7 @@
 #include "BLI_bitmap.h"
 #include "BLI_color.hh"
 #include "BLI_endian_switch.h"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_index_range.hh"
 #include "BLI_math.h"
 #include "BLI_math_color_blend.h"
@@ -59,6 +60,7 @@
 #include "data_transfer_intern.h"
 
 using blender::float2;
+using blender::ImplicitSharingInfo;
 using blender::IndexRange;
 using blender::Set;
 using blender::Span;
@@ -2162,9 +2164,145 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
                                                        int type,
                                                        eCDAllocType alloctype,
                                                        void *layerdata,
+                                                       const ImplicitSharingInfo *sharing_info,
                                                        int totelem,
                                                        const char *name);
 
+static void free_layer_data(const int type, void *data, const int totelem)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+  if (typeInfo->free) {
+    typeInfo->free(data, totelem, typeInfo->size);
+  }
+  MEM_freeN(data);
+}
+
+static void *copy_layer_data(const int type, const void *data, const int totelem)
+{
+  /* #MEM_dupallocN won't work in case of complex layers, like e.g. #CD_MDEFORMVERT, which has
+   * pointers to allocated data. So in case a custom copy function is defined, use it. */
+  const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+  void *new_data = MEM_malloc_arrayN(size_t(totelem), typeInfo->size, layerType_getName(type));
+  if (typeInfo->copy) {
+    typeInfo->copy(data, new_data, totelem);
+  }
+  else {
+    memcpy(new_data, data, size_t(totelem) * typeInfo->size);
+  }
+  return new_data;
+}
+
+/**
+ * User count of layer data that is owned by something else, like an array in a memory mapped
+ * file. Keeps the owner alive, and remembers the number of elements, which is needed to copy the
+ * data before modifying single elements.
+ */
+class ExternalLayerSharingInfo : public ImplicitSharingInfo {
+ private:
+  const ImplicitSharingInfo *owner_;
+  int totelem_;
+
+ public:
+  ExternalLayerSharingInfo(const ImplicitSharingInfo *owner, const int totelem)
+      : owner_(owner), totelem_(totelem)
+  {
+  }
+
+  ~ExternalLayerSharingInfo() override
+  {
+    if (owner_->remove_user()) {
+      delete owner_;
+    }
+  }
+
+  bool is_external() const override
+  {
+    return true;
+  }
+
+  int totelem() const
+  {
+    return totelem_;
+  }
+};
+
+/**
+ * Give up the layer's ownership of its data. The data is only freed when no other layer shares
+ * it anymore, and never when it is referenced (#CD_FLAG_NOFREE) or external, see
+ * #ImplicitSharingInfo::is_external.
+ */
+static void layer_remove_data_user(CustomDataLayer &layer, const int totelem)
+{
+  if (layer.sharing_info != nullptr) {
+    if (layer.sharing_info->remove_user()) {
+      if (layer.data && !layer.sharing_info->is_external()) {
+        free_layer_data(layer.type, layer.data, totelem);
+      }
+      delete layer.sharing_info;
+    }
+  }
+  else if (!(layer.flag & CD_FLAG_NOFREE) && layer.data) {
+    free_layer_data(layer.type, layer.data, totelem);
+  }
+  layer.data = nullptr;
+  layer.sharing_info = nullptr;
+}
+
+/**
+ * Copy the data of layers that reference data owned elsewhere or share it with other layers, so
+ * that it can be modified in place.
+ */
+static void ensure_layer_data_is_mutable(CustomDataLayer &layer, const int totelem)
+{
+  if (layer.data == nullptr) {
+    return;
+  }
+  if (layer.flag & CD_FLAG_NOFREE) {
+    layer.data = copy_layer_data(layer.type, layer.data, totelem);
+    layer.flag &= ~CD_FLAG_NOFREE;
+    layer.sharing_info = new ImplicitSharingInfo();
+  }
+  else if (layer.sharing_info == nullptr) {
+    /* Owned data that isn't tracked yet, start tracking it so it can be shared by later copies. */
+    layer.sharing_info = new ImplicitSharingInfo();
+  }
+  else if (!layer.sharing_info->is_mutable()) {
+    void *new_data = copy_layer_data(layer.type, layer.data, totelem);
+    layer_remove_data_user(layer, totelem);
+    layer.data = new_data;
+    layer.sharing_info = new ImplicitSharingInfo();
+  }
+}
+
+/**
+ * Number of elements in the layer's data, for code that doesn't know it otherwise. External data
+ * isn't a guarded allocation, so #MEM_allocN_len can't be used for it, its size is stored with the
+ * user count instead.
+ */
+static int layer_data_totelem(const CustomDataLayer &layer)
+{
+  if (layer.data == nullptr) {
+    return 0;
+  }
+  if (layer.sharing_info != nullptr && layer.sharing_info->is_external()) {
+    return static_cast<const ExternalLayerSharingInfo *>(layer.sharing_info)->totelem();
+  }
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer.type);
+  return int(MEM_allocN_len(layer.data) / typeInfo->size);
+}
+
+/**
+ * Same as #ensure_layer_data_is_mutable, for functions that write single elements and don't know
+ * the number of elements in the layer. Only shared data has to be copied.
+ */
+static void ensure_layer_data_is_mutable_for_elements(CustomDataLayer &layer)
+{
+  if (layer.data == nullptr || layer.sharing_info == nullptr || layer.sharing_info->is_mutable()) {
+    return;
+  }
+  ensure_layer_data_is_mutable(layer, layer_data_totelem(layer));
+}
+
 void CustomData_update_typemap(CustomData *data)
 {
   int lasttype = -1;
@@ -2251,10 +2389,11 @@ bool CustomData_merge(const CustomData *source,
 
     if ((alloctype == CD_ASSIGN) && (flag & CD_FLAG_NOFREE)) {
       newlayer = customData_add_layer__internal(
-          dest, type, CD_REFERENCE, data, totelem, layer->name);
+          dest, type, CD_REFERENCE, data, nullptr, totelem, layer->name);
     }
     else {
-      newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
+      newlayer = customData_add_layer__internal(
+          dest, type, alloctype, data, layer->sharing_info, totelem, layer->name);
     }
 
     if (newlayer) {
@@ -2278,6 +2417,7 @@ bool CustomData_merge(const CustomData *source,
       }
       if (alloctype == CD_ASSIGN) {
         layer->data = nullptr;
+        layer->sharing_info = nullptr;
       }
     }
   }
@@ -2320,20 +2460,26 @@ void CustomData_realloc(CustomData *data, const int old_size, const int new_size
 
     const int64_t old_size_in_bytes = int64_t(old_size) * typeInfo->size;
     const int64_t new_size_in_bytes = int64_t(new_size) * typeInfo->size;
-    if (layer->flag & CD_FLAG_NOFREE) {
+    if ((layer->flag & CD_FLAG_NOFREE) ||
+        (layer->sharing_info != nullptr && !layer->sharing_info->is_mutable())) {
       const void *old_data = layer->data;
-      layer->data = MEM_malloc_arrayN(new_size, typeInfo->size, __func__);
+      void *new_data = MEM_malloc_arrayN(new_size, typeInfo->size, __func__);
       if (typeInfo->copy) {
-        typeInfo->copy(old_data, layer->data, std::min(old_size, new_size));
+        typeInfo->copy(old_data, new_data, std::min(old_size, new_size));
       }
       else {
-        std::memcpy(layer->data, old_data, std::min(old_size_in_bytes, new_size_in_bytes));
+        std::memcpy(new_data, old_data, std::min(old_size_in_bytes, new_size_in_bytes));
       }
+      layer_remove_data_user(*layer, old_size);
+      layer->data = new_data;
       layer->flag &= ~CD_FLAG_NOFREE;
     }
     else {
       layer->data = MEM_reallocN(layer->data, new_size_in_bytes);
     }
+    if (layer->data != nullptr && layer->sharing_info == nullptr) {
+      layer->sharing_info = new ImplicitSharingInfo();
+    }
 
     if (new_size > old_size) {
       /* Initialize new values for non-trivial types. */
@@ -2362,23 +2508,11 @@ void CustomData_copy(const CustomData *source,
 
 static void customData_free_layer__internal(CustomDataLayer *layer, const int totelem)
 {
-  const LayerTypeInfo *typeInfo;
-
   if (layer->anonymous_id != nullptr) {
     layer->anonymous_id->user_remove();
     layer->anonymous_id = nullptr;
   }
-  if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
-    typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->free) {
-      typeInfo->free(layer->data, totelem, typeInfo->size);
-    }
-
-    if (layer->data) {
-      MEM_freeN(layer->data);
-    }
-  }
+  layer_remove_data_user(*layer, totelem);
 }
 
 static void CustomData_external_free(CustomData *data)
@@ -2744,10 +2878,16 @@ static bool customData_resize(CustomData *data, const int amount)
   return true;
 }
 
+/**
+ * \param sharing_info: User count of `layerdata` when it is the data of an existing layer. Such
+ * data is shared instead of copied for #CD_DUPLICATE and #CD_REFERENCE, and ownership of the user
+ * is moved to the new layer for #CD_ASSIGN.
+ */
 static CustomDataLayer *customData_add_layer__internal(CustomData *data,
                                                        const int type,
                                                        const eCDAllocType alloctype,
                                                        void *layerdata,
+                                                       const ImplicitSharingInfo *sharing_info,
                                                        const int totelem,
                                                        const char *name)
 {
@@ -2762,7 +2902,15 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
     return &data->layers[CustomData_get_layer_index(data, type)];
   }
 
+  int index = data->totlayer;
+  if (index >= data->maxlayer) {
+    if (!customData_resize(data, CUSTOMDATA_GROW)) {
+      return nullptr;
+    }
+  }
+
   void *newlayerdata = nullptr;
+  const ImplicitSharingInfo *new_sharing_info = nullptr;
   switch (alloctype) {
     case CD_SET_DEFAULT:
       if (totelem > 0) {
@@ -2787,41 +2935,43 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
       if (totelem > 0) {
         BLI_assert(layerdata != nullptr);
         newlayerdata = layerdata;
+        new_sharing_info = sharing_info;
+      }
+      else if (sharing_info != nullptr) {
+        CustomDataLayer old_layer{};
+        old_layer.type = type;
+        old_layer.data = layerdata;
+        old_layer.sharing_info = sharing_info;
+        layer_remove_data_user(old_layer, totelem);
       }
       else {
         MEM_SAFE_FREE(layerdata);
       }
       break;
     case CD_REFERENCE:
-      if (totelem > 0) {
-        BLI_assert(layerdata != nullptr);
-        newlayerdata = layerdata;
-        flag |= CD_FLAG_NOFREE;
-      }
-      break;
     case CD_DUPLICATE:
       if (totelem > 0) {
-        newlayerdata = MEM_malloc_arrayN(totelem, typeInfo->size, layerType_getName(type));
-        if (typeInfo->copy) {
-          typeInfo->copy(layerdata, newlayerdata, totelem);
+        BLI_assert(layerdata != nullptr);
+        if (sharing_info != nullptr) {
+          /* Share the data with the source layer, it is copied once either of them is modified.
+           * This also turns references into proper users of the data. */
+          sharing_info->add_user();
+          newlayerdata = layerdata;
+          new_sharing_info = sharing_info;
+        }
+        else if (alloctype == CD_REFERENCE) {
+          newlayerdata = layerdata;
+          flag |= CD_FLAG_NOFREE;
         }
         else {
-          BLI_assert(layerdata != nullptr);
-          BLI_assert(newlayerdata != nullptr);
-          memcpy(newlayerdata, layerdata, totelem * typeInfo->size);
+          newlayerdata = copy_layer_data(type, layerdata, totelem);
         }
       }
       break;
   }
 
-  int index = data->totlayer;
-  if (index >= data->maxlayer) {
-    if (!customData_resize(data, CUSTOMDATA_GROW)) {
-      if (newlayerdata != layerdata) {
-        MEM_freeN(newlayerdata);
-      }
-      return nullptr;
-    }
+  if (newlayerdata != nullptr && new_sharing_info == nullptr && !(flag & CD_FLAG_NOFREE)) {
+    new_sharing_info = new ImplicitSharingInfo();
   }
 
   data->totlayer++;
@@ -2841,6 +2991,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   new_layer.type = type;
   new_layer.flag = flag;
   new_layer.data = newlayerdata;
+  new_layer.sharing_info = new_sharing_info;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2881,7 +3032,7 @@ static void *customdata_add_layer(
   const LayerTypeInfo *typeInfo = layerType_getInfo(type);
 
   CustomDataLayer *layer = customData_add_layer__internal(
-      data, type, alloctype, layerdata, totelem, typeInfo->defaultname);
+      data, type, alloctype, layerdata, nullptr, totelem, typeInfo->defaultname);
   CustomData_update_typemap(data);
 
   if (layer) {
@@ -2915,7 +3066,7 @@ static void *customdata_add_layer_named(CustomData *data,
                                         const char *name)
 {
   CustomDataLayer *layer = customData_add_layer__internal(
-      data, type, alloctype, layerdata, totelem, name);
+      data, type, alloctype, layerdata, nullptr, totelem, name);
   CustomData_update_typemap(data);
 
   if (layer) {
@@ -2949,7 +3100,7 @@ void *CustomData_add_layer_anonymous(CustomData *data,
 {
   const char *name = anonymous_id->name().c_str();
   CustomDataLayer *layer = customData_add_layer__internal(
-      data, type, alloctype, layerdata, totelem, name);
+      data, type, alloctype, layerdata, nullptr, totelem, name);
   CustomData_update_typemap(data);
 
   if (layer == nullptr) {
@@ -3095,38 +3246,39 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
   }
 
   CustomDataLayer *layer = &data->layers[layer_index];
-
-  if (layer->flag & CD_FLAG_NOFREE) {
-    /* MEM_dupallocN won't work in case of complex layers, like e.g.
-     * CD_MDEFORMVERT, which has pointers to allocated data...
-     * So in case a custom copy function is defined, use it!
-     */
-    const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->copy) {
-      void *dst_data = MEM_malloc_arrayN(
-          size_t(totelem), typeInfo->size, "CD duplicate ref layer");
-      typeInfo->copy(layer->data, dst_data, totelem);
-      layer->data = dst_data;
-    }
-    else {
-      layer->data = MEM_dupallocN(layer->data);
-    }
-
-    layer->flag &= ~CD_FLAG_NOFREE;
-  }
-
+  ensure_layer_data_is_mutable(*layer, totelem);
   return layer->data;
 }
 
 void CustomData_duplicate_referenced_layers(CustomData *data, const int totelem)
 {
   for (int i = 0; i < data->totlayer; i++) {
-    CustomDataLayer *layer = &data->layers[i];
-    layer->data = customData_duplicate_referenced_layer_index(data, i, totelem);
+    ensure_layer_data_is_mutable(data->layers[i], totelem);
   }
 }
 
+void CustomData_ensure_data_is_mutable(CustomDataLayer *layer, const int totelem)
+{
+  ensure_layer_data_is_mutable(*layer, totelem);
+}
+
+void CustomData_layer_release_array(CustomDataLayer *layer)
+{
+  if (layer->sharing_info != nullptr) {
+    if (layer->sharing_info->remove_user()) {
+      if (layer->data && !layer->sharing_info->is_external()) {
+        MEM_freeN(layer->data);
+      }
+      delete layer->sharing_info;
+    }
+  }
+  else if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
+    MEM_freeN(layer->data);
+  }
+  layer->data = nullptr;
+  layer->sharing_info = nullptr;
+}
+
 void CustomData_free_temporary(CustomData *data, const int totelem)
 {
   int i, j;
@@ -3193,6 +3345,11 @@ void CustomData_copy_data_layer(const CustomData *source,
 {
   const LayerTypeInfo *typeInfo;
 
+  /* Before reading the source pointer, since the source may be the destination. */
+  if (count) {
+    ensure_layer_data_is_mutable_for_elements(dest->layers[dst_layer_index]);
+  }
+
   const void *src_data = source->layers[src_layer_index].data;
   void *dst_data = dest->layers[dst_layer_index].data;
 
@@ -3310,6 +3467,7 @@ void CustomData_free_elem(CustomData *data, const int index, const int count)
       if (typeInfo->free) {
         size_t offset = size_t(index) * typeInfo->size;
 
+        ensure_layer_data_is_mutable_for_elements(data->layers[i]);
         typeInfo->free(POINTER_OFFSET(data->layers[i].data, offset), count, typeInfo->size);
       }
     }
@@ -3372,6 +3530,7 @@ void CustomData_interp(const CustomData *source,
 
     /* if we found a matching layer, copy the data */
     if (dest->layers[dest_i].type == source->layers[src_i].type) {
+      ensure_layer_data_is_mutable_for_elements(dest->layers[dest_i]);
       void *src_data = source->layers[src_i].data;
 
       for (int j = 0; j < count; j++) {
@@ -3409,6 +3568,7 @@ void CustomData_swap_corners(CustomData *data, const int index, const int *corne
     if (typeInfo->swap) {
       const size_t offset = size_t(index) * typeInfo->size;
 
+      ensure_layer_data_is_mutable_for_elements(data->layers[i]);
       typeInfo->swap(POINTER_OFFSET(data->layers[i].data, offset), corner_indices);
     }
   }
@@ -3428,6 +3588,7 @@ void CustomData_swap(CustomData *data, const int index_a, const int index_b)
     const size_t offset_a = size * index_a;
     const size_t offset_b = size * index_b;
 
+    ensure_layer_data_is_mutable_for_elements(data->layers[i]);
     void *buff = size <= sizeof(buff_static) ? buff_static : MEM_mallocN(size, __func__);
     memcpy(buff, POINTER_OFFSET(data->layers[i].data, offset_a), size);
     memcpy(POINTER_OFFSET(data->layers[i].data, offset_a),
@@ -4176,6 +4337,8 @@ void CustomData_blend_write_prepare(CustomData &data,
       continue;
     }
     layers_to_write.append(layer);
+    /* The user count is run-time data, don't write the pointer. */
+    layers_to_write.last().sharing_info = nullptr;
   }
   data.totlayer = layers_to_write.size();
   data.maxlayer = data.totlayer;
@@ -4408,9 +4571,12 @@ bool CustomData_layer_validate(CustomDataLayer *layer, const uint totitems, cons
   }
 
   BLI_assert((totitems == 0) || layer->data);
-  BLI_assert(MEM_allocN_len(layer->data) >= totitems * typeInfo->size);
+  BLI_assert(layer_data_totelem(*layer) >= int(totitems));
 
   if (typeInfo->validate != nullptr) {
+    if (do_fixes) {
+      ensure_layer_data_is_mutable(*layer, int(totitems));
+    }
     return typeInfo->validate(layer->data, totitems, do_fixes);
   }
 
@@ -4441,6 +4607,7 @@ void CustomData_external_reload(CustomData *data, ID * /*id*/, eCustomDataMask m
       /* pass */
     }
     else if ((layer->flag & CD_FLAG_EXTERNAL) && (layer->flag & CD_FLAG_IN_MEMORY)) {
+      ensure_layer_data_is_mutable(*layer, totelem);
       if (typeInfo->free) {
         typeInfo->free(layer->data, totelem, typeInfo->size);
       }
@@ -4503,6 +4670,7 @@ void CustomData_external_read(CustomData *data, ID *id, eCustomDataMask mask, co
 
       if (blay) {
         if (cdf_read_layer(cdf, blay)) {
+          ensure_layer_data_is_mutable(*layer, totelem);
           if (typeInfo->read(cdf, layer->data, totelem)) {
             /* pass */
           }
@@ -5145,9 +5313,22 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->sharing_info = nullptr;
 
     if (CustomData_verify_versions(data, i)) {
-      BLO_read_data_address(reader, &layer->data);
+      const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+      if (typeInfo->copy == nullptr && typeInfo->free == nullptr) {
+        /* Plain arrays can stay in the memory mapped file until they are modified. */
+        const ImplicitSharingInfo *file_sharing_info;
+        layer->data = BLO_read_get_new_data_address_shared(
+            reader, layer->data, &file_sharing_info);
+        if (file_sharing_info != nullptr) {
+          layer->sharing_info = new ExternalLayerSharingInfo(file_sharing_info, count);
+        }
+      }
+      else {
+        BLO_read_data_address(reader, &layer->data);
+      }
       if (CustomData_layer_ensure_data_exists(layer, count)) {
         /* Under normal operations, this shouldn't happen, but...
          * For a CD_PROP_BOOL example, see #84935.
@@ -5156,6 +5337,9 @@ void CustomData_blend_read(BlendDataReader *reader, CustomData *data, const int
                   "Allocated custom data layer that was not saved correctly for layer->type = %d.",
                   layer->type);
       }
+      if (layer->data != nullptr && layer->sharing_info == nullptr) {
+        layer->sharing_info = new ImplicitSharingInfo();
+      }
 
       if (layer->type == CD_MDISPS) {
         blend_read_mdisps(
@@ -5194,8 +5378,9 @@ void CustomData_debug_info_from_layers(const CustomData *data, const char *inden
       /* NOTE: doesn't account for multiple layers. */
       const char *name = CustomData_layertype_name(type);
       const int size = CustomData_sizeof(type);
-      const void *pt = CustomData_get_layer(data, type);
-      const int pt_size = pt ? int(MEM_allocN_len(pt) / size) : 0;
+      const CustomDataLayer &layer = data->layers[CustomData_get_active_layer_index(data, type)];
+      const void *pt = layer.data;
+      const int pt_size = layer_data_totelem(layer);
       const char *structname;
       int structnum;
       CustomData_file_write_info(type, &structname, &structnum);
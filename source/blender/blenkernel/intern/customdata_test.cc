@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <cmath>
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_customdata.h"
+
+#include "DNA_meshdata_types.h"
+
+#include "testing/testing.h"
+
+namespace blender::bke::tests {
+
+static constexpr int elements_num = 4;
+
+class CustomDataSharingTest : public testing::Test {
+ protected:
+  CustomData source_;
+  CustomData copy_;
+
+  void SetUp() override
+  {
+    CustomData_reset(&source_);
+    CustomData_reset(&copy_);
+
+    float *values = static_cast<float *>(
+        CustomData_add_layer(&source_, CD_PROP_FLOAT, CD_SET_DEFAULT, elements_num));
+    for (int i = 0; i < elements_num; i++) {
+      values[i] = float(i);
+    }
+
+    MCol *colors = static_cast<MCol *>(
+        CustomData_add_layer(&source_, CD_MCOL, CD_SET_DEFAULT, elements_num));
+    for (int i = 0; i < elements_num * 4; i++) {
+      colors[i].r = uchar(i);
+    }
+
+    /* Only the last vertex has weights, so that copying to other elements doesn't leak. */
+    MDeformVert *dverts = static_cast<MDeformVert *>(
+        CustomData_add_layer(&source_, CD_MDEFORMVERT, CD_SET_DEFAULT, elements_num));
+    MDeformVert &dvert = dverts[elements_num - 1];
+    dvert.dw = static_cast<MDeformWeight *>(MEM_callocN(sizeof(MDeformWeight), __func__));
+    dvert.dw->weight = 0.5f;
+    dvert.totweight = 1;
+
+    CustomData_copy(&source_, &copy_, CD_MASK_ALL, CD_DUPLICATE, elements_num);
+  }
+
+  void TearDown() override
+  {
+    CustomData_free(&source_, elements_num);
+    CustomData_free(&copy_, elements_num);
+  }
+
+  const float *source_values() const
+  {
+    return static_cast<const float *>(CustomData_get_layer(&source_, CD_PROP_FLOAT));
+  }
+
+  const float *copy_values() const
+  {
+    return static_cast<const float *>(CustomData_get_layer(&copy_, CD_PROP_FLOAT));
+  }
+
+  void expect_source_unchanged() const
+  {
+    for (int i = 0; i < elements_num; i++) {
+      EXPECT_EQ(source_values()[i], float(i));
+    }
+    const MCol *colors = static_cast<const MCol *>(CustomData_get_layer(&source_, CD_MCOL));
+    for (int i = 0; i < elements_num * 4; i++) {
+      EXPECT_EQ(colors[i].r, uchar(i));
+    }
+    const MDeformVert *dverts = static_cast<const MDeformVert *>(
+        CustomData_get_layer(&source_, CD_MDEFORMVERT));
+    const MDeformVert &dvert = dverts[elements_num - 1];
+    ASSERT_EQ(dvert.totweight, 1);
+    EXPECT_EQ(dvert.dw->weight, 0.5f);
+  }
+};
+
+TEST_F(CustomDataSharingTest, DuplicateShares)
+{
+  EXPECT_EQ(source_values(), copy_values());
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, Swap)
+{
+  CustomData_swap(&copy_, 0, 1);
+  EXPECT_EQ(copy_values()[0], 1.0f);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, SwapCorners)
+{
+  const int corner_indices[4] = {3, 2, 1, 0};
+  CustomData_swap_corners(&copy_, 0, corner_indices);
+  const MCol *colors = static_cast<const MCol *>(CustomData_get_layer(&copy_, CD_MCOL));
+  EXPECT_EQ(colors[0].r, 3);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, CopyData)
+{
+  CustomData_copy_data(&copy_, &copy_, 0, 1, 1);
+  EXPECT_EQ(copy_values()[1], 0.0f);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, CopyDataLayer)
+{
+  const int layer_index = CustomData_get_layer_index(&copy_, CD_PROP_FLOAT);
+  CustomData_copy_data_layer(&source_, &copy_, layer_index, layer_index, 3, 0, 1);
+  EXPECT_EQ(copy_values()[0], 3.0f);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, Interp)
+{
+  const int src_indices[2] = {2, 3};
+  CustomData_interp(&copy_, &copy_, src_indices, nullptr, nullptr, 2, 0);
+  EXPECT_EQ(copy_values()[0], 2.5f);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, FreeElem)
+{
+  CustomData_free_elem(&copy_, 0, elements_num);
+  const MDeformVert *dverts = static_cast<const MDeformVert *>(
+      CustomData_get_layer(&copy_, CD_MDEFORMVERT));
+  EXPECT_EQ(dverts[elements_num - 1].dw, nullptr);
+  expect_source_unchanged();
+}
+
+TEST_F(CustomDataSharingTest, Validate)
+{
+  /* Writing to the source makes a copy, share the invalid data with the copy again. */
+  float *values = static_cast<float *>(
+      CustomData_get_layer_for_write(&source_, CD_PROP_FLOAT, elements_num));
+  values[0] = NAN;
+  CustomData_free(&copy_, elements_num);
+  CustomData_copy(&source_, &copy_, CD_MASK_ALL, CD_DUPLICATE, elements_num);
+
+  CustomDataLayer *layer = &copy_.layers[CustomData_get_layer_index(&copy_, CD_PROP_FLOAT)];
+  EXPECT_TRUE(CustomData_layer_validate(layer, elements_num, true));
+  EXPECT_EQ(copy_values()[0], 0.0f);
+  EXPECT_TRUE(std::isnan(source_values()[0]));
+}
+
+}  // namespace blender::bke::tests
@@ -283,6 +283,7 @@ void BKE_editmesh_loop_tangent_calc(BMEditMesh *em,
         BM_mesh_elem_index_ensure(bm, htype_index);
 
         mesh2tangent->looptris = (const BMLoop *(*)[3])em->looptris;
+        CustomData_ensure_data_is_mutable(&loopdata_out->layers[index], int(loopdata_out_len));
         mesh2tangent->tangent = static_cast<float(*)[4]>(loopdata_out->layers[index].data);
 
         BLI_task_pool_push(
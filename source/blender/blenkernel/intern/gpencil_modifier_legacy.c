@@ -331,6 +331,8 @@ void BKE_gpencil_modifier_init(void)
   /* Initialize modifier types */
   gpencil_modifier_type_init(modifier_gpencil_types); /* MOD_gpencil_util.c */
 
+  MOD_lineart_memory_init();
+
 #if 0
   /* Note that GPencil actually does not support these at the moment,
    * but might do in the future. */
@@ -349,6 +351,17 @@ void BKE_gpencil_modifier_init(void)
 #endif
 }
 
+void BKE_gpencil_modifier_exit(void)
+{
+  BKE_gpencil_modifier_free_caches();
+}
+
+void BKE_gpencil_modifier_free_caches(void)
+{
+  MOD_lineart_shadow_cache_free();
+  MOD_lineart_memory_free_spare();
+}
+
 GpencilModifierData *BKE_gpencil_modifier_new(int type)
 {
   const GpencilModifierTypeInfo *mti = BKE_gpencil_modifier_get_info(type);
@@ -928,6 +941,14 @@ void BKE_gpencil_modifier_blend_read_data(BlendDataReader *reader, ListBase *lb)
       LatticeGpencilModifierData *gpmd = (LatticeGpencilModifierData *)md;
       gpmd->cache_data = NULL;
     }
+    else if (md->type == eGpencilModifierType_Lineart) {
+      LineartGpencilModifierData *lmd = (LineartGpencilModifierData *)md;
+      lmd->cache = NULL;
+      lmd->la_data_ptr = NULL;
+      lmd->la_profile_ptr = NULL;
+      /* Results of the previous evaluation are runtime data, never read them from a file. */
+      lmd->la_incremental_ptr = NULL;
+    }
     else if (md->type == eGpencilModifierType_Hook) {
       HookGpencilModifierData *hmd = (HookGpencilModifierData *)md;
 
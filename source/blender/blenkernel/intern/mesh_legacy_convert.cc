@@ -1302,6 +1302,8 @@ void BKE_mesh_legacy_face_set_to_generic(Mesh *mesh)
   void *faceset_data = nullptr;
   for (const int i : IndexRange(mesh->pdata.totlayer)) {
     if (mesh->pdata.layers[i].type == CD_SCULPT_FACE_SETS) {
+      /* The array is moved to the new layer, so it must not be shared with other meshes. */
+      CustomData_ensure_data_is_mutable(&mesh->pdata.layers[i], mesh->totpoly);
       faceset_data = mesh->pdata.layers[i].data;
       mesh->pdata.layers[i].data = nullptr;
       CustomData_free_layer(&mesh->pdata, CD_SCULPT_FACE_SETS, mesh->totpoly, i);
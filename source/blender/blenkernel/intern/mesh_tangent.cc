@@ -527,6 +527,7 @@ void BKE_mesh_calc_loop_tangent_ex(const float (*vert_positions)[3],
           tangent_mask_curr |= short(1 << (uv_ind - uv_start));
         }
 
+        CustomData_ensure_data_is_mutable(&loopdata_out->layers[index], int(loopdata_out_len));
         mesh2tangent->tangent = static_cast<float(*)[4]>(loopdata_out->layers[index].data);
         BLI_task_pool_push(task_pool, DM_calc_loop_tangents_thread, mesh2tangent, false, nullptr);
       }
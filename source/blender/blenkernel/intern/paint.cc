@@ -2584,6 +2584,7 @@ static bool sculpt_attr_update(Object *ob, SculptAttribute *attr)
         attr->bmesh_cd_offset = cdata->layers[layer_index].offset;
       }
       else {
+        CustomData_ensure_data_is_mutable(&cdata->layers[layer_index], elem_num);
         attr->data = cdata->layers[layer_index].data;
       }
     }
@@ -2700,6 +2701,7 @@ SculptAttribute *BKE_sculpt_attribute_get(struct Object *ob,
       attr->used = true;
       attr->domain = domain;
       attr->proptype = proptype;
+      CustomData_ensure_data_is_mutable(&cdata->layers[index], totelem);
       attr->data = cdata->layers[index].data;
       attr->bmesh_cd_offset = cdata->layers[index].offset;
       attr->elem_num = totelem;
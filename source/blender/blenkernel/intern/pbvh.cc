@@ -1646,6 +1646,10 @@ bool BKE_pbvh_get_color_layer(const Mesh *me, CustomDataLayer **r_layer, eAttrDo
     return false;
   }
 
+  /* The layer is painted on directly, so it must not share its data with other meshes. */
+  CustomData_ensure_data_is_mutable(layer,
+                                    domain == ATTR_DOMAIN_POINT ? me->totvert : me->totloop);
+
   *r_layer = layer;
   *r_attr = domain;
 
@@ -3254,7 +3258,12 @@ void BKE_pbvh_vert_coords_apply(PBVH *pbvh, const float (*vertCos)[3], const int
       /* original data and applying new coords to this arrays would lead to */
       /* unneeded deformation -- duplicate verts/faces to avoid this */
 
-      pbvh->vert_positions = static_cast<float(*)[3]>(MEM_dupallocN(pbvh->vert_positions));
+      /* The positions may be shared with other meshes or point into a file mapping, so copy them
+       * with the known vertex count rather than with #MEM_dupallocN. */
+      float(*positions)[3] = static_cast<float(*)[3]>(
+          MEM_malloc_arrayN(size_t(pbvh->totvert), sizeof(float[3]), __func__));
+      memcpy(positions, pbvh->vert_positions, sizeof(float[3]) * size_t(pbvh->totvert));
+      pbvh->vert_positions = positions;
       /* No need to dupalloc pbvh->looptri, this one is 'totally owned' by pbvh,
        * it's never some mesh data. */
 
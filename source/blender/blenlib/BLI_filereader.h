@@ -25,6 +25,7 @@ typedef int64_t off64_t;
 extern "C" {
 #endif
 
+struct BLI_mmap_file;
 struct FileReader;
 
 typedef ssize_t (*FileReaderReadFn)(struct FileReader *reader, void *buffer, size_t size);
@@ -52,6 +53,12 @@ typedef struct FileReader {
 FileReader *BLI_filereader_new_file(int filedes) ATTR_WARN_UNUSED_RESULT;
 /** Create #FileReader from raw file descriptor using memory-mapped IO. */
 FileReader *BLI_filereader_new_mmap(int filedes) ATTR_WARN_UNUSED_RESULT;
+/**
+ * The memory mapping of a #FileReader created with #BLI_filereader_new_mmap, NULL for all other
+ * readers. The mapping is owned by the reader, see #BLI_mmap_user_add to keep it alive longer.
+ */
+struct BLI_mmap_file *BLI_filereader_mmap_file(FileReader *reader) ATTR_WARN_UNUSED_RESULT
+    ATTR_NONNULL();
 /** Create #FileReader from a region of memory. */
 FileReader *BLI_filereader_new_memory(const void *data, size_t len) ATTR_WARN_UNUSED_RESULT
     ATTR_NONNULL();
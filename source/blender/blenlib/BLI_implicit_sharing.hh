@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+#pragma once
+
+/** \file
+ * \ingroup bli
+ */
+
+#include <atomic>
+
+#include "BLI_utildefines.h"
+#include "BLI_utility_mixins.hh"
+
+namespace blender {
+
+/**
+ * The user count of an array or other data that is shared between multiple owners instead of
+ * being copied ("implicit sharing"). Copying the owner only adds a user, the data itself is only
+ * copied once one of the owners wants to modify it while it is still shared.
+ *
+ * The sharing info does not know about the data it counts the users of. The owner that removes
+ * the last user is responsible for freeing the data and deleting the sharing info. All owners
+ * have to follow the rule that data must not be modified while #is_shared returns true.
+ *
+ * The user count is atomic, so owners can be copied and freed from different threads. The data
+ * itself is not protected, but since shared data is never modified, that is not necessary.
+ *
+ * Subclasses can keep data alive that is not owned by its users, see #is_external.
+ */
+class ImplicitSharingInfo : NonCopyable, NonMovable {
+ private:
+  mutable std::atomic<int> users_;
+
+ public:
+  ImplicitSharingInfo(const int initial_users = 1) : users_(initial_users)
+  {
+  }
+
+  virtual ~ImplicitSharingInfo()
+  {
+    BLI_assert(users_ == 0);
+  }
+
+  /**
+   * True when the data is not owned by its users but kept alive by the sharing info itself, for
+   * example data that points into a memory mapped file. The last user then only deletes the
+   * sharing info. Such data is never mutable, because it may be in read-only memory.
+   */
+  virtual bool is_external() const
+  {
+    return false;
+  }
+
+  /** True if there is more than one owner, so the data has to be copied before modifying it. */
+  bool is_shared() const
+  {
+    return users_.load(std::memory_order_relaxed) >= 2;
+  }
+
+  /** True if the caller is the only owner and may modify the data in place. */
+  bool is_mutable() const
+  {
+    return !this->is_shared() && !this->is_external();
+  }
+
+  void add_user() const
+  {
+    users_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Remove a user. When true is returned, the caller was the last user and has to free the shared
+   * data and delete the sharing info.
+   */
+  [[nodiscard]] bool remove_user() const
+  {
+    const int old_user_count = users_.fetch_sub(1, std::memory_order_acq_rel);
+    BLI_assert(old_user_count >= 1);
+    return old_user_count == 1;
+  }
+};
+
+}  // namespace blender
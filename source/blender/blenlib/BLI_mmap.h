@@ -33,6 +33,19 @@ bool BLI_mmap_read(BLI_mmap_file *file, void *dest, size_t offset, size_t length
 
 void *BLI_mmap_get_pointer(BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT;
 
+/* Size of the mapped region, which is the length of the file. */
+size_t BLI_mmap_get_length(const BLI_mmap_file *file) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+
+/* Keeps the mapping alive for another user, e.g. data that points into the mapped memory
+ * directly. Every user has to call #BLI_mmap_free when done.
+ * Note that memory of a file that can not be read anymore reads as zeroes. */
+void BLI_mmap_user_add(BLI_mmap_file *file) ATTR_NONNULL(1);
+
+/* Whether reading any of the currently mapped files failed, in which case their memory reads as
+ * zeroes (only detected on platforms that use a signal handler for errors). */
+bool BLI_mmap_any_io_error(void) ATTR_WARN_UNUSED_RESULT;
+
+/* Removes a user, the mapping is only freed together with its last user. */
 void BLI_mmap_free(BLI_mmap_file *file) ATTR_NONNULL(1);
 
 #ifdef __cplusplus
@@ -10,6 +10,8 @@
 #include "BLI_listbase.h"
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include <string.h>
 
 #ifndef WIN32
@@ -32,6 +34,9 @@ struct BLI_mmap_file {
   /* Platform-specific handle for the mapping. */
   void *handle;
 
+  /* Number of users, the mapping is freed when the last user is removed. */
+  int32_t users;
+
   /* Flag to indicate IO errors. Needs to be volatile since it's being set from
    * within the signal handler, which is not part of the normal execution flow. */
   volatile bool io_error;
@@ -52,11 +57,28 @@ struct BLI_mmap_file {
  */
 
 static struct error_handler_data {
+  /* Protects `open_mmaps`, files can be freed from any thread when their data is referenced
+   * directly. A spin lock on an atomic instead of a mutex, since it is also taken in the signal
+   * handler. It is never held while accessing mapped memory, so a thread can't get a SIGBUS while
+   * holding it. */
+  int32_t lock;
   ListBase open_mmaps;
   char configured;
   void (*next_handler)(int, siginfo_t *, void *);
 } error_handler = {0};
 
+static void open_mmaps_lock(void)
+{
+  while (atomic_cas_int32(&error_handler.lock, 0, 1) != 0) {
+    /* Pass. */
+  }
+}
+
+static void open_mmaps_unlock(void)
+{
+  atomic_store_int32(&error_handler.lock, 0);
+}
+
 static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 {
   /* We only handle SIGBUS here for now. */
@@ -64,6 +86,7 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
 
   char *error_addr = (char *)siginfo->si_addr;
   /* Find the file that this error belongs to. */
+  open_mmaps_lock();
   LISTBASE_FOREACH (LinkData *, link, &error_handler.open_mmaps) {
     BLI_mmap_file *file = link->data;
 
@@ -78,9 +101,11 @@ static void sigbus_handler(int sig, siginfo_t *siginfo, void *ptr)
         fprintf(stderr, "SIGBUS handler: Error replacing mapped file with zeros\n");
       }
 
+      open_mmaps_unlock();
       return;
     }
   }
+  open_mmaps_unlock();
 
   /* Fall back to other handler if there was one. */
   if (error_handler.next_handler) {
@@ -117,14 +142,20 @@ static bool sigbus_handler_setup(void)
 /* Adds a file to the list that the error handler checks. */
 static void sigbus_handler_add(BLI_mmap_file *file)
 {
-  BLI_addtail(&error_handler.open_mmaps, BLI_genericNodeN(file));
+  LinkData *link = BLI_genericNodeN(file);
+  open_mmaps_lock();
+  BLI_addtail(&error_handler.open_mmaps, link);
+  open_mmaps_unlock();
 }
 
 /* Removes a file from the list that the error handler checks. */
 static void sigbus_handler_remove(BLI_mmap_file *file)
 {
+  open_mmaps_lock();
   LinkData *link = BLI_findptr(&error_handler.open_mmaps, file, offsetof(LinkData, data));
-  BLI_freelinkN(&error_handler.open_mmaps, link);
+  BLI_remlink(&error_handler.open_mmaps, link);
+  open_mmaps_unlock();
+  MEM_freeN(link);
 }
 #endif
 
@@ -166,6 +197,7 @@ BLI_mmap_file *BLI_mmap_open(int fd)
   file->memory = memory;
   file->handle = handle;
   file->length = length;
+  file->users = 1;
 
 #ifndef WIN32
   /* Register the file with the error handler. */
@@ -207,11 +239,41 @@ void *BLI_mmap_get_pointer(BLI_mmap_file *file)
   return file->memory;
 }
 
+size_t BLI_mmap_get_length(const BLI_mmap_file *file)
+{
+  return file->length;
+}
+
+void BLI_mmap_user_add(BLI_mmap_file *file)
+{
+  atomic_add_and_fetch_int32(&file->users, 1);
+}
+
+bool BLI_mmap_any_io_error(void)
+{
+  bool io_error = false;
+#ifndef WIN32
+  open_mmaps_lock();
+  LISTBASE_FOREACH (LinkData *, link, &error_handler.open_mmaps) {
+    const BLI_mmap_file *file = link->data;
+    io_error |= file->io_error;
+  }
+  open_mmaps_unlock();
+#endif
+  return io_error;
+}
+
 void BLI_mmap_free(BLI_mmap_file *file)
 {
+  if (atomic_sub_and_fetch_int32(&file->users, 1) > 0) {
+    return;
+  }
+
 #ifndef WIN32
-  munmap((void *)file->memory, file->length);
+  /* Remove the file first, so that an error at an address that is reused by another mapping isn't
+   * attributed to this file. */
   sigbus_handler_remove(file);
+  munmap((void *)file->memory, file->length);
 #else
   UnmapViewOfFile(file->memory);
   CloseHandle(file->handle);
@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: Apache-2.0 */
+
+#include "BLI_implicit_sharing.hh"
+#include "BLI_strict_flags.h"
+
+#include "testing/testing.h"
+
+namespace blender::tests {
+
+TEST(implicit_sharing, UserCount)
+{
+  const ImplicitSharingInfo *info = new ImplicitSharingInfo();
+  EXPECT_TRUE(info->is_mutable());
+  EXPECT_FALSE(info->is_shared());
+
+  info->add_user();
+  EXPECT_TRUE(info->is_shared());
+  EXPECT_FALSE(info->is_mutable());
+
+  EXPECT_FALSE(info->remove_user());
+  EXPECT_TRUE(info->is_mutable());
+
+  EXPECT_TRUE(info->remove_user());
+  delete info;
+}
+
+TEST(implicit_sharing, CopyOnWrite)
+{
+  /* Two owners of the same array, as created by copying the first owner. */
+  struct Owner {
+    int *data;
+    const ImplicitSharingInfo *sharing_info;
+  };
+  Owner a{new int[3]{1, 2, 3}, new ImplicitSharingInfo()};
+  Owner b = a;
+  b.sharing_info->add_user();
+
+  /* Writing to the second owner makes a copy, so the first owner is unchanged. */
+  if (b.sharing_info->is_shared()) {
+    int *new_data = new int[3]{b.data[0], b.data[1], b.data[2]};
+    EXPECT_FALSE(b.sharing_info->remove_user());
+    b.data = new_data;
+    b.sharing_info = new ImplicitSharingInfo();
+  }
+  b.data[0] = 10;
+  EXPECT_EQ(a.data[0], 1);
+  EXPECT_EQ(b.data[0], 10);
+  EXPECT_TRUE(a.sharing_info->is_mutable());
+
+  for (Owner *owner : {&a, &b}) {
+    EXPECT_TRUE(owner->sharing_info->remove_user());
+    delete[] owner->data;
+    delete owner->sharing_info;
+  }
+}
+
+TEST(implicit_sharing, External)
+{
+  /* Sharing info that owns the data itself, like data referenced in a memory mapped file. */
+  class ExternalSharingInfo : public ImplicitSharingInfo {
+    bool *deleted_;
+
+   public:
+    ExternalSharingInfo(bool *deleted) : deleted_(deleted)
+    {
+    }
+
+    ~ExternalSharingInfo() override
+    {
+      *deleted_ = true;
+    }
+
+    bool is_external() const override
+    {
+      return true;
+    }
+  };
+
+  bool deleted = false;
+  const ImplicitSharingInfo *info = new ExternalSharingInfo(&deleted);
+  EXPECT_FALSE(info->is_shared());
+  EXPECT_FALSE(info->is_mutable());
+
+  EXPECT_TRUE(info->remove_user());
+  delete info;
+  EXPECT_TRUE(deleted);
+}
+
+}  // namespace blender::tests
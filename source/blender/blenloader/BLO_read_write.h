@@ -29,6 +29,7 @@
 /* for SDNA_TYPE_FROM_STRUCT() macro */
 #include "dna_type_offsets.h"
 
+#include "DNA_customdata_types.h"    /* for ImplicitSharingInfoHandle */
 #include "DNA_windowmanager_types.h" /* for eReportType */
 
 #ifdef __cplusplus
@@ -210,6 +211,16 @@ bool BLO_write_is_undo(BlendWriter *writer);
 
 void *BLO_read_get_new_data_address(BlendDataReader *reader, const void *old_address);
 void *BLO_read_get_new_data_address_no_us(BlendDataReader *reader, const void *old_address);
+/**
+ * Like #BLO_read_get_new_data_address, but large arrays from uncompressed files that need no
+ * conversion may be returned as a pointer into the memory mapped file instead of a copy, so they
+ * are only loaded from disk when accessed. Then \a r_sharing_info is set and keeps the mapping
+ * alive: the data must not be modified or freed, only the sharing info's user is removed.
+ * Otherwise \a r_sharing_info is set to NULL and the caller owns the data as usual.
+ */
+void *BLO_read_get_new_data_address_shared(BlendDataReader *reader,
+                                           const void *old_address,
+                                           const ImplicitSharingInfoHandle **r_sharing_info);
 void *BLO_read_get_new_packed_address(BlendDataReader *reader, const void *old_address);
 
 #define BLO_read_data_address(reader, ptr_p) \
@@ -84,6 +84,8 @@ typedef struct BlendFileReadReport {
     double lib_overrides;
     double lib_overrides_resync;
     double lib_overrides_recursive_resync;
+    /** Converting data of older or other-endian files, part of the whole duration. */
+    double data_conversion;
   } duration;
 
   /* Count information. */
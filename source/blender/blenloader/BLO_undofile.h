@@ -27,6 +27,9 @@ typedef struct {
   /** Session UUID of the ID being currently written (MAIN_ID_SESSION_UUID_UNSET when not writing
    * ID-related data). Used to find matching chunks in previous memundo step. */
   uint id_session_uuid;
+  /** Hash of the ID struct written in this chunk's ID, used to verify that reusing the chunks of
+   * an ID that was not tagged as changed is valid. Zero when not writing ID-related data. */
+  uint id_hash;
 } MemFileChunk;
 
 typedef struct MemFile {
@@ -39,6 +42,7 @@ typedef struct MemFileWriteData {
   MemFile *reference_memfile;
 
   uint current_id_session_uuid;
+  uint current_id_hash;
   MemFileChunk *reference_current_chunk;
 
   /** Maps an ID session uuid to its first reference MemFileChunk, if existing. */
@@ -73,6 +77,16 @@ void BLO_memfile_write_init(MemFileWriteData *mem_data,
 void BLO_memfile_write_finalize(MemFileWriteData *mem_data);
 
 void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t size);
+/**
+ * Add the chunks of an ID from the reference memfile instead of writing the ID again, for IDs
+ * that are known to be unchanged since. Returns false when the reference memfile has no usable
+ * data for the ID, or when its struct hash doesn't match `id_hash` anymore, then it has to be
+ * written as usual.
+ */
+bool BLO_memfile_id_chunks_reuse(MemFileWriteData *mem_data,
+                                 uint id_session_uuid,
+                                 const void *id_address,
+                                 uint id_hash);
 
 /* exports */
 
@@ -50,12 +50,16 @@
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
 #include "BLI_ghash.h"
+#include "BLI_implicit_sharing.hh"
 #include "BLI_linklist.h"
 #include "BLI_map.hh"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
+#include "BLI_task.hh"
 #include "BLI_threads.h"
+#include "BLI_vector.hh"
 
 #include "PIL_time.h"
 
@@ -64,6 +68,7 @@
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
 #include "BKE_asset.h"
+#include "BKE_blender_version.h"
 #include "BKE_collection.h"
 #include "BKE_global.h" /* for G */
 #include "BKE_idprop.h"
@@ -234,6 +239,8 @@ struct NewAddress {
   void *newp;
   /* `nr` is "user count" for data, and ID code for libdata. */
   int nr;
+  /** Size of the data when `newp` points into the memory mapped file, see #FileData.mmap_file. */
+  size_t mapped_size = 0;
 };
 
 struct OldNewMap {
@@ -297,7 +304,7 @@ static void oldnewmap_clear(OldNewMap *onm)
 {
   /* Free unused data. */
   for (NewAddress &new_addr : onm->map.values()) {
-    if (new_addr.nr == 0) {
+    if (new_addr.nr == 0 && new_addr.mapped_size == 0) {
       MEM_freeN(new_addr.newp);
     }
   }
@@ -978,6 +985,14 @@ static bool read_file_dna(FileData *fd, const char **r_error_message)
       fd->filesdna = DNA_sdna_from_data(
           &bhead[1], bhead->len, do_endian_swap, true, r_error_message);
       if (fd->filesdna) {
+        /* Data that versioning may modify in place can't be referenced in the read-only mapping
+         * of the file. */
+        if (fd->fileversion < BLENDER_FILE_VERSION ||
+            (fd->fileversion == BLENDER_FILE_VERSION && subversion < BLENDER_FILE_SUBVERSION) ||
+            (fd->flags & (FD_FLAGS_SWITCH_ENDIAN | FD_FLAGS_POINTSIZE_DIFFERS))) {
+          fd->mmap_file = nullptr;
+        }
+
         blo_do_versions_dna(fd->filesdna, fd->fileversion, subversion);
         fd->compflags = DNA_struct_get_compareflags(fd->filesdna, fd->memsdna);
         fd->reconstruct_info = DNA_reconstruct_info_create(
@@ -1150,6 +1165,11 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   FileData *fd = filedata_new(reports);
   fd->file = file;
+#ifndef WIN32
+  /* Not on Windows, where a file can't be replaced while it is mapped, so keeping the mapping
+   * alive would make saving over the file fail. */
+  fd->mmap_file = BLI_filereader_mmap_file(file);
+#endif
 
   return fd;
 }
@@ -1342,16 +1362,39 @@ BlendThumbnail *BLO_thumbnail_from_file(const char *filepath)
 /** \name Old/New Pointer Map
  * \{ */
 
+/**
+ * Lookup in #FileData.datamap. Data that is still in the memory mapped file is copied first,
+ * since the caller takes ownership of it.
+ */
+static void *datamap_lookup_and_inc(FileData *fd, const void *adr, bool increase_users)
+{
+  NewAddress *entry = fd->datamap->map.lookup_ptr(adr);
+  if (entry != nullptr && entry->mapped_size != 0) {
+    void *data = MEM_mallocN(entry->mapped_size, "mapped data");
+    const size_t offset = size_t(static_cast<const char *>(entry->newp) -
+                                 static_cast<const char *>(BLI_mmap_get_pointer(fd->mmap_file)));
+    if (UNLIKELY(!BLI_mmap_read(fd->mmap_file, data, offset, entry->mapped_size))) {
+      fd->flags &= ~FD_FLAGS_FILE_OK;
+      MEM_freeN(data);
+      fd->datamap->map.remove(adr);
+      return nullptr;
+    }
+    entry->newp = data;
+    entry->mapped_size = 0;
+  }
+  return oldnewmap_lookup_and_inc(fd->datamap, adr, increase_users);
+}
+
 /* Only direct data-blocks. */
 static void *newdataadr(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return datamap_lookup_and_inc(fd, adr, true);
 }
 
 /* Only direct data-blocks. */
 static void *newdataadr_no_us(FileData *fd, const void *adr)
 {
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, false);
+  return datamap_lookup_and_inc(fd, adr, false);
 }
 
 void *blo_read_get_new_globaldata_address(FileData *fd, const void *adr)
@@ -1366,7 +1409,7 @@ static void *newpackedadr(FileData *fd, const void *adr)
     return oldnewmap_lookup_and_inc(fd->packedmap, adr, true);
   }
 
-  return oldnewmap_lookup_and_inc(fd->datamap, adr, true);
+  return datamap_lookup_and_inc(fd, adr, true);
 }
 
 /* only lib data */
@@ -1775,6 +1818,50 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
   return temp;
 }
 
+/**
+ * True when the data of the block has to be converted to the current DNA, by switching endian
+ * or reconstructing the structs. That is the expensive part of reading, which
+ * #read_data_into_datamap does on multiple threads once the data of the block is in memory.
+ */
+static bool read_struct_needs_conversion(const FileData *fd, const BHead *bh)
+{
+  if (bh->len == 0 || fd->compflags[bh->SDNAnr] == SDNA_CMP_REMOVED) {
+    return false;
+  }
+  return (bh->SDNAnr && (fd->flags & FD_FLAGS_SWITCH_ENDIAN)) ||
+         fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL;
+}
+
+#ifdef USE_BHEAD_READ_ON_DEMAND
+/**
+ * Minimum size of a block for its data to be referenced in the memory mapped file. Smaller
+ * blocks share their pages with other data, so referencing them saves little.
+ */
+#  define READ_DATA_MAPPED_MIN_SIZE (1 << 16)
+
+/**
+ * The data of the block in the memory mapped file, for blocks that can be used as is and are
+ * large enough to be worth referencing instead of copying. Only data that is read with
+ * #BLO_read_get_new_data_address_shared stays in the mapping, other readers get a copy.
+ */
+static void *read_struct_mapped(const FileData *fd, const BHead *bh)
+{
+  if (fd->mmap_file == nullptr || bh->len < READ_DATA_MAPPED_MIN_SIZE ||
+      fd->compflags[bh->SDNAnr] != SDNA_CMP_EQUAL) {
+    return nullptr;
+  }
+  const BHeadN *bhead_n = BHEADN_FROM_BHEAD(bh);
+  if (bhead_n->has_data) {
+    return nullptr;
+  }
+  const size_t offset = size_t(bhead_n->file_offset);
+  if (offset % 4 != 0 || offset + size_t(bh->len) > BLI_mmap_get_length(fd->mmap_file)) {
+    return nullptr;
+  }
+  return POINTER_OFFSET(BLI_mmap_get_pointer(fd->mmap_file), offset);
+}
+#endif
+
 /* Like read_struct, but gets a pointer without allocating. Only works for
  * undo since DNA must match. */
 static const void *peek_struct_undo(FileData *fd, BHead *bhead)
@@ -2962,9 +3049,30 @@ static bool direct_link_id(FileData *fd, Main *main, const int tag, ID *id, ID *
   return success;
 }
 
+/**
+ * Minimum size of the data that needs conversion for #read_data_into_datamap to convert the
+ * blocks on multiple threads. Below that the overhead of the threading is not worth it. Larger
+ * blocks are split into ranges of about this size.
+ */
+#define READ_DATA_PARALLEL_MIN_SIZE (1 << 16)
+
 /* Read all data associated with a datablock into datamap. */
 static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *allocname)
 {
+  using namespace blender;
+
+  struct DataBlock {
+    BHead *bhead = nullptr;
+    /** The block with its data in memory, when it still has to be converted. */
+    BHead *data_bhead = nullptr;
+    const char *allocname = nullptr;
+    void *data = nullptr;
+    /** Size of the data when it points into the memory mapped file. */
+    size_t mapped_size = 0;
+  };
+  Vector<DataBlock> blocks;
+  size_t convert_size = 0;
+
   bhead = blo_bhead_next(fd, bhead);
 
   while (bhead && bhead->code == DATA) {
@@ -2988,14 +3096,139 @@ static BHead *read_data_into_datamap(FileData *fd, BHead *bhead, const char *all
     }
 #endif
 
-    void *data = read_struct(fd, bhead, allocname);
-    if (data) {
-      oldnewmap_insert(fd->datamap, bhead->old, data, 0);
+    DataBlock block;
+    block.bhead = bhead;
+    block.allocname = allocname;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    block.data = read_struct_mapped(fd, bhead);
+    if (block.data) {
+      /* Not read at all until it is accessed. */
+      block.mapped_size = size_t(bhead->len);
+      blocks.append(block);
+      bhead = blo_bhead_next(fd, bhead);
+      continue;
     }
+#endif
+    if (read_struct_needs_conversion(fd, bhead)) {
+      /* Only read the data here, the conversion is done for all blocks at once below. */
+      block.data_bhead = bhead;
+#ifdef USE_BHEAD_READ_ON_DEMAND
+      if (BHEADN_FROM_BHEAD(bhead)->has_data == false) {
+        block.data_bhead = blo_bhead_read_full(fd, bhead);
+        if (UNLIKELY(block.data_bhead == nullptr)) {
+          fd->flags &= ~FD_FLAGS_FILE_OK;
+        }
+      }
+#endif
+      if (block.data_bhead) {
+        convert_size += size_t(bhead->len);
+      }
+    }
+    else {
+      block.data = read_struct(fd, bhead, allocname);
+    }
+    blocks.append(block);
 
     bhead = blo_bhead_next(fd, bhead);
   }
 
+  /* Converting old or other-endian files is the bulk of the time spent reading them. The blocks do
+   * not depend on each other and neither do the elements of a block, so large blocks (e.g. mesh
+   * data of old files) are split into ranges of elements that are converted in parallel. */
+  if (convert_size != 0) {
+    const double t_start = PIL_check_seconds_timer();
+    const bool switch_endian = (fd->flags & FD_FLAGS_SWITCH_ENDIAN) != 0;
+
+    struct ConvertRange {
+      DataBlock *block;
+      IndexRange elements;
+    };
+    Vector<ConvertRange> ranges;
+    for (DataBlock &block : blocks) {
+      BHead *bh = block.data_bhead;
+      if (bh == nullptr) {
+        continue;
+      }
+      /* Allocate the result here, so the ranges can be written to it independently. */
+      if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        const int new_size = DNA_struct_reconstruct_size(fd->reconstruct_info, bh->SDNAnr);
+        if (new_size == 0) {
+          continue;
+        }
+        block.data = MEM_callocN(size_t(bh->nr) * size_t(new_size), "reconstruct");
+      }
+      else {
+        block.data = MEM_mallocN(bh->len, block.allocname);
+      }
+      const int old_size = fd->filesdna->types_size[fd->filesdna->structs[bh->SDNAnr]->type];
+      const int64_t range_size = std::max<int64_t>(1, READ_DATA_PARALLEL_MIN_SIZE / old_size);
+      for (int64_t start = 0; start < bh->nr; start += range_size) {
+        ranges.append({&block, IndexRange(start, std::min<int64_t>(range_size, bh->nr - start))});
+      }
+    }
+
+    auto convert_range = [&](const ConvertRange &range) {
+      BHead *bh = range.block->data_bhead;
+      const int old_size = fd->filesdna->types_size[fd->filesdna->structs[bh->SDNAnr]->type];
+      char *old_data = (char *)(bh + 1) + range.elements.start() * old_size;
+      if (bh->SDNAnr && switch_endian) {
+        for (const int64_t i : IndexRange(range.elements.size())) {
+          DNA_struct_switch_endian(fd->filesdna, bh->SDNAnr, old_data + i * old_size);
+        }
+      }
+      if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        const int new_size = DNA_struct_reconstruct_size(fd->reconstruct_info, bh->SDNAnr);
+        DNA_struct_reconstruct_into(fd->reconstruct_info,
+                                    bh->SDNAnr,
+                                    int(range.elements.size()),
+                                    old_data,
+                                    (char *)range.block->data +
+                                        range.elements.start() * new_size);
+      }
+      else {
+        /* The last range also copies any data after the last complete element. */
+        const int64_t end = range.elements.one_after_last() == bh->nr ?
+                                bh->len :
+                                range.elements.one_after_last() * old_size;
+        memcpy((char *)range.block->data + range.elements.start() * old_size,
+               old_data,
+               size_t(end - range.elements.start() * old_size));
+      }
+    };
+    if (convert_size >= READ_DATA_PARALLEL_MIN_SIZE) {
+      threading::parallel_for(ranges.index_range(), 1, [&](const IndexRange range) {
+        for (const ConvertRange &convert : ranges.as_span().slice(range)) {
+          convert_range(convert);
+        }
+      });
+    }
+    else {
+      for (const ConvertRange &convert : ranges) {
+        convert_range(convert);
+      }
+    }
+
+    if (fd->reports) {
+      fd->reports->duration.data_conversion += PIL_check_seconds_timer() - t_start;
+    }
+  }
+
+  /* Insert in file order, for the same result as reading the blocks one by one. */
+  for (DataBlock &block : blocks) {
+    if (block.mapped_size != 0) {
+      fd->datamap->map.add_overwrite(block.bhead->old,
+                                     NewAddress{block.data, 0, block.mapped_size});
+    }
+    else if (block.data) {
+      oldnewmap_insert(fd->datamap, block.bhead->old, block.data, 0);
+    }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+    if (!ELEM(block.data_bhead, nullptr, block.bhead)) {
+      MEM_freeN(BHEADN_FROM_BHEAD(block.data_bhead));
+    }
+#endif
+  }
+
   return bhead;
 }
 
@@ -4995,6 +5228,46 @@ void *BLO_read_get_new_data_address(BlendDataReader *reader, const void *old_add
   return newdataadr(reader->fd, old_address);
 }
 
+/**
+ * Keeps the memory mapped file alive for data that is referenced in it directly.
+ */
+class MappedFileSharingInfo : public blender::ImplicitSharingInfo {
+ private:
+  BLI_mmap_file *mmap_file_;
+
+ public:
+  MappedFileSharingInfo(BLI_mmap_file *mmap_file) : mmap_file_(mmap_file)
+  {
+    BLI_mmap_user_add(mmap_file_);
+  }
+
+  ~MappedFileSharingInfo() override
+  {
+    BLI_mmap_free(mmap_file_);
+  }
+
+  bool is_external() const override
+  {
+    return true;
+  }
+};
+
+void *BLO_read_get_new_data_address_shared(BlendDataReader *reader,
+                                           const void *old_address,
+                                           const ImplicitSharingInfoHandle **r_sharing_info)
+{
+  FileData *fd = reader->fd;
+  *r_sharing_info = nullptr;
+
+  NewAddress *entry = fd->datamap->map.lookup_ptr(old_address);
+  if (entry != nullptr && entry->mapped_size != 0) {
+    entry->nr++;
+    *r_sharing_info = new MappedFileSharingInfo(fd->mmap_file);
+    return entry->newp;
+  }
+  return newdataadr(fd, old_address);
+}
+
 void *BLO_read_get_new_data_address_no_us(BlendDataReader *reader, const void *old_address)
 {
   return newdataadr_no_us(reader->fd, old_address);
@@ -92,6 +92,12 @@ typedef struct FileData {
    */
   int id_tag_extra;
 
+  /**
+   * Mapping of the file when it is read with memory mapped IO and its data can be referenced in
+   * the mapping directly, see #BLO_read_get_new_data_address_shared. Owned by #file.
+   */
+  struct BLI_mmap_file *mmap_file;
+
   struct OldNewMap *datamap;
   struct OldNewMap *globmap;
   struct OldNewMap *libmap;
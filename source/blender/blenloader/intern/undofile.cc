@@ -22,6 +22,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "DNA_listBase.h"
+#include "DNA_sdna_types.h"
 
 #include "BLI_blenlib.h"
 #include "BLI_ghash.h"
@@ -154,6 +155,7 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
    * will then not be undo. Though it's not entirely clear that is wrong behavior. */
   curchunk->is_identical_future = true;
   curchunk->id_session_uuid = mem_data->current_id_session_uuid;
+  curchunk->id_hash = mem_data->current_id_hash;
   BLI_addtail(&memfile->chunks, curchunk);
 
   /* we compare compchunk with buf */
@@ -178,6 +180,50 @@ void BLO_memfile_chunk_add(MemFileWriteData *mem_data, const char *buf, size_t s
   }
 }
 
+bool BLO_memfile_id_chunks_reuse(MemFileWriteData *mem_data,
+                                 const uint id_session_uuid,
+                                 const void *id_address,
+                                 const uint id_hash)
+{
+  if (mem_data->id_session_uuid_mapping == nullptr) {
+    return false;
+  }
+  MemFileChunk *refchunk = static_cast<MemFileChunk *>(BLI_ghash_lookup(
+      mem_data->id_session_uuid_mapping, POINTER_FROM_UINT(id_session_uuid)));
+  if (refchunk == nullptr) {
+    return false;
+  }
+  /* The data of an ID starts with the #BHead of the ID itself. If the ID moved to another address
+   * since, the pointers to it in other IDs written now would not match the stored data anymore. */
+  if (refchunk->size < sizeof(BHead) ||
+      reinterpret_cast<const BHead *>(refchunk->buf)->old != id_address) {
+    return false;
+  }
+  /* Catches changes to the ID struct itself that were not tagged. */
+  if (refchunk->id_hash != id_hash) {
+    return false;
+  }
+
+  MemFile *memfile = mem_data->written_memfile;
+  for (; refchunk != nullptr && refchunk->id_session_uuid == id_session_uuid;
+       refchunk = static_cast<MemFileChunk *>(refchunk->next)) {
+    MemFileChunk *curchunk = static_cast<MemFileChunk *>(
+        MEM_mallocN(sizeof(MemFileChunk), "MemFileChunk"));
+    curchunk->size = refchunk->size;
+    curchunk->buf = refchunk->buf;
+    curchunk->is_identical = true;
+    curchunk->is_identical_future = true;
+    curchunk->id_session_uuid = id_session_uuid;
+    curchunk->id_hash = id_hash;
+    BLI_addtail(&memfile->chunks, curchunk);
+
+    refchunk->is_identical_future = true;
+  }
+  mem_data->reference_current_chunk = refchunk;
+
+  return true;
+}
+
 struct Main *BLO_memfile_main_get(struct MemFile *memfile,
                                   struct Main *bmain,
                                   struct Scene **r_scene)
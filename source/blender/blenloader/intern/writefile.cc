@@ -87,10 +87,13 @@
 #include "BLI_blenlib.h"
 #include "BLI_endian_defines.h"
 #include "BLI_endian_switch.h"
+#include "BLI_ghash.h"
+#include "BLI_hash_mm2a.h"
 #include "BLI_link_utils.h"
 #include "BLI_linklist.h"
 #include "BLI_math_base.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
 #include "BLI_threads.h"
 #include "MEM_guardedalloc.h" /* MEM_freeN */
 
@@ -649,6 +652,7 @@ static void mywrite_id_end(WriteData *wd, ID * /*id*/)
      * specific ID changed or not. */
     mywrite_flush(wd);
     wd->mem.current_id_session_uuid = MAIN_ID_SESSION_UUID_UNSET;
+    wd->mem.current_id_hash = 0;
   }
 }
 
@@ -1112,7 +1116,122 @@ static int write_id_direct_linked_data_process_cb(LibraryIDLinkCallbackData *cb_
   return IDWALK_RET_NOP;
 }
 
+/**
+ * Copy the ID struct into `id_buffer`, with the runtime data cleared that is not written, or that
+ * would cause a lot of false detections of changed data between undo steps.
+ */
+static void write_id_buffer_init(const WriteData *wd,
+                                 const ID *id,
+                                 void *id_buffer,
+                                 const size_t idtype_struct_size)
+{
+  memcpy(id_buffer, id, idtype_struct_size);
+
+  /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
+  if (wd->use_memfile) {
+    ((ID *)id_buffer)->tag &= LIB_TAG_KEEP_ON_UNDO;
+  }
+  else {
+    ((ID *)id_buffer)->tag = 0;
+  }
+  ((ID *)id_buffer)->us = 0;
+  ((ID *)id_buffer)->icon_id = 0;
+  /* Those listbase data change every time we add/remove an ID, and also often when
+   * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
+   * detections between undo steps. */
+  ((ID *)id_buffer)->prev = nullptr;
+  ((ID *)id_buffer)->next = nullptr;
+  /* Those runtime pointers should never be set during writing stage, but just in case clear
+   * them too. */
+  ((ID *)id_buffer)->orig_id = nullptr;
+  ((ID *)id_buffer)->newid = nullptr;
+  /* Even though in theory we could be able to preserve this python instance across undo even
+   * when we need to re-read the ID into its original address, this is currently cleared in
+   * #direct_link_id_common in `readfile.c` anyway, */
+  ((ID *)id_buffer)->py_instance = nullptr;
+}
+
+/**
+ * Hash of an ID struct prepared by #write_id_buffer_init(), stored with the undo data of the ID.
+ * Update tags are left out, they are expected to differ while the ID is unchanged. Data the ID
+ * owns in other allocations (e.g. mesh attributes) is not hashed, that would cost as much as
+ * writing it again.
+ */
+static uint write_id_struct_hash(const void *id_buffer, const size_t idtype_struct_size)
+{
+  ID id_header = *static_cast<const ID *>(id_buffer);
+  id_header.recalc = 0;
+  id_header.recalc_up_to_undo_push = 0;
+  id_header.recalc_after_undo_push = 0;
+  memset(&id_header.runtime, 0, sizeof(id_header.runtime));
+  const uint hash = BLI_hash_mm2(reinterpret_cast<const uchar *>(&id_header), sizeof(ID), 0);
+  return BLI_hash_mm2(static_cast<const uchar *>(id_buffer) + sizeof(ID),
+                      idtype_struct_size - sizeof(ID),
+                      hash);
+}
+
+struct WriteIDLinksResolveData {
+  GSet *id_addresses;
+  bool resolved;
+};
+
+static int write_id_links_resolve_cb(LibraryIDLinkCallbackData *cb_data)
+{
+  WriteIDLinksResolveData *data = static_cast<WriteIDLinksResolveData *>(cb_data->user_data);
+  ID *id = *cb_data->id_pointer;
+  /* Embedded IDs are written as part of their owner. */
+  if (id == nullptr || (cb_data->cb_flag & IDWALK_CB_EMBEDDED) != 0) {
+    return IDWALK_RET_NOP;
+  }
+  if (!BLI_gset_haskey(data->id_addresses, id)) {
+    data->resolved = false;
+    return IDWALK_RET_STOP_ITER;
+  }
+  return IDWALK_RET_NOP;
+}
+
+/**
+ * Whether all IDs used by `id` are still in Main, so that the pointers to them stored in its
+ * previous undo data are restored when reading it.
+ */
+static bool write_id_links_resolve(Main *bmain, ID *id, GSet *id_addresses)
+{
+  WriteIDLinksResolveData data = {id_addresses, true};
+  BKE_library_foreach_ID_link(bmain, id, write_id_links_resolve_cb, &data, IDWALK_READONLY);
+  return data.resolved;
+}
+
 /* if MemFile * there's filesave to memory */
+static bool write_id_changed_since_undo_push(const ID *id)
+{
+  return id->recalc_after_undo_push != 0 || (id->tag & LIB_TAG_UNDO_CHANGED) != 0;
+}
+
+/**
+ * Whether the ID is known to be unchanged since the last undo push, so its data stored in that
+ * undo step can be reused. Changes are known from the depsgraph tags accumulated in
+ * `recalc_after_undo_push`, and from #LIB_TAG_UNDO_CHANGED for changes made through RNA and
+ * Python that don't need a depsgraph update. Only IDs that are handled by copy-on-write are
+ * considered, as edits to other types are often not tagged at all. Scenes are excluded as they
+ * also hold tool and UI state that is changed without tagging. When other undo systems (e.g.
+ * sculpt mode) changed data, nothing is reused, see #Main.is_memfile_undo_reusable.
+ */
+static bool write_id_is_unchanged_since_undo_push(const ID *id)
+{
+  const ID_Type id_type = GS(id->name);
+  if (!ID_TYPE_IS_COW(id_type) || id_type == ID_SCE) {
+    return false;
+  }
+  if (write_id_changed_since_undo_push(id)) {
+    return false;
+  }
+  const bNodeTree *nodetree = ntreeFromID(const_cast<ID *>(id));
+  if (nodetree != nullptr && write_id_changed_since_undo_push(&nodetree->id)) {
+    return false;
+  }
+  return true;
+}
+
 static bool write_file_handle(Main *mainvar,
                               WriteWrap *ww,
                               MemFile *compare,
@@ -1183,6 +1302,21 @@ static bool write_file_handle(Main *mainvar,
                                                  nullptr :
                                                  BKE_lib_override_library_operations_store_init();
 
+  /* Skip writing IDs that did not change since the last undo step, see
+   * #Main.is_memfile_undo_reusable. */
+  const bool use_unchanged_id_reuse = wd->use_memfile && compare != nullptr &&
+                                      mainvar->is_memfile_undo_reusable &&
+                                      !mainvar->use_memfile_full_barrier;
+  GSet *id_addresses = nullptr;
+  if (use_unchanged_id_reuse) {
+    id_addresses = BLI_gset_ptr_new(__func__);
+    ID *id_iter;
+    FOREACH_MAIN_ID_BEGIN (mainvar, id_iter) {
+      BLI_gset_add(id_addresses, id_iter);
+    }
+    FOREACH_MAIN_ID_END;
+  }
+
 #define ID_BUFFER_STATIC_SIZE 8192
   /* This outer loop allows to save first data-blocks from real mainvar,
    * then the temp ones from override process,
@@ -1245,17 +1379,22 @@ static bool write_file_handle(Main *mainvar,
           BKE_lib_override_library_operations_store_start(bmain, override_storage, id);
         }
 
+        const bool is_unchanged_since_undo_push = use_unchanged_id_reuse &&
+                                                  write_id_is_unchanged_since_undo_push(id);
+
         if (wd->use_memfile) {
           /* Record the changes that happened up to this undo push in
            * recalc_up_to_undo_push, and clear `recalc_after_undo_push` again
            * to start accumulating for the next undo push. */
           id->recalc_up_to_undo_push = id->recalc_after_undo_push;
           id->recalc_after_undo_push = 0;
+          id->tag &= ~LIB_TAG_UNDO_CHANGED;
 
           bNodeTree *nodetree = ntreeFromID(id);
           if (nodetree != nullptr) {
             nodetree->id.recalc_up_to_undo_push = nodetree->id.recalc_after_undo_push;
             nodetree->id.recalc_after_undo_push = 0;
+            nodetree->id.tag &= ~LIB_TAG_UNDO_CHANGED;
           }
           if (GS(id->name) == ID_SCE) {
             Scene *scene = (Scene *)id;
@@ -1267,32 +1406,19 @@ static bool write_file_handle(Main *mainvar,
           }
         }
 
-        mywrite_id_begin(wd, id);
-
-        memcpy(id_buffer, id, idtype_struct_size);
+        write_id_buffer_init(wd, id, id_buffer, idtype_struct_size);
+        const uint id_hash = wd->use_memfile ?
+                                 write_id_struct_hash(id_buffer, idtype_struct_size) :
+                                 0;
 
-        /* Clear runtime data to reduce false detection of changed data in undo/redo context. */
-        if (wd->use_memfile) {
-          ((ID *)id_buffer)->tag &= LIB_TAG_KEEP_ON_UNDO;
-        }
-        else {
-          ((ID *)id_buffer)->tag = 0;
+        /* The tags can miss changes, the hash and the used IDs are checked as well. */
+        if (is_unchanged_since_undo_push && write_id_links_resolve(bmain, id, id_addresses) &&
+            BLO_memfile_id_chunks_reuse(&wd->mem, id->session_uuid, id, id_hash)) {
+          continue;
         }
-        ((ID *)id_buffer)->us = 0;
-        ((ID *)id_buffer)->icon_id = 0;
-        /* Those listbase data change every time we add/remove an ID, and also often when
-         * renaming one (due to re-sorting). This avoids generating a lot of false 'is changed'
-         * detections between undo steps. */
-        ((ID *)id_buffer)->prev = nullptr;
-        ((ID *)id_buffer)->next = nullptr;
-        /* Those runtime pointers should never be set during writing stage, but just in case clear
-         * them too. */
-        ((ID *)id_buffer)->orig_id = nullptr;
-        ((ID *)id_buffer)->newid = nullptr;
-        /* Even though in theory we could be able to preserve this python instance across undo even
-         * when we need to re-read the ID into its original address, this is currently cleared in
-         * #direct_link_id_common in `readfile.c` anyway, */
-        ((ID *)id_buffer)->py_instance = nullptr;
+
+        mywrite_id_begin(wd, id);
+        wd->mem.current_id_hash = id_hash;
 
         if (id_type->blend_write != nullptr) {
           id_type->blend_write(&writer, (ID *)id_buffer, id);
@@ -1313,6 +1439,10 @@ static bool write_file_handle(Main *mainvar,
     }
   } while ((bmain != override_storage) && (bmain = override_storage));
 
+  if (id_addresses != nullptr) {
+    BLI_gset_free(id_addresses, nullptr);
+  }
+
   if (override_storage) {
     BKE_lib_override_library_operations_store_finalize(override_storage);
     override_storage = nullptr;
@@ -1422,6 +1552,16 @@ bool BLO_write_file(Main *mainvar,
     BLO_main_validate_shapekeys(mainvar, reports);
   }
 
+  /* Mesh data may still reference the memory mapped file it was read from. If that file could not
+   * be read anymore (e.g. it was truncated on disk), the data reads as zeroes, don't save that. */
+  if (BLI_mmap_any_io_error()) {
+    BKE_report(reports,
+               RPT_ERROR,
+               "Cannot save, data of an opened file could not be read from disk anymore (was it "
+               "modified or truncated?)");
+    return false;
+  }
+
   /* open temporary file, so we preserve the original in case we crash */
   BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
 
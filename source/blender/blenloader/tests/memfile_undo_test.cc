@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+#include "blendfile_loading_base_test.h"
+
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLI_listbase.h"
+
+#include "BLO_undofile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_ID.h"
+#include "DNA_mesh_types.h"
+
+class MemfileUndoTest : public BlendfileLoadingBaseTest {
+};
+
+/* True when the memfile has chunks for the ID and they are all shared with the reference. */
+static bool memfile_id_is_identical(const MemFile &memfile, const ID &id)
+{
+  bool found = false;
+  LISTBASE_FOREACH (const MemFileChunk *, chunk, &memfile.chunks) {
+    if (chunk->id_session_uuid != id.session_uuid) {
+      continue;
+    }
+    found = true;
+    if (!chunk->is_identical) {
+      return false;
+    }
+  }
+  return found;
+}
+
+TEST_F(MemfileUndoTest, ReuseUnchangedIDs)
+{
+  Main *bmain = BKE_main_new();
+  Mesh *mesh = BKE_mesh_add(bmain, "Mesh");
+  Mesh *mesh_tagged = BKE_mesh_add(bmain, "Tagged");
+  Mesh *mesh_untagged = BKE_mesh_add(bmain, "Untagged");
+
+  MemFile first{};
+  MemFile second{};
+  MemFile third{};
+  ASSERT_TRUE(BLO_write_file_mem(bmain, nullptr, &first, 0));
+
+  /* Unchanged IDs are reused, changed ones are written again whether they are tagged or not. */
+  bmain->is_memfile_undo_reusable = true;
+  mesh_tagged->remesh_voxel_size = 0.5f;
+  mesh_tagged->id.tag |= LIB_TAG_UNDO_CHANGED;
+  mesh_untagged->remesh_voxel_size = 0.5f;
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &first, &second, 0));
+  EXPECT_TRUE(memfile_id_is_identical(second, mesh->id));
+  EXPECT_FALSE(memfile_id_is_identical(second, mesh_tagged->id));
+  EXPECT_FALSE(memfile_id_is_identical(second, mesh_untagged->id));
+  EXPECT_EQ(mesh_tagged->id.tag & LIB_TAG_UNDO_CHANGED, 0);
+
+  /* Without reuse, every ID is written and compared again. */
+  bmain->is_memfile_undo_reusable = false;
+  ASSERT_TRUE(BLO_write_file_mem(bmain, &second, &third, 0));
+  EXPECT_TRUE(memfile_id_is_identical(third, mesh->id));
+  EXPECT_TRUE(memfile_id_is_identical(third, mesh_tagged->id));
+  EXPECT_TRUE(memfile_id_is_identical(third, mesh_untagged->id));
+
+  BLO_memfile_free(&third);
+  BLO_memfile_free(&second);
+  BLO_memfile_free(&first);
+  BKE_main_free(bmain);
+}
@@ -0,0 +1,207 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+#include "testing/testing.h"
+
+#include <array>
+#include <cstring>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_rand.hh"
+#include "BLI_string.h"
+#include "BLI_vector.hh"
+
+#include "DNA_genfile.h"
+#include "DNA_sdna_types.h"
+
+namespace blender::blenloader::tests {
+
+struct TestStruct {
+  const char *type;
+  /** Pairs of type and name indices. */
+  Vector<short> members;
+};
+
+/** Encodes SDNA data the same way `makesdna` does. */
+static SDNA *sdna_from_description(const Span<const char *> names,
+                                   const Span<const char *> types,
+                                   const Span<short> types_size,
+                                   const Span<TestStruct> structs)
+{
+  Vector<char> data;
+  auto append_int = [&](const int value) {
+    data.extend(Span<char>((const char *)&value, sizeof(value)));
+  };
+  auto append_short = [&](const short value) {
+    data.extend(Span<char>((const char *)&value, sizeof(value)));
+  };
+  auto append_strings = [&](const Span<const char *> strings) {
+    append_int(int(strings.size()));
+    for (const char *str : strings) {
+      data.extend(Span<char>(str, int64_t(strlen(str)) + 1));
+    }
+    while (data.size() % 4) {
+      data.append(0);
+    }
+  };
+
+  data.extend(Span<char>("SDNANAME", 8));
+  append_strings(names);
+  data.extend(Span<char>("TYPE", 4));
+  append_strings(types);
+  data.extend(Span<char>("TLEN", 4));
+  for (const short size : types_size) {
+    append_short(size);
+  }
+  if (types_size.size() & 1) {
+    append_short(0);
+  }
+  data.extend(Span<char>("STRC", 4));
+  append_int(int(structs.size()));
+  for (const TestStruct &test_struct : structs) {
+    for (const int type : types.index_range()) {
+      if (STREQ(types[type], test_struct.type)) {
+        append_short(short(type));
+      }
+    }
+    append_short(short(test_struct.members.size() / 2));
+    for (const short value : test_struct.members) {
+      append_short(value);
+    }
+  }
+  return DNA_sdna_from_data(data.data(), int(data.size()), false, true, nullptr);
+}
+
+/* Names and types shared by both versions, type indices follow #eSDNA_Type. */
+static const std::array test_names{"*first", "*last", "a", "b", "c[3]", "c[4]", "d", "t[2]", "x"};
+enum { FIRST, LAST, A, B, C3, C4, D, T2, X };
+static const std::array test_types{"char",
+                                   "uchar",
+                                   "short",
+                                   "ushort",
+                                   "int",
+                                   "long",
+                                   "ulong",
+                                   "float",
+                                   "double",
+                                   "void",
+                                   "int64_t",
+                                   "uint64_t",
+                                   "int8_t",
+                                   "ListBase",
+                                   "Thing",
+                                   "Outer"};
+
+/**
+ * Old version: `Thing {float a; int b; short c[3]; char d;}` (15 bytes) and
+ * `Outer {int x; Thing t[2];}` (34 bytes).
+ */
+static SDNA *old_sdna_create()
+{
+  const Vector<short> types_size = {1, 1, 2, 2, 4, 4, 4, 4, 8, 0, 8, 8, 1, 16, 15, 34};
+  const Vector<TestStruct> structs = {
+      {"ListBase", {SDNA_TYPE_VOID, FIRST, SDNA_TYPE_VOID, LAST}},
+      {"Thing", {SDNA_TYPE_FLOAT, A, SDNA_TYPE_INT, B, SDNA_TYPE_SHORT, C3, SDNA_TYPE_CHAR, D}},
+      {"Outer", {SDNA_TYPE_INT, X, 14, T2}},
+  };
+  return sdna_from_description(test_names, test_types, types_size, structs);
+}
+
+/**
+ * New version: `Thing {int b; short c[4]; double a;}` (20 bytes, `d` was removed) and
+ * `Outer {Thing t[2]; int x;}` (44 bytes).
+ */
+static SDNA *new_sdna_create()
+{
+  const Vector<short> types_size = {1, 1, 2, 2, 4, 4, 4, 4, 8, 0, 8, 8, 1, 16, 20, 44};
+  const Vector<TestStruct> structs = {
+      {"ListBase", {SDNA_TYPE_VOID, FIRST, SDNA_TYPE_VOID, LAST}},
+      {"Thing", {SDNA_TYPE_INT, B, SDNA_TYPE_SHORT, C4, SDNA_TYPE_DOUBLE, A}},
+      {"Outer", {14, T2, SDNA_TYPE_INT, X}},
+  };
+  return sdna_from_description(test_names, test_types, types_size, structs);
+}
+
+/**
+ * Converting an array in ranges with #DNA_struct_reconstruct_into, as the file reading does for
+ * large data blocks, gives the same result as converting it at once with #DNA_struct_reconstruct.
+ */
+TEST(struct_reconstruct, ranges_match_whole_array)
+{
+  SDNA *oldsdna = old_sdna_create();
+  SDNA *newsdna = new_sdna_create();
+  ASSERT_NE(oldsdna, nullptr);
+  ASSERT_NE(newsdna, nullptr);
+  const char *compare_flags = DNA_struct_get_compareflags(oldsdna, newsdna);
+  DNA_ReconstructInfo *reconstruct_info = DNA_reconstruct_info_create(
+      oldsdna, newsdna, compare_flags);
+
+  RandomNumberGenerator rng(42);
+  const int elements_num = 1000;
+  for (const char *type : {"Thing", "Outer"}) {
+    const bool is_thing = STREQ(type, "Thing");
+    const int old_struct_nr = DNA_struct_find_nr(oldsdna, type);
+    ASSERT_EQ(compare_flags[old_struct_nr], SDNA_CMP_NOT_EQUAL);
+    const int old_size = oldsdna->types_size[oldsdna->structs[old_struct_nr]->type];
+    const int new_size = DNA_struct_reconstruct_size(reconstruct_info, old_struct_nr);
+    ASSERT_EQ(new_size, is_thing ? 20 : 44);
+
+    /* Random bytes, except for the floats that have to stay finite to compare the conversion. */
+    Vector<char> old_data(old_size * elements_num);
+    for (char &value : old_data) {
+      value = char(rng.get_int32(256));
+    }
+    for (const int i : IndexRange(elements_num)) {
+      const float a = float(rng.get_double());
+      if (is_thing) {
+        memcpy(&old_data[i * old_size], &a, sizeof(a));
+      }
+      else {
+        memcpy(&old_data[i * old_size + 4], &a, sizeof(a));
+        memcpy(&old_data[i * old_size + 4 + 15], &a, sizeof(a));
+      }
+    }
+
+    char *whole = (char *)DNA_struct_reconstruct(
+        reconstruct_info, old_struct_nr, elements_num, old_data.data());
+    ASSERT_NE(whole, nullptr);
+
+    /* Ranges of different sizes, including single elements. */
+    char *ranges = (char *)MEM_callocN(size_t(new_size) * elements_num, __func__);
+    int start = 0;
+    for (int range_size = 1; start < elements_num; range_size = range_size * 3 + 1) {
+      const int size = std::min(range_size, elements_num - start);
+      DNA_struct_reconstruct_into(reconstruct_info,
+                                  old_struct_nr,
+                                  size,
+                                  &old_data[start * old_size],
+                                  ranges + start * new_size);
+      start += size;
+    }
+    EXPECT_EQ(memcmp(whole, ranges, size_t(new_size) * elements_num), 0);
+
+    /* Check one converted element, to make sure the comparison isn't between two empty arrays. */
+    if (is_thing) {
+      const char *old_element = &old_data[(elements_num - 1) * old_size];
+      const char *new_element = &ranges[(elements_num - 1) * new_size];
+      float old_a;
+      double new_a;
+      memcpy(&old_a, old_element, sizeof(old_a));
+      memcpy(&new_a, new_element + 12, sizeof(new_a));
+      EXPECT_EQ(double(old_a), new_a);
+      /* `b` and the first three elements of `c` are copied, the fourth element is zeroed. */
+      EXPECT_EQ(memcmp(new_element, old_element + 4, 10), 0);
+      EXPECT_EQ(new_element[10], 0);
+      EXPECT_EQ(new_element[11], 0);
+    }
+
+    MEM_freeN(whole);
+    MEM_freeN(ranges);
+  }
+
+  DNA_reconstruct_info_free(reconstruct_info);
+  MEM_freeN((void *)compare_flags);
+  DNA_sdna_free(newsdna);
+  DNA_sdna_free(oldsdna);
+}
+
+}  // namespace blender::blenloader::tests
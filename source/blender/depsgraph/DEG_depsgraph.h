@@ -217,6 +217,13 @@ void DEG_editors_set_update_cb(DEG_EditorUpdateIDCb id_func, DEG_EditorUpdateSce
 
 bool DEG_is_evaluating(const struct Depsgraph *depsgraph);
 
+/**
+ * Value that changes every time the dependency graph is evaluated. Values are never reused, also
+ * not by other dependency graphs, so data computed during one evaluation can be shared by
+ * everything evaluated in it.
+ */
+uint64_t DEG_get_update_count(const struct Depsgraph *depsgraph);
+
 bool DEG_is_active(const struct Depsgraph *depsgraph);
 void DEG_make_active(struct Depsgraph *depsgraph);
 void DEG_make_inactive(struct Depsgraph *depsgraph);
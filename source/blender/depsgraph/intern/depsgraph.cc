@@ -60,6 +60,7 @@ Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluati
       is_active(false),
       use_visibility_optimization(true),
       is_evaluating(false),
+      update_count(0),
       is_render_pipeline_depsgraph(false),
       use_editors_update(false)
 {
@@ -304,6 +305,12 @@ void DEG_graph_free(Depsgraph *graph)
   delete deg_depsgraph;
 }
 
+uint64_t DEG_get_update_count(const Depsgraph *depsgraph)
+{
+  const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(depsgraph);
+  return deg_graph->update_count;
+}
+
 bool DEG_is_evaluating(const struct Depsgraph *depsgraph)
 {
   const deg::Depsgraph *deg_graph = reinterpret_cast<const deg::Depsgraph *>(depsgraph);
@@ -154,6 +154,9 @@ struct Depsgraph {
 
   bool is_evaluating;
 
+  /* Set to a new value on every evaluation, see #DEG_get_update_count. */
+  uint64_t update_count;
+
   /* Is set to truth for dependency graph which are used for post-processing (compositor and
    * sequencer).
    * Such dependency graph needs all view layers (so render pipeline can access names), but it
@@ -9,13 +9,17 @@
 
 #include "intern/eval/deg_eval.h"
 
+#include <algorithm>
+
 #include "PIL_time.h"
 
+#include "BLI_array.hh"
 #include "BLI_compiler_attrs.h"
 #include "BLI_function_ref.hh"
 #include "BLI_gsqueue.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_global.h"
 
@@ -77,29 +81,52 @@ enum class EvaluationStage {
   SINGLE_THREADED_WORKAROUND,
 };
 
+/* Operations which are known to take less time than this (in seconds) are evaluated by the task
+ * which made them ready, instead of being pushed to the task pool as a task of their own. */
+static constexpr double DEG_EVAL_CHEAP_OPERATION_TIME = 5e-6;
+/* Maximum number of cheap operations a single task keeps around for evaluation. */
+static constexpr int64_t DEG_EVAL_MAX_PENDING_CHEAP_OPERATIONS = 32;
+
 struct DepsgraphEvalState {
   Depsgraph *graph;
   bool do_stats;
   EvaluationStage stage;
   bool need_update_pending_parents = true;
   bool need_single_thread_pass = false;
+  /* Operations in the order in which they finished evaluating, including NOOP ones. Each parent
+   * finishes before its children, so the critical path times can be computed in reverse order. */
+  Array<OperationNode *> finished_operations;
+  int32_t num_finished_operations = 0;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+void record_finished_operation(DepsgraphEvalState *state, OperationNode *operation_node)
+{
+  const int32_t index = atomic_fetch_and_add_int32(&state->num_finished_operations, 1);
+  if (index < state->finished_operations.size()) {
+    state->finished_operations[index] = operation_node;
+  }
+}
+
+void evaluate_node(DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert_msg(!operation_node->is_noop(), "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
+  /* Perform operation. The time is always measured, as it is used for scheduling. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const float eval_time = float(PIL_check_seconds_timer() - start_time);
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += eval_time;
+  }
+  if (operation_node->eval_time_average < 0.0f) {
+    operation_node->eval_time_average = eval_time;
   }
   else {
-    operation_node->evaluate(depsgraph);
+    operation_node->eval_time_average += (eval_time - operation_node->eval_time_average) * 0.25f;
   }
+  record_finished_operation(state, operation_node);
 
   /* Clear the flag early on, allowing partial updates without re-evaluating the same node multiple
    * times.
@@ -108,19 +135,69 @@ void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_nod
   operation_node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
 }
 
+bool is_cheap_operation(const OperationNode *operation_node)
+{
+  return operation_node->eval_time_average >= 0.0f &&
+         operation_node->eval_time_average < DEG_EVAL_CHEAP_OPERATION_TIME;
+}
+
 void deg_task_run_func(TaskPool *pool, void *taskdata)
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
-  /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  /* Next operation on the longest path through the task's operation, evaluated by this task so
+   * that the chain of operations which takes the longest is not delayed by waiting for a free
+   * thread. */
+  OperationNode *critical_node = reinterpret_cast<OperationNode *>(taskdata);
+  /* Cheap operations which became ready, evaluated by this task before continuing on the longest
+   * path. Only their cheap children are added here, they never continue a path of their own. */
+  Vector<OperationNode *, DEG_EVAL_MAX_PENDING_CHEAP_OPERATIONS> cheap_nodes;
+  Vector<OperationNode *, 16> ready_nodes;
+
+  /* Keep cheap operations in this task as long as there is room, push everything else to the
+   * pool. */
+  auto schedule_ready_nodes = [&](const OperationNode *skip_node) {
+    for (OperationNode *node : ready_nodes) {
+      if (node == skip_node) {
+        continue;
+      }
+      if (is_cheap_operation(node) &&
+          cheap_nodes.size() < DEG_EVAL_MAX_PENDING_CHEAP_OPERATIONS) {
+        cheap_nodes.append(node);
+      }
+      else {
+        BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
+      }
+    }
+  };
 
-  /* Schedule children. */
-  schedule_children(state, operation_node, [&](OperationNode *node) {
-    BLI_task_pool_push(pool, deg_task_run_func, node, false, nullptr);
-  });
+  while (critical_node != nullptr) {
+    OperationNode *operation_node = critical_node;
+    evaluate_node(state, operation_node);
+
+    ready_nodes.clear();
+    schedule_children(
+        state, operation_node, [&](OperationNode *node) { ready_nodes.append(node); });
+    critical_node = nullptr;
+    if (!ready_nodes.is_empty()) {
+      critical_node = *std::max_element(
+          ready_nodes.begin(), ready_nodes.end(), [](OperationNode *a, OperationNode *b) {
+            return a->critical_path_time < b->critical_path_time;
+          });
+    }
+    schedule_ready_nodes(critical_node);
+
+    while (!cheap_nodes.is_empty()) {
+      OperationNode *cheap_node = cheap_nodes.pop_last();
+      evaluate_node(state, cheap_node);
+
+      ready_nodes.clear();
+      schedule_children(
+          state, cheap_node, [&](OperationNode *node) { ready_nodes.append(node); });
+      schedule_ready_nodes(nullptr);
+    }
+  }
 }
 
 bool check_operation_node_visible(const DepsgraphEvalState *state, OperationNode *op_node)
@@ -272,6 +349,7 @@ void schedule_node(DepsgraphEvalState *state,
       /* Clear flags to avoid affecting subsequent update propagation.
        * For normal nodes these are cleared when it is evaluated. */
       node->flag &= ~DEPSOP_FLAG_CLEAR_ON_EVAL;
+      record_finished_operation(state, node);
 
       /* skip NOOP node, schedule children right away */
       schedule_children(state, node, schedule_fn);
@@ -317,9 +395,15 @@ void evaluate_graph_threaded_stage(DepsgraphEvalState *state,
 
   calculate_pending_parents_if_needed(state);
 
-  schedule_graph(state, [&](OperationNode *node) {
-    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
+  /* Start with the operations on the longest paths, so that they get a thread first. */
+  Vector<OperationNode *> ready_nodes;
+  schedule_graph(state, [&](OperationNode *node) { ready_nodes.append(node); });
+  std::stable_sort(ready_nodes.begin(), ready_nodes.end(), [](OperationNode *a, OperationNode *b) {
+    return a->critical_path_time > b->critical_path_time;
   });
+  for (OperationNode *node : ready_nodes) {
+    BLI_task_pool_push(task_pool, deg_task_run_func, node, false, nullptr);
+  }
   BLI_task_pool_work_and_wait(task_pool);
 }
 
@@ -351,6 +435,28 @@ void evaluate_graph_single_threaded_if_needed(DepsgraphEvalState *state)
   BLI_gsqueue_free(evaluation_queue);
 }
 
+/* Update the time of the longest path from every evaluated operation to the end of the graph,
+ * used to prioritize operations in the next evaluation. Operations which were not evaluated keep
+ * the time from the last evaluation they were part of. */
+void update_critical_path_times(DepsgraphEvalState *state)
+{
+  const int64_t num_finished_operations = std::min<int64_t>(state->num_finished_operations,
+                                                            state->finished_operations.size());
+  for (int64_t i = num_finished_operations - 1; i >= 0; i--) {
+    OperationNode *operation_node = state->finished_operations[i];
+    float children_time = 0.0f;
+    for (Relation *rel : operation_node->outlinks) {
+      if (rel->flag & RELATION_FLAG_CYCLIC) {
+        continue;
+      }
+      const OperationNode *child = (OperationNode *)rel->to;
+      children_time = std::max(children_time, child->critical_path_time);
+    }
+    operation_node->critical_path_time = std::max(operation_node->eval_time_average, 0.0f) +
+                                         children_time;
+  }
+}
+
 void depsgraph_ensure_view_layer(Depsgraph *graph)
 {
   /* We update copy-on-write scene in the following cases:
@@ -385,6 +491,11 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     return;
   }
 
+  /* Shared by all graphs, so a value is never seen twice even when a graph is freed and another
+   * one is allocated at the same address. */
+  static uint64_t update_count_global = 0;
+  graph->update_count = atomic_add_and_fetch_uint64(&update_count_global, 1);
+
   graph->debug.begin_graph_evaluation();
 
 #ifdef WITH_PYTHON
@@ -399,6 +510,7 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   DepsgraphEvalState state;
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
+  state.finished_operations.reinitialize(graph->operations.size());
 
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
@@ -447,6 +559,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
 
   evaluate_graph_single_threaded_if_needed(&state);
 
+  update_critical_path_times(&state);
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
@@ -278,6 +278,13 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Moving average of the evaluation time in seconds, negative until evaluated once. */
+  float eval_time_average;
+  /* Sum of the average evaluation times along the longest path from this operation to any
+   * operation without children, as of the last evaluation. Used to evaluate operations that
+   * lots of other work waits for first. */
+  float critical_path_time;
+
   DEG_DEPSNODE_DECLARE;
 };
 
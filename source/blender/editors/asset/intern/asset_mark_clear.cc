@@ -35,6 +35,7 @@ bool ED_asset_mark_id(ID *id)
   }
 
   id_fake_user_set(id);
+  id->tag |= LIB_TAG_UNDO_CHANGED;
 
   const IDTypeInfo *id_type_info = BKE_idtype_get_info_from_id(id);
   id->asset_data = BKE_asset_metadata_create();
@@ -63,6 +64,7 @@ bool ED_asset_clear_id(ID *id)
   }
   BKE_asset_metadata_free(&id->asset_data);
   id_fake_user_clear(id);
+  id->tag |= LIB_TAG_UNDO_CHANGED;
 
   /* Important for asset storage to update properly! */
   ED_assetlist_storage_tag_main_data_dirty();
@@ -251,6 +251,11 @@ static void um_arraystore_cd_compact(CustomData *cdata,
 
     CustomDataLayer *layer = &cdata->layers[layer_start];
     for (int i = 0; i < layer_len; i++, layer++) {
+      if (create && layer->data && layer_type_is_dynamic) {
+        /* The undo step takes ownership of the data the elements point to, which can't be
+         * shared with other meshes. */
+        CustomData_ensure_data_is_mutable(layer, int(data_len));
+      }
       if (create) {
         if (layer->data) {
           BArrayState *state_reference = (bcd_reference_current &&
@@ -270,10 +275,8 @@ static void um_arraystore_cd_compact(CustomData *cdata,
         }
       }
 
-      if (layer->data) {
-        MEM_freeN(layer->data);
-        layer->data = nullptr;
-      }
+      /* Only the array store keeps a copy of the arrays. */
+      CustomData_layer_release_array(layer);
     }
 
     if (create) {
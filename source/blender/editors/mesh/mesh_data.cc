@@ -273,12 +273,15 @@ int ED_mesh_uv_add(
     }
 
     if (CustomData_has_layer(&me->ldata, CD_PROP_FLOAT2) && do_init) {
+      /* The layer data may be shared or point into a file mapping, so copy it with a known size
+       * rather than with #MEM_dupallocN. */
+      const float2 *uv_src = static_cast<const float2 *>(
+          CustomData_get_layer(&me->ldata, CD_PROP_FLOAT2));
+      float2 *uv_dst = static_cast<float2 *>(
+          MEM_malloc_arrayN(size_t(me->totloop), sizeof(float2), __func__));
+      memcpy(uv_dst, uv_src, sizeof(float2) * size_t(me->totloop));
       CustomData_add_layer_named_with_data(
-          &me->ldata,
-          CD_PROP_FLOAT2,
-          MEM_dupallocN(CustomData_get_layer(&me->ldata, CD_PROP_FLOAT2)),
-          me->totloop,
-          unique_name);
+          &me->ldata, CD_PROP_FLOAT2, uv_dst, me->totloop, unique_name);
 
       is_init = true;
     }
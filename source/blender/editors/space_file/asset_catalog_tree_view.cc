@@ -475,8 +475,9 @@ bool AssetCatalogDropTarget::drop_assets_into_catalog(struct bContext *C,
     }
 
     did_update = true;
-    BKE_asset_metadata_catalog_id_set(
-        asset_item->asset_data.local_id->asset_data, catalog_id, simple_name.c_str());
+    ID *local_id = asset_item->asset_data.local_id;
+    BKE_asset_metadata_catalog_id_set(local_id->asset_data, catalog_id, simple_name.c_str());
+    local_id->tag |= LIB_TAG_UNDO_CHANGED;
 
     /* Trigger re-run of filtering to update visible assets. */
     filelist_tag_needs_filtering(tree_view.space_file_.files);
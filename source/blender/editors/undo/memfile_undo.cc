@@ -83,6 +83,12 @@ static bool memfile_undosys_step_encode(struct bContext * /*C*/,
     ED_editors_flush_edits_ex(bmain, false, true);
   }
 
+  /* Steps of other undo systems (e.g. sculpt strokes or edit-mode changes) modify data without
+   * tagging it, so the data of the last memfile step can't be reused for any ID then. */
+  if (ustack->step_active == nullptr || ustack->step_active->type != BKE_UNDOSYS_TYPE_MEMFILE) {
+    bmain->is_memfile_undo_reusable = false;
+  }
+
   /* can be null, use when set. */
   MemFileUndoStep *us_prev = (MemFileUndoStep *)BKE_undosys_step_find_by_type(
       ustack, BKE_UNDOSYS_TYPE_MEMFILE);
@@ -22,9 +22,26 @@ void OBJECT_OT_lineart_clear_all(struct wmOperatorType *ot);
 void WM_operatortypes_lineart(void);
 
 struct LineartCache;
+struct LineartProfile;
 
 void MOD_lineart_clear_cache(struct LineartCache **lc);
 
+/** Free light pass results shared between line art modifiers. */
+void MOD_lineart_shadow_cache_free(void);
+/** Start trimming memory kept for reuse by the next line art calculation on a timer. */
+void MOD_lineart_memory_init(void);
+/** Free memory kept for reuse by the next line art calculation. */
+void MOD_lineart_memory_free_spare(void);
+
+/** Enough for every field #MOD_lineart_profile_to_json writes. */
+#define LRT_PROFILE_JSON_MAXLEN 2048
+
+/**
+ * Write the stage profile of the last line art calculation as a JSON object, for tracking
+ * performance from Python. Returns the length of the string.
+ */
+int MOD_lineart_profile_to_json(const struct LineartProfile *profile, char *r_str, int maxlen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,12 +6,17 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "BLI_math_vector.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
 
+#include "MEM_guardedalloc.h"
+
+#include "PIL_time.h"
+
 #include "DNA_collection_types.h"
 #include "DNA_defaults.h"
 #include "DNA_gpencil_legacy_types.h"
@@ -56,6 +61,18 @@ static void initData(GpencilModifierData *md)
 static void copyData(const GpencilModifierData *md, GpencilModifierData *target)
 {
   BKE_gpencil_modifier_copydata_generic(md, target);
+
+  /* The previous result belongs to the source modifier only. */
+  LineartGpencilModifierData *tlmd = (LineartGpencilModifierData *)target;
+  tlmd->la_incremental_ptr = NULL;
+  tlmd->la_profile_ptr = NULL;
+}
+
+static void freeData(GpencilModifierData *md)
+{
+  LineartGpencilModifierData *lmd = (LineartGpencilModifierData *)md;
+  MOD_lineart_incremental_cache_free(&lmd->la_incremental_ptr);
+  MEM_SAFE_FREE(lmd->la_profile_ptr);
 }
 
 static void generate_strokes_actual(
@@ -67,6 +84,8 @@ static void generate_strokes_actual(
     printf("LRT: Generating from modifier.\n");
   }
 
+  const double t_start = PIL_check_seconds_timer();
+
   MOD_lineart_gpencil_generate(
       lmd->cache,
       depsgraph,
@@ -91,6 +110,11 @@ static void generate_strokes_actual(
       lmd->vgname,
       lmd->flags,
       lmd->calculation_flags);
+
+  if (!lmd->la_profile_ptr) {
+    lmd->la_profile_ptr = MEM_callocN(sizeof(LineartProfile), "Lineart Profile");
+  }
+  lmd->la_profile_ptr->stages[LRT_PROFILE_GPENCIL].time = PIL_check_seconds_timer() - t_start;
 }
 
 static bool isModifierDisabled(GpencilModifierData *md)
@@ -151,6 +175,17 @@ static void generateStrokes(GpencilModifierData *md, Depsgraph *depsgraph, Objec
       MOD_lineart_compute_feature_lines(depsgraph, lmd, &local_lc, !(ob->dtx & OB_DRAW_IN_FRONT));
       MOD_lineart_destroy_render_data(lmd);
     }
+    else {
+      /* Nothing is calculated, the calculation belongs to the modifier that made the cache. Don't
+       * keep reporting an earlier calculation of this modifier. */
+      if (!lmd->la_profile_ptr) {
+        lmd->la_profile_ptr = MEM_callocN(sizeof(LineartProfile), "Lineart Profile");
+      }
+      else {
+        memset(lmd->la_profile_ptr, 0, sizeof(LineartProfile));
+      }
+      lmd->la_profile_ptr->used_cache = true;
+    }
     MOD_lineart_chain_clear_picked_flag(local_lc);
     lmd->cache = local_lc;
   }
@@ -479,6 +514,7 @@ static void options_panel_draw(const bContext *UNUSED(C), Panel *panel)
   uiItemR(col, ptr, "use_crease_on_smooth", 0, IFACE_("Crease On Smooth"), ICON_NONE);
   uiItemR(col, ptr, "use_crease_on_sharp", 0, IFACE_("Crease On Sharp"), ICON_NONE);
   uiItemR(col, ptr, "use_back_face_culling", 0, IFACE_("Force Backface Culling"), ICON_NONE);
+  uiItemR(col, ptr, "use_incremental", 0, NULL, ICON_NONE);
 }
 
 static void occlusion_panel_draw(const bContext *UNUSED(C), Panel *panel)
@@ -591,6 +627,7 @@ static void intersection_panel_draw(const bContext *UNUSED(C), Panel *panel)
   }
 
   uiItemR(layout, ptr, "use_intersection_match", 0, IFACE_("Exact Match"), ICON_NONE);
+  uiItemR(layout, ptr, "use_intersection_bvh", 0, NULL, ICON_NONE);
 }
 
 static void face_mark_panel_draw_header(const bContext *UNUSED(C), Panel *panel)
@@ -819,7 +856,7 @@ GpencilModifierTypeInfo modifierType_Gpencil_Lineart = {
     /*remapTime*/ NULL,
 
     /*initData*/ initData,
-    /*freeData*/ NULL,
+    /*freeData*/ freeData,
     /*isDisabled*/ isDisabled,
     /*updateDepsgraph*/ updateDepsgraph,
     /*dependsOnTime*/ NULL,
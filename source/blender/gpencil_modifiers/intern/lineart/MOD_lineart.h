@@ -22,12 +22,22 @@ typedef struct LineartStaticMemPoolNode {
   Link item;
   size_t size;
   size_t used_byte;
+  /** When the node was given back to the spare nodes, see #lineart_mem_destroy. */
+  double spare_time;
   /* User memory starts here */
 } LineartStaticMemPoolNode;
 
+/** Memory in the pool nodes of one line art calculation. */
+typedef struct LineartMemUsage {
+  size_t used;
+  size_t peak;
+} LineartMemUsage;
+
 typedef struct LineartStaticMemPool {
   ListBase pools;
   SpinLock lock_mem;
+  /** Calculation the nodes are accounted to while it runs, NULL when not tracked. */
+  LineartMemUsage *usage;
 } LineartStaticMemPool;
 
 typedef struct LineartTriangleAdjacent {
@@ -238,6 +248,10 @@ typedef struct LineartChainRegisterEntry {
   struct LineartChainRegisterEntry *next, *prev;
   LineartEdgeChain *ec;
   LineartEdgeChainItem *eci;
+  /** The leaf tile this entry is linked into. */
+  struct LineartBoundingArea *ba;
+  /** Order of registration, entries of a tile are linked in increasing order. */
+  int index;
   int8_t picked;
 
   /* left/right mark.
@@ -261,6 +275,12 @@ enum eLineArtTileRecursiveLimit {
 
 #define LRT_TILE_SPLITTING_TRIANGLE_LIMIT 100
 #define LRT_TILE_EDGE_COUNT_INITIAL 32
+/* Number of triangles tested at once by the occlusion bounds prefilter. */
+#define LRT_TRIANGLE_BOUNDS_WIDTH 4
+/* Rows of floats per triangle block in #LineartBoundingArea::triangle_bounds, the edge functions
+ * start at the second row. */
+#define LRT_TRIANGLE_BOUNDS_ROWS 15
+#define LRT_TRIANGLE_BOUNDS_EDGES_ROW 5
 
 enum eLineartShadowCameraType {
   LRT_SHADOW_CAMERA_DIRECTIONAL = 1,
@@ -306,6 +326,12 @@ typedef struct LineartData {
 
     uint32_t initial_tile_count;
 
+    /* Contiguous storage for all leaf tiles once insertion is done, see
+     * #LineartBoundingArea::compacted. */
+    struct LineartTriangle **compact_triangles;
+    float *compact_triangle_bounds;
+    struct LineartBoundingArea **compact_neighbors;
+
   } qtree;
 
   struct _geom {
@@ -340,6 +366,8 @@ typedef struct LineartData {
     bool use_material;
     bool use_edge_marks;
     bool use_intersections;
+    /* Find intersections with a BVH after insertion instead of while linking triangles. */
+    bool use_bvh_intersections;
     bool use_loose;
     bool use_light_contour;
     bool use_shadow;
@@ -402,7 +430,6 @@ typedef struct LineartData {
 
   /* NOTE: Data inside #pending_edges are allocated with MEM_xxx call instead of in pool. */
   struct LineartPendingEdges pending_edges;
-  int scheduled_count;
 
   /* Intermediate shadow results, list of LineartShadowEdge */
   LineartShadowEdge *shadow_edges;
@@ -415,6 +442,13 @@ typedef struct LineartData {
   SpinLock lock_cuts;
   SpinLock lock_task;
 
+  /** Where stage timings go, owned by the modifier. Null for the shadow pass. */
+  struct LineartProfile *profile;
+
+  /** Object snapshots and changed areas of an incremental calculation (#LRT_USE_INCREMENTAL).
+   * Null otherwise, and when shadows are calculated. */
+  struct LineartIncrementalData *incremental;
+
 } LineartData;
 
 typedef struct LineartCache {
@@ -434,10 +468,117 @@ typedef struct LineartCache {
   uint16_t all_enabled_edge_types;
 } LineartCache;
 
+/** Stages of a line art calculation recorded in #LineartProfile. */
+typedef enum eLineartProfileStage {
+  LRT_PROFILE_LOAD = 0,
+  LRT_PROFILE_CULL,
+  /** Building and compacting the tile tree, triangle insertion is part of intersection. */
+  LRT_PROFILE_QUADTREE,
+  LRT_PROFILE_INTERSECTION,
+  LRT_PROFILE_OCCLUSION,
+  LRT_PROFILE_SHADOW,
+  LRT_PROFILE_CHAINING,
+  LRT_PROFILE_SMOOTHING,
+  LRT_PROFILE_GPENCIL,
+
+  LRT_PROFILE_STAGE_COUNT,
+} eLineartProfileStage;
+
+typedef struct LineartProfileStage {
+  /** Wall time in seconds. */
+  double time;
+  /** Time summed over worker threads, only for stages running their own workers. */
+  double thread_time;
+} LineartProfileStage;
+
+/** Per-stage timings and counts of the last calculation, see #MOD_lineart_profile_to_json. */
+typedef struct LineartProfile {
+  LineartProfileStage stages[LRT_PROFILE_STAGE_COUNT];
+  double total_time;
+
+  int thread_count;
+  int triangle_count;
+  int edge_count;
+  int segment_count;
+  int chain_count;
+
+  /** Bytes allocated by #LineartStaticMemPool. */
+  size_t render_pool_bytes;
+  size_t chain_pool_bytes;
+  size_t shadow_pool_bytes;
+  /** Most memory used by the pools of this calculation at the same time. */
+  size_t peak_bytes;
+
+  /** The result of the previous calculation was reused, see #LRT_USE_INCREMENTAL. */
+  bool reused;
+  /**
+   * Nothing was calculated, the result of a modifier above was used (#LRT_GPENCIL_USE_CACHE).
+   * Only the grease pencil stage is recorded then.
+   */
+  bool used_cache;
+} LineartProfile;
+
+/** One loaded object (or instance) as seen by the previous evaluation. */
+typedef struct LineartIncrementalObject {
+  struct Object *original_ob;
+  float object_to_world[4][4];
+} LineartIncrementalObject;
+
+/**
+ * Everything outside of the loaded objects that the result depends on. Always zero-initialized so
+ * it can be compared with `memcmp`.
+ */
+typedef struct LineartIncrementalView {
+  int w, h;
+  float camera_obmat[4][4];
+  float active_camera_pos[3];
+  float light_obmat[4][4];
+  float camera_lens, camera_ortho_scale, camera_clip_start, camera_clip_end;
+  float camera_shift_x, camera_shift_y, camera_sensor_x, camera_sensor_y;
+  char camera_type, camera_sensor_fit, light_type;
+  bool enable_stroke_depth_offset;
+} LineartIncrementalView;
+
+/**
+ * Kept on the modifier between evaluations when #LRT_USE_INCREMENTAL is enabled. When the
+ * modifier settings, the camera, the light and every object line art loads (with its transform)
+ * are the same as in the previous evaluation, and none of those objects, their materials or any
+ * collection is tagged for an update, the stored chains are handed out again instead of running
+ * the whole calculation.
+ *
+ * Otherwise, as long as the settings, the view and the collections didn't change, only the
+ * objects that changed are loaded again, the others are restored from their snapshots. Occlusion
+ * is only calculated again for edges that overlap the image space area of a changed object, see
+ * #LineartIncrementalData.
+ */
+typedef struct LineartIncrementalCache {
+  /** Copy of the modifier the result was computed with, runtime pointers are not compared. */
+  struct LineartGpencilModifierData *settings;
+  LineartIncrementalView view;
+
+  LineartIncrementalObject *objects;
+  int object_count;
+
+  /** Chains of the previous result, in its own memory pool. */
+  LineartCache *result;
+
+  /** Loaded geometry and occlusion of the objects of the previous result, NULL when shadows were
+   * calculated, because those depend on all objects. */
+  struct LineartObjectSnapshots *snapshots;
+} LineartIncrementalCache;
+
 #define DBL_TRIANGLE_LIM 1e-8
 #define DBL_EDGE_LIM 1e-9
 
 #define LRT_MEMORY_POOL_1MB (1 << 20)
+/** Spare pool nodes are binned by size, node sizes up to `1MB << (LRT_MEMORY_SPARE_BINS - 1)`
+ * are rounded up to a power of two so all nodes in a bin are the same. */
+#define LRT_MEMORY_SPARE_BINS 12
+/** Keep at most this much memory in spare nodes. */
+#define LRT_MEMORY_SPARE_MAX ((size_t)256 << 20)
+/** Spare nodes that haven't been used again for this many seconds are freed, checked when nodes
+ * are taken or given back and by a timer, see #MOD_lineart_memory_init. */
+#define LRT_MEMORY_SPARE_LIFETIME 30.0
 
 typedef enum eLineartTriangleFlags {
   LRT_CULL_DONT_CARE = 0,
@@ -464,11 +605,11 @@ typedef enum eLineartTriangleFlags {
    LRT_SHADOW_MASK_ILLUMINATED_SHAPE)
 
 /**
- * Controls how many edges a worker thread is processing at one request.
- * There's no significant performance impact on choosing different values.
- * Don't make it too small so that the worker thread won't request too many times.
+ * Controls how many edges a worker thread takes from its own occlusion queue at one request.
+ * Queues start with the most expensive edges, keep it small so the remaining ones can still be
+ * stolen by threads that finished early.
  */
-#define LRT_THREAD_EDGE_COUNT 1000
+#define LRT_THREAD_EDGE_COUNT 64
 
 typedef struct LineartRenderTaskInfo {
   struct LineartData *ld;
@@ -476,11 +617,29 @@ typedef struct LineartRenderTaskInfo {
   int thread_id;
 
   /**
-   * #pending_edges here only stores a reference to a portion in
-   * LineartData::pending_edges, assigned by the occlusion scheduler.
+   * #pending_edges here only stores a reference to a portion in #queue, assigned by the
+   * occlusion scheduler.
    */
   struct LineartPendingEdges pending_edges;
 
+  /**
+   * Edges from `queue_begin` to `queue_end` in the shared occlusion queue are owned by this
+   * thread. Other threads steal from the end of the range once they run out, protected by #lock.
+   */
+  struct LineartEdge **queue;
+  int queue_begin;
+  int queue_end;
+  SpinLock lock;
+
+  /** Task infos of all threads, to look for work to steal. */
+  struct LineartRenderTaskInfo *all_tasks;
+  int task_count;
+
+  /* Statistics printed with `G.debug_value == 4000`. */
+  double time;
+  int edge_count;
+  int steal_count;
+
 } LineartRenderTaskInfo;
 
 #define LRT_OBINDEX_SHIFT 20
@@ -513,6 +672,10 @@ typedef struct LineartObjectInfo {
   /** NOTE: Data inside #pending_edges are allocated with MEM_xxx call instead of in pool. */
   struct LineartPendingEdges pending_edges;
 
+  /** The object's geometry is restored from here instead of loading the mesh when the snapshot is
+   * reused, otherwise it's copied here after loading. Only for incremental calculations. */
+  struct LineartObjectSnapshot *snapshot;
+
 } LineartObjectInfo;
 
 typedef struct LineartObjectLoadTaskInfo {
@@ -573,10 +736,37 @@ typedef struct LineartBoundingArea {
   struct LineartTriangle **linked_triangles;
   struct LineartEdge **linked_lines;
 
+  /** Screen space bounds of #linked_triangles in SoA layout (min_x, max_x, min_y, max_y, min_w
+   * blocks, each padded to #LRT_TRIANGLE_BOUNDS_WIDTH), used to reject triangles in batches during
+   * occlusion. Followed by the three edge functions (x, y and constant blocks) and the coordinate
+   * magnitude of each triangle. Only built for leaf tiles. */
+  float *triangle_bounds;
+
+  /**
+   * Adjacent tiles of all sides, in the order of #eLineartBoundingAreaSide. Once the tree is
+   * compacted this replaces #lp, #rp, #up and #bp, which are only used while splitting.
+   */
+  struct LineartBoundingArea **neighbors;
+  uint32_t neighbor_count[4];
+
+  /**
+   * Leaf tile whose #linked_triangles, #triangle_bounds and #neighbors point into the contiguous
+   * arrays in #LineartData::qtree, so they are read without chasing pointers all over memory.
+   */
+  bool compacted;
+
   /** Reserved for image space reduction && multi-thread chaining. */
   ListBase linked_chains;
 } LineartBoundingArea;
 
+/** Index of each side in #LineartBoundingArea::neighbor_count. */
+enum eLineartBoundingAreaSide {
+  LRT_BA_SIDE_LEFT = 0,
+  LRT_BA_SIDE_RIGHT = 1,
+  LRT_BA_SIDE_UP = 2,
+  LRT_BA_SIDE_BOTTOM = 3,
+};
+
 #define LRT_TILE(tile, r, c, CCount) tile[r * CCount + c]
 
 #define LRT_CLAMP(a, Min, Max) a = a < Min ? Min : (a > Max ? Max : a)
@@ -878,6 +1068,10 @@ void MOD_lineart_chain_find_silhouette_backdrop_objects(LineartData *ld);
 
 int MOD_lineart_chain_count(const LineartEdgeChain *ec);
 void MOD_lineart_chain_clear_picked_flag(LineartCache *lc);
+/**
+ * Duplicate all chains and their points from \a src into \a dst, allocating from \a smp.
+ */
+void MOD_lineart_chain_list_copy(ListBase *dst, LineartStaticMemPool *smp, const ListBase *src);
 void MOD_lineart_finalize_chains(LineartData *ld);
 
 /**
@@ -890,6 +1084,11 @@ bool MOD_lineart_compute_feature_lines(struct Depsgraph *depsgraph,
                                        struct LineartCache **cached_result,
                                        bool enable_stroke_depth_offset);
 
+/**
+ * Free the result kept for #LRT_USE_INCREMENTAL evaluation.
+ */
+void MOD_lineart_incremental_cache_free(LineartIncrementalCache **lic);
+
 /**
  * This only gets initial "biggest" tile.
  */
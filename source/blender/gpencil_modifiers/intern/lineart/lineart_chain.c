@@ -9,6 +9,8 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 
+#include "MEM_guardedalloc.h"
+
 #include "MOD_lineart.h"
 
 #include "lineart_intern.h"
@@ -537,13 +539,16 @@ static LineartBoundingArea *lineart_bounding_area_get_end_point(LineartData *ld,
 static void lineart_bounding_area_link_point_recursive(LineartData *ld,
                                                        LineartBoundingArea *root,
                                                        LineartEdgeChain *ec,
-                                                       LineartEdgeChainItem *eci)
+                                                       LineartEdgeChainItem *eci,
+                                                       int *r_index)
 {
   if (root->child == NULL) {
     LineartChainRegisterEntry *cre = lineart_list_append_pointer_pool_sized(
         &root->linked_chains, ld->chain_data_pool, ec, sizeof(LineartChainRegisterEntry));
 
     cre->eci = eci;
+    cre->ba = root;
+    cre->index = (*r_index)++;
 
     if (eci == ec->chain.first) {
       cre->is_left = 1;
@@ -556,23 +561,23 @@ static void lineart_bounding_area_link_point_recursive(LineartData *ld,
   ba.l <= eci->pos[0] && ba.r >= eci->pos[0] && ba.b <= eci->pos[1] && ba.u >= eci->pos[1]
 
     if (IN_BOUND(ch[0], eci)) {
-      lineart_bounding_area_link_point_recursive(ld, &ch[0], ec, eci);
+      lineart_bounding_area_link_point_recursive(ld, &ch[0], ec, eci, r_index);
     }
     else if (IN_BOUND(ch[1], eci)) {
-      lineart_bounding_area_link_point_recursive(ld, &ch[1], ec, eci);
+      lineart_bounding_area_link_point_recursive(ld, &ch[1], ec, eci, r_index);
     }
     else if (IN_BOUND(ch[2], eci)) {
-      lineart_bounding_area_link_point_recursive(ld, &ch[2], ec, eci);
+      lineart_bounding_area_link_point_recursive(ld, &ch[2], ec, eci, r_index);
     }
     else if (IN_BOUND(ch[3], eci)) {
-      lineart_bounding_area_link_point_recursive(ld, &ch[3], ec, eci);
+      lineart_bounding_area_link_point_recursive(ld, &ch[3], ec, eci, r_index);
     }
 
 #undef IN_BOUND
   }
 }
 
-static void lineart_bounding_area_link_chain(LineartData *ld, LineartEdgeChain *ec)
+static void lineart_bounding_area_link_chain(LineartData *ld, LineartEdgeChain *ec, int *r_index)
 {
   LineartEdgeChainItem *pl = ec->chain.first;
   LineartEdgeChainItem *pr = ec->chain.last;
@@ -580,10 +585,10 @@ static void lineart_bounding_area_link_chain(LineartData *ld, LineartEdgeChain *
   LineartBoundingArea *ba2 = MOD_lineart_get_parent_bounding_area(ld, pr->pos[0], pr->pos[1]);
 
   if (ba1) {
-    lineart_bounding_area_link_point_recursive(ld, ba1, ec, pl);
+    lineart_bounding_area_link_point_recursive(ld, ba1, ec, pl, r_index);
   }
   if (ba2) {
-    lineart_bounding_area_link_point_recursive(ld, ba2, ec, pr);
+    lineart_bounding_area_link_point_recursive(ld, ba2, ec, pr, r_index);
   }
 }
 
@@ -728,8 +733,9 @@ void MOD_lineart_chain_split_for_fixed_occlusion(LineartData *ld)
 
   MOD_lineart_chain_discard_unused(ld, DBL_EDGE_LIM, ld->conf.max_occlusion_level);
 
+  int end_index = 0;
   LISTBASE_FOREACH (LineartEdgeChain *, iec, &ld->chains) {
-    lineart_bounding_area_link_chain(ld, iec);
+    lineart_bounding_area_link_chain(ld, iec, &end_index);
   }
 }
 
@@ -786,7 +792,232 @@ static void lineart_chain_connect(LineartData *UNUSED(ld),
   }
 }
 
+/**
+ * Uniform grid over the registered chain end points, so looking for the ends near a point only
+ * visits the cells around it instead of every end linked to a tile. Cells are never smaller than
+ * the chaining threshold, so the 3x3 cells around a point hold every end close enough to connect.
+ */
+typedef struct LineartChainEndGrid {
+  float min[2];
+  float cell_size[2];
+  int res[2];
+  /** Entries of cell `i` are `entries[cell_start[i]]` up to `entries[cell_start[i + 1]]`, in the
+   * order they were registered. */
+  int *cell_start;
+  LineartChainRegisterEntry **entries;
+
+  /** Result of the last query. */
+  LineartChainRegisterEntry **found;
+  int found_count;
+  int found_max;
+} LineartChainEndGrid;
+
+#define LRT_CHAIN_END_GRID_MAX_RES 256
+
+static void lineart_chain_end_grid_gather_recursive(LineartBoundingArea *ba,
+                                                    LineartChainRegisterEntry **r_entries,
+                                                    int *r_count)
+{
+  if (ba->child) {
+    for (int i = 0; i < 4; i++) {
+      lineart_chain_end_grid_gather_recursive(&ba->child[i], r_entries, r_count);
+    }
+    return;
+  }
+  LISTBASE_FOREACH (LineartChainRegisterEntry *, cre, &ba->linked_chains) {
+    if (r_entries) {
+      r_entries[cre->index] = cre;
+    }
+    (*r_count)++;
+  }
+}
+
+static void lineart_chain_end_grid_cell(const LineartChainEndGrid *grid,
+                                        const float pos[2],
+                                        int r_cell[2])
+{
+  for (int i = 0; i < 2; i++) {
+    r_cell[i] = (int)floorf((pos[i] - grid->min[i]) / grid->cell_size[i]);
+    CLAMP(r_cell[i], 0, grid->res[i] - 1);
+  }
+}
+
+static bool lineart_chain_end_grid_build(LineartData *ld, LineartChainEndGrid *grid)
+{
+  memset(grid, 0, sizeof(LineartChainEndGrid));
+
+  int count = 0;
+  for (int i = 0; i < ld->qtree.initial_tile_count; i++) {
+    lineart_chain_end_grid_gather_recursive(&ld->qtree.initials[i], NULL, &count);
+  }
+  if (!count) {
+    return false;
+  }
+
+  /* Indices are unique and dense, so this puts the entries back in registration order. */
+  LineartChainRegisterEntry **ordered = MEM_malloc_arrayN(
+      count, sizeof(LineartChainRegisterEntry *), "LineartChainEndGrid ordered");
+  count = 0;
+  for (int i = 0; i < ld->qtree.initial_tile_count; i++) {
+    lineart_chain_end_grid_gather_recursive(&ld->qtree.initials[i], ordered, &count);
+  }
+
+  float max[2];
+  INIT_MINMAX2(grid->min, max);
+  for (int i = 0; i < count; i++) {
+    minmax_v2v2_v2(grid->min, max, ordered[i]->eci->pos);
+  }
+
+  /* Slightly larger than the threshold, so float rounding can't put two ends that are within the
+   * threshold two cells apart. */
+  const float min_cell_size = ld->conf.chaining_image_threshold * 1.01f;
+  for (int i = 0; i < 2; i++) {
+    const float extent = max[i] - grid->min[i];
+    grid->cell_size[i] = max_ff(min_cell_size, extent / LRT_CHAIN_END_GRID_MAX_RES);
+    grid->res[i] = min_ii((int)(extent / grid->cell_size[i]) + 1, LRT_CHAIN_END_GRID_MAX_RES);
+  }
+
+  /* Counting sort into cells, walking the entries in order keeps each cell ordered as well. */
+  const int cell_count = grid->res[0] * grid->res[1];
+  grid->cell_start = MEM_callocN(sizeof(int) * (cell_count + 1), "LineartChainEndGrid cells");
+  int *entry_cell = MEM_malloc_arrayN(count, sizeof(int), "LineartChainEndGrid entry cells");
+  for (int i = 0; i < count; i++) {
+    int cell[2];
+    lineart_chain_end_grid_cell(grid, ordered[i]->eci->pos, cell);
+    entry_cell[i] = cell[1] * grid->res[0] + cell[0];
+    grid->cell_start[entry_cell[i] + 1]++;
+  }
+  for (int i = 0; i < cell_count; i++) {
+    grid->cell_start[i + 1] += grid->cell_start[i];
+  }
+  grid->entries = MEM_malloc_arrayN(
+      count, sizeof(LineartChainRegisterEntry *), "LineartChainEndGrid entries");
+  int *cell_next = MEM_dupallocN(grid->cell_start);
+  for (int i = 0; i < count; i++) {
+    grid->entries[cell_next[entry_cell[i]]++] = ordered[i];
+  }
+
+  MEM_freeN(cell_next);
+  MEM_freeN(entry_cell);
+  MEM_freeN(ordered);
+  return true;
+}
+
+static void lineart_chain_end_grid_free(LineartChainEndGrid *grid)
+{
+  MEM_SAFE_FREE(grid->cell_start);
+  MEM_SAFE_FREE(grid->entries);
+  MEM_SAFE_FREE(grid->found);
+}
+
+static int lineart_chain_end_cmp_index(const void *a, const void *b)
+{
+  const LineartChainRegisterEntry *cre_a = *(const LineartChainRegisterEntry **)a;
+  const LineartChainRegisterEntry *cre_b = *(const LineartChainRegisterEntry **)b;
+  return (cre_a->index > cre_b->index) - (cre_a->index < cre_b->index);
+}
+
+/**
+ * Find the ends linked to tile `ba` that may be within the chaining threshold of `pos`, in the
+ * same order as they appear in #LineartBoundingArea::linked_chains.
+ */
+static void lineart_chain_end_grid_query(LineartChainEndGrid *grid,
+                                         LineartBoundingArea *ba,
+                                         const float pos[2])
+{
+  int cell[2];
+  lineart_chain_end_grid_cell(grid, pos, cell);
+
+  grid->found_count = 0;
+  for (int y = max_ii(cell[1] - 1, 0); y <= min_ii(cell[1] + 1, grid->res[1] - 1); y++) {
+    for (int x = max_ii(cell[0] - 1, 0); x <= min_ii(cell[0] + 1, grid->res[0] - 1); x++) {
+      const int c = y * grid->res[0] + x;
+      for (int i = grid->cell_start[c]; i < grid->cell_start[c + 1]; i++) {
+        if (grid->entries[i]->ba != ba) {
+          continue;
+        }
+        if (grid->found_count == grid->found_max) {
+          grid->found_max = max_ii(grid->found_max * 2, 64);
+          grid->found = MEM_reallocN(grid->found,
+                                     sizeof(LineartChainRegisterEntry *) * grid->found_max);
+        }
+        grid->found[grid->found_count++] = grid->entries[i];
+      }
+    }
+  }
+  /* Which end wins among equally close ones depends on the order they are tested in. */
+  qsort(grid->found,
+        grid->found_count,
+        sizeof(LineartChainRegisterEntry *),
+        lineart_chain_end_cmp_index);
+}
+
+/**
+ * Whether `cre` can be connected to `ec` at `eci` and is closer than `r_dist`, which is updated
+ * to its distance if so.
+ */
+static bool lineart_chain_cre_is_closer(LineartData *ld,
+                                        LineartChainRegisterEntry *cre,
+                                        LineartEdgeChain *ec,
+                                        LineartEdgeChainItem *eci,
+                                        int occlusion,
+                                        uint8_t material_mask_bits,
+                                        uint8_t isec_mask,
+                                        uint32_t shadow_mask,
+                                        int loop_id,
+                                        float *r_dist)
+{
+  if (cre->ec->object_ref != ec->object_ref) {
+    if (!ld->conf.fuzzy_everything) {
+      if (ld->conf.fuzzy_intersections) {
+        /* If none of those are intersection lines... */
+        if (!(cre->ec->type & LRT_EDGE_FLAG_INTERSECTION) &&
+            !(ec->type & LRT_EDGE_FLAG_INTERSECTION)) {
+          return false; /* We don't want to chain along different objects at the moment. */
+        }
+      }
+      else {
+        return false;
+      }
+    }
+  }
+  if (cre->ec->picked || cre->picked) {
+    return false;
+  }
+  if (cre->ec == ec || (!cre->ec->chain.first) || (cre->ec->level != occlusion) ||
+      (cre->ec->material_mask_bits != material_mask_bits) ||
+      (cre->ec->intersection_mask != isec_mask) || (cre->ec->shadow_mask_bits != shadow_mask)) {
+    return false;
+  }
+  if (!ld->conf.fuzzy_everything) {
+    if (cre->ec->type != ec->type) {
+      if (ld->conf.fuzzy_intersections) {
+        if (!(cre->ec->type == LRT_EDGE_FLAG_INTERSECTION ||
+              ec->type == LRT_EDGE_FLAG_INTERSECTION)) {
+          return false; /* Fuzzy intersections but no intersection line found. */
+        }
+      }
+      else { /* Line type different but no fuzzy. */
+        return false;
+      }
+    }
+  }
+
+  float new_len = ld->conf.use_geometry_space_chain ? len_v3v3(cre->eci->gpos, eci->gpos) :
+                                                      len_v2v2(cre->eci->pos, eci->pos);
+  /* Even if the vertex is not from the same contour loop, we try to chain it still if the
+   * distance is small enough. This way we can better chain smaller loops and smooth them out
+   * later. */
+  if (((cre->ec->loop_id == loop_id) && (new_len < *r_dist)) ||
+      ((cre->ec->loop_id != loop_id) && (new_len < *r_dist / 10))) {
+    *r_dist = new_len;
+    return true;
+  }
+  return false;
+}
+
 static LineartChainRegisterEntry *lineart_chain_get_closest_cre(LineartData *ld,
+                                                                LineartChainEndGrid *grid,
                                                                 LineartBoundingArea *ba,
                                                                 LineartEdgeChain *ec,
                                                                 LineartEdgeChainItem *eci,
@@ -802,56 +1033,38 @@ static LineartChainRegisterEntry *lineart_chain_get_closest_cre(LineartData *ld,
 
   LineartChainRegisterEntry *closest_cre = NULL;
 
-  /* Keep using for loop because `cre` could be removed from the iteration before getting to the
-   * next one. */
-  LISTBASE_FOREACH_MUTABLE (LineartChainRegisterEntry *, cre, &ba->linked_chains) {
-    if (cre->ec->object_ref != ec->object_ref) {
-      if (!ld->conf.fuzzy_everything) {
-        if (ld->conf.fuzzy_intersections) {
-          /* If none of those are intersection lines... */
-          if (!(cre->ec->type & LRT_EDGE_FLAG_INTERSECTION) &&
-              !(ec->type & LRT_EDGE_FLAG_INTERSECTION)) {
-            continue; /* We don't want to chain along different objects at the moment. */
-          }
-        }
-        else {
-          continue;
-        }
-      }
-    }
-    if (cre->ec->picked || cre->picked) {
-      continue;
-    }
-    if (cre->ec == ec || (!cre->ec->chain.first) || (cre->ec->level != occlusion) ||
-        (cre->ec->material_mask_bits != material_mask_bits) ||
-        (cre->ec->intersection_mask != isec_mask) || (cre->ec->shadow_mask_bits != shadow_mask)) {
-      continue;
-    }
-    if (!ld->conf.fuzzy_everything) {
-      if (cre->ec->type != ec->type) {
-        if (ld->conf.fuzzy_intersections) {
-          if (!(cre->ec->type == LRT_EDGE_FLAG_INTERSECTION ||
-                ec->type == LRT_EDGE_FLAG_INTERSECTION)) {
-            continue; /* Fuzzy intersections but no intersection line found. */
-          }
-        }
-        else { /* Line type different but no fuzzy. */
-          continue;
-        }
+  if (grid) {
+    lineart_chain_end_grid_query(grid, ba, eci->pos);
+    for (int i = 0; i < grid->found_count; i++) {
+      if (lineart_chain_cre_is_closer(ld,
+                                      grid->found[i],
+                                      ec,
+                                      eci,
+                                      occlusion,
+                                      material_mask_bits,
+                                      isec_mask,
+                                      shadow_mask,
+                                      loop_id,
+                                      &dist)) {
+        closest_cre = grid->found[i];
       }
     }
-
-    float new_len = ld->conf.use_geometry_space_chain ? len_v3v3(cre->eci->gpos, eci->gpos) :
-                                                        len_v2v2(cre->eci->pos, eci->pos);
-    /* Even if the vertex is not from the same contour loop, we try to chain it still if the
-     * distance is small enough. This way we can better chain smaller loops and smooth them out
-     * later. */
-    if (((cre->ec->loop_id == loop_id) && (new_len < dist)) ||
-        ((cre->ec->loop_id != loop_id) && (new_len < dist / 10))) {
-      closest_cre = cre;
-      dist = new_len;
-      if (result_new_len) {
-        (*result_new_len) = new_len;
+  }
+  else {
+    /* Keep using for loop because `cre` could be removed from the iteration before getting to
+     * the next one. */
+    LISTBASE_FOREACH_MUTABLE (LineartChainRegisterEntry *, cre, &ba->linked_chains) {
+      if (lineart_chain_cre_is_closer(ld,
+                                      cre,
+                                      ec,
+                                      eci,
+                                      occlusion,
+                                      material_mask_bits,
+                                      isec_mask,
+                                      shadow_mask,
+                                      loop_id,
+                                      &dist)) {
+        closest_cre = cre;
       }
     }
   }
@@ -860,11 +1073,17 @@ static LineartChainRegisterEntry *lineart_chain_get_closest_cre(LineartData *ld,
   float adjacent_new_len = dist;
   LineartChainRegisterEntry *adjacent_closest;
 
-#define LRT_TEST_ADJACENT_AREAS(dist_to, list) \
+  /* Chaining runs after occlusion, so the tiles are compacted and adjacent tiles are in one
+   * array, see #LineartBoundingArea::neighbors. */
+  BLI_assert(ba->compacted);
+  LineartBoundingArea **side_neighbors = ba->neighbors;
+
+#define LRT_TEST_ADJACENT_AREAS(dist_to, side) \
   if (dist_to < dist && dist_to > 0) { \
-    LISTBASE_FOREACH (LinkData *, link, list) { \
-      LineartBoundingArea *sba = (LineartBoundingArea *)link->data; \
+    for (int i = 0; i < ba->neighbor_count[side]; i++) { \
+      LineartBoundingArea *sba = side_neighbors[i]; \
       adjacent_closest = lineart_chain_get_closest_cre(ld, \
+                                                       grid, \
                                                        sba, \
                                                        ec, \
                                                        eci, \
@@ -881,12 +1100,14 @@ static LineartChainRegisterEntry *lineart_chain_get_closest_cre(LineartData *ld,
         closest_cre = adjacent_closest; \
       } \
     } \
-  }
+  } \
+  side_neighbors += ba->neighbor_count[side];
+
   if (!caller_ba) {
-    LRT_TEST_ADJACENT_AREAS(eci->pos[0] - ba->l, &ba->lp);
-    LRT_TEST_ADJACENT_AREAS(ba->r - eci->pos[0], &ba->rp);
-    LRT_TEST_ADJACENT_AREAS(ba->u - eci->pos[1], &ba->up);
-    LRT_TEST_ADJACENT_AREAS(eci->pos[1] - ba->b, &ba->bp);
+    LRT_TEST_ADJACENT_AREAS(eci->pos[0] - ba->l, LRT_BA_SIDE_LEFT);
+    LRT_TEST_ADJACENT_AREAS(ba->r - eci->pos[0], LRT_BA_SIDE_RIGHT);
+    LRT_TEST_ADJACENT_AREAS(ba->u - eci->pos[1], LRT_BA_SIDE_UP);
+    LRT_TEST_ADJACENT_AREAS(eci->pos[1] - ba->b, LRT_BA_SIDE_BOTTOM);
   }
   if (result_new_len) {
     (*result_new_len) = dist;
@@ -911,6 +1132,14 @@ void MOD_lineart_chain_connect(LineartData *ld)
     return;
   }
 
+  /* Geometry space distances can't be bounded by image space cells, test every end in the tiles
+   * then. */
+  LineartChainEndGrid grid;
+  LineartChainEndGrid *grid_ptr = NULL;
+  if (!ld->conf.use_geometry_space_chain && lineart_chain_end_grid_build(ld, &grid)) {
+    grid_ptr = &grid;
+  }
+
   swap.first = ld->chains.first;
   swap.last = ld->chains.last;
 
@@ -938,6 +1167,7 @@ void MOD_lineart_chain_connect(LineartData *ld)
     while ((ba_l = lineart_bounding_area_get_end_point(ld, eci_l)) &&
            (ba_r = lineart_bounding_area_get_end_point(ld, eci_r))) {
       closest_cre_l = lineart_chain_get_closest_cre(ld,
+                                                    grid_ptr,
                                                     ba_l,
                                                     ec,
                                                     eci_l,
@@ -950,6 +1180,7 @@ void MOD_lineart_chain_connect(LineartData *ld)
                                                     &dist_l,
                                                     NULL);
       closest_cre_r = lineart_chain_get_closest_cre(ld,
+                                                    grid_ptr,
                                                     ba_r,
                                                     ec,
                                                     eci_r,
@@ -997,6 +1228,10 @@ void MOD_lineart_chain_connect(LineartData *ld)
     }
     ec->picked = 1;
   }
+
+  if (grid_ptr) {
+    lineart_chain_end_grid_free(grid_ptr);
+  }
 }
 
 float MOD_lineart_chain_compute_length(LineartEdgeChain *ec)
@@ -1051,6 +1286,21 @@ void MOD_lineart_chain_clear_picked_flag(LineartCache *lc)
   }
 }
 
+void MOD_lineart_chain_list_copy(ListBase *dst, LineartStaticMemPool *smp, const ListBase *src)
+{
+  LISTBASE_FOREACH (LineartEdgeChain *, ec, src) {
+    LineartEdgeChain *new_ec = lineart_mem_acquire(smp, sizeof(LineartEdgeChain));
+    memcpy(new_ec, ec, sizeof(LineartEdgeChain));
+    BLI_listbase_clear(&new_ec->chain);
+    LISTBASE_FOREACH (LineartEdgeChainItem *, eci, &ec->chain) {
+      LineartEdgeChainItem *new_eci = lineart_mem_acquire(smp, sizeof(LineartEdgeChainItem));
+      memcpy(new_eci, eci, sizeof(LineartEdgeChainItem));
+      BLI_addtail(&new_ec->chain, new_eci);
+    }
+    BLI_addtail(dst, new_ec);
+  }
+}
+
 LineartElementLinkNode *lineart_find_matching_eln_obj(ListBase *elns, struct Object *ob)
 {
   LISTBASE_FOREACH (LineartElementLinkNode *, eln, elns) {
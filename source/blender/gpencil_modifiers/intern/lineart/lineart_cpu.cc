@@ -8,12 +8,19 @@
 #include "MOD_gpencil_lineart.h"
 #include "MOD_lineart.h"
 
+#include "BLI_array.hh"
 #include "BLI_edgehash.h"
+#include "BLI_kdopbvh.h"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_math_vector_types.hh"
+#include "BLI_multi_value_map.hh"
+#include "BLI_set.hh"
+#include "BLI_simd.h"
 #include "BLI_sort.hh"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -72,6 +79,9 @@ struct LineartIsecThread {
   int max;
   int count_test;
 
+  /* Time spent adding triangles, for #LineartData::profile. */
+  double time;
+
   /* For individual thread reference. */
   LineartData *ld;
 };
@@ -82,6 +92,85 @@ struct LineartIsecData {
   int thread_count;
 };
 
+/**
+ * Loaded geometry of one object (or instance), kept between calculations for
+ * #LRT_USE_INCREMENTAL, so the object doesn't have to be loaded again while it doesn't change.
+ * These are copies of the arrays #lineart_geometry_object_load() creates, their pointers still
+ * point into the arrays of the calculation that loaded them, see #lineart_relocate.
+ */
+struct LineartObjectSnapshot {
+  Object *original_ob;
+  float object_to_world[4][4];
+  /** #LineartData::sizeof_triangle of #triangles. */
+  int sizeof_triangle;
+
+  blender::Array<LineartVert> verts;
+  blender::Array<uint8_t> triangles;
+  blender::Array<LineartTriangleAdjacent> triangle_adjacent;
+  blender::Array<LineartEdge> edges;
+  /** Edges that go into #LineartData::pending_edges, as indices into #edges. */
+  blender::Array<int> pending_edges;
+
+  /** Start of the loaded arrays, to relocate the pointers between them. */
+  const void *verts_base;
+  const void *triangles_base;
+  const void *triangle_adjacent_base;
+  const void *edges_base;
+
+  /**
+   * Occlusion of the pending edges, the segments of `pending_edges[i]` are
+   * `segments[segment_offsets[i]]` up to `segments[segment_offsets[i + 1]]`. Empty until the
+   * occlusion of the object was calculated once.
+   */
+  blender::Array<int> segment_offsets;
+  blender::Vector<LineartEdgeSegment> segments;
+  blender::Array<int8_t> min_occ;
+
+  /** Image space bounds of the vertices, occlusion can only change inside of them when the object
+   * changes. */
+  double bounds_min[2], bounds_max[2];
+
+  /** The geometry has been copied, objects without edges are never loaded. */
+  bool loaded;
+  /** The object didn't change, its geometry is restored from the snapshot. */
+  bool reuse;
+
+  /** Vertices and edges of the object in the current calculation. */
+  LineartVert *current_verts;
+  LineartEdge *current_edges;
+};
+
+struct LineartObjectSnapshots {
+  blender::Vector<std::unique_ptr<LineartObjectSnapshot>> items;
+};
+
+/** More changed areas than this are merged into one, to keep testing edges against them cheap. */
+#define LRT_INCREMENTAL_MAX_CHANGED_AREAS 16
+
+/**
+ * State of an incremental calculation. Objects that are found in #previous unchanged are restored
+ * from their snapshots, all others are loaded and copied into new snapshots. Both end up in
+ * #snapshots, which replace the previous ones when the calculation is done.
+ *
+ * Occlusion of an edge only depends on the triangles that overlap it in image space. Edges of
+ * restored objects that don't overlap #changed_areas, the image space bounds of the objects that
+ * were loaded again or removed before and after the change, keep their previous occlusion.
+ */
+struct LineartIncrementalData {
+  /** Snapshots of the previous calculation, moved to #snapshots when they are reused. */
+  blender::Vector<std::unique_ptr<LineartObjectSnapshot>> previous;
+  /** Indices into #previous by original object. */
+  blender::MultiValueMap<Object *, int> previous_by_object;
+
+  blender::Vector<std::unique_ptr<LineartObjectSnapshot>> snapshots;
+
+  /** Image space bounds as `(min x, min y, max x, max y)`. */
+  blender::Vector<blender::double4> changed_areas;
+
+  int reused_object_count;
+  int reused_edge_count;
+};
+
 static void lineart_bounding_area_link_edge(LineartData *ld,
                                             LineartBoundingArea *root_ba,
                                             LineartEdge *e);
@@ -89,17 +178,8 @@ static void lineart_bounding_area_link_edge(LineartData *ld,
 static bool lineart_get_edge_bounding_areas(
     LineartData *ld, LineartEdge *e, int *rowbegin, int *rowend, int *colbegin, int *colend);
 
-static bool lineart_triangle_edge_image_space_occlusion(const LineartTriangle *tri,
-                                                        const LineartEdge *e,
-                                                        const double *override_camera_loc,
-                                                        const bool override_cam_is_persp,
-                                                        const bool allow_overlapping_edges,
-                                                        const double m_view_projection[4][4],
-                                                        const double camera_dir[3],
-                                                        const float cam_shift_x,
-                                                        const float cam_shift_y,
-                                                        double *from,
-                                                        double *to);
+static bool lineart_triangle_edge_bounds_reject(const LineartTriangle *tri,
+                                                const LineartEdge *e);
 
 static void lineart_bounding_area_link_triangle(LineartData *ld,
                                                 LineartBoundingArea *root_ba,
@@ -110,6 +190,8 @@ static void lineart_bounding_area_link_triangle(LineartData *ld,
                                                 bool do_intersection,
                                                 LineartIsecThread *th);
 
+static LineartBoundingArea *lineart_get_bounding_area(LineartData *ld, double x, double y);
+
 static void lineart_free_bounding_area_memory(LineartBoundingArea *ba, bool recursive);
 
 static void lineart_free_bounding_area_memories(LineartData *ld);
@@ -378,14 +460,436 @@ static void lineart_bounding_area_line_add(LineartBoundingArea *ba, LineartEdge
   ba->line_count++;
 }
 
+/**
+ * Screen space bounds of the triangle and the edge don't overlap, or the triangle is entirely
+ * behind the edge, so there can't be any occlusion.
+ */
+static bool lineart_triangle_edge_bounds_reject(const LineartTriangle *tri, const LineartEdge *e)
+{
+  const double *LFBC = e->v1->fbcoord, *RFBC = e->v2->fbcoord, *FBC0 = tri->v[0]->fbcoord,
+               *FBC1 = tri->v[1]->fbcoord, *FBC2 = tri->v[2]->fbcoord;
+
+  return (MAX3(FBC0[0], FBC1[0], FBC2[0]) < MIN2(LFBC[0], RFBC[0])) ||
+         (MIN3(FBC0[0], FBC1[0], FBC2[0]) > MAX2(LFBC[0], RFBC[0])) ||
+         (MAX3(FBC0[1], FBC1[1], FBC2[1]) < MIN2(LFBC[1], RFBC[1])) ||
+         (MIN3(FBC0[1], FBC1[1], FBC2[1]) > MAX2(LFBC[1], RFBC[1])) ||
+         (MIN3(FBC0[3], FBC1[3], FBC2[3]) > MAX2(LFBC[3], RFBC[3]));
+}
+
+static bool lineart_triangle_can_occlude(const LineartTriangle *tri)
+{
+  return !(tri->flags & LRT_TRIANGLE_INTERSECTION_ONLY) &&
+         (tri->mat_occlusion || tri->material_mask_bits);
+}
+
+/* Conversions that round away from the value, so a rejection done in float precision with
+ * #lineart_triangle_bounds_reject_mask always implies the same rejection in double precision. */
+static float lineart_float_round_down(const double d)
+{
+  const float f = float(d);
+  return (double(f) > d) ? nextafterf(f, -INFINITY) : f;
+}
+static float lineart_float_round_up(const double d)
+{
+  const float f = float(d);
+  return (double(f) < d) ? nextafterf(f, INFINITY) : f;
+}
+
+static int lineart_triangle_bounds_stride(const uint32_t triangle_count)
+{
+  return (triangle_count + LRT_TRIANGLE_BOUNDS_WIDTH - 1) / LRT_TRIANGLE_BOUNDS_WIDTH *
+         LRT_TRIANGLE_BOUNDS_WIDTH;
+}
+
+/**
+ * Write the edge functions of #tri at #i of the edge rows starting at #edges. Edge `k` goes from
+ * `v[k]` to `v[k + 1]` and is stored as `x, y, c` with `x * px + y * py + c` positive on the side
+ * of the opposite vertex, scaled so `|x| + |y| = 1`. The last row is the largest absolute screen
+ * coordinate of the triangle, which bounds the rounding error of the constant. Degenerate
+ * triangles get zero functions, which never reject anything.
+ */
+static void lineart_triangle_edge_functions_set(const LineartTriangle *tri,
+                                                float *edges,
+                                                const int stride,
+                                                const int i)
+{
+  const double *FBC[3] = {tri->v[0]->fbcoord, tri->v[1]->fbcoord, tri->v[2]->fbcoord};
+  const double area = (FBC[1][0] - FBC[0][0]) * (FBC[2][1] - FBC[0][1]) -
+                      (FBC[1][1] - FBC[0][1]) * (FBC[2][0] - FBC[0][0]);
+  double extent = 0.0;
+  for (int k = 0; k < 3; k++) {
+    extent = MAX3(extent, fabs(FBC[k][0]), fabs(FBC[k][1]));
+  }
+  const bool degenerate = !isfinite(area) || fabs(area) <= DBL_TRIANGLE_LIM * extent * extent;
+
+  for (int k = 0; k < 3; k++) {
+    float *x = edges + stride * (k * 3) + i, *y = x + stride, *c = y + stride;
+    const double *a = FBC[k], *b = FBC[(k + 1) % 3];
+    double nx = a[1] - b[1], ny = b[0] - a[0];
+    const double scale = fabs(nx) + fabs(ny);
+    if (degenerate || scale == 0.0) {
+      *x = *y = *c = 0.0f;
+      continue;
+    }
+    /* Face the opposite vertex, the winding of the triangle is arbitrary. */
+    nx = (area > 0.0 ? nx : -nx) / scale;
+    ny = (area > 0.0 ? ny : -ny) / scale;
+    *x = float(nx);
+    *y = float(ny);
+    *c = float(-(nx * a[0] + ny * a[1]));
+  }
+  edges[stride * 9 + i] = degenerate ? 0.0f : lineart_float_round_up(extent);
+}
+
+void lineart_bounding_area_build_triangle_bounds(LineartBoundingArea *ba)
+{
+  const int stride = lineart_triangle_bounds_stride(ba->triangle_count);
+  float *min_x = ba->triangle_bounds;
+  float *max_x = min_x + stride, *min_y = max_x + stride, *max_y = min_y + stride,
+        *min_w = max_y + stride;
+
+  for (int i = 0; i < stride; i++) {
+    const LineartTriangle *tri = i < ba->triangle_count ? ba->linked_triangles[i] : nullptr;
+    if (!tri || !lineart_triangle_can_occlude(tri)) {
+      /* Padding and triangles that never occlude get empty bounds. */
+      min_x[i] = min_y[i] = min_w[i] = FLT_MAX;
+      max_x[i] = max_y[i] = -FLT_MAX;
+      for (int row = 0; row < 10; row++) {
+        min_w[stride * (row + 1) + i] = 0.0f;
+      }
+      continue;
+    }
+    const double *FBC0 = tri->v[0]->fbcoord, *FBC1 = tri->v[1]->fbcoord,
+                 *FBC2 = tri->v[2]->fbcoord;
+    min_x[i] = lineart_float_round_down(MIN3(FBC0[0], FBC1[0], FBC2[0]));
+    max_x[i] = lineart_float_round_up(MAX3(FBC0[0], FBC1[0], FBC2[0]));
+    min_y[i] = lineart_float_round_down(MIN3(FBC0[1], FBC1[1], FBC2[1]));
+    max_y[i] = lineart_float_round_up(MAX3(FBC0[1], FBC1[1], FBC2[1]));
+    min_w[i] = lineart_float_round_down(MIN3(FBC0[3], FBC1[3], FBC2[3]));
+    lineart_triangle_edge_functions_set(tri, min_w + stride, stride, i);
+  }
+}
+
+static const ListBase *lineart_bounding_area_side_list(const LineartBoundingArea *ba,
+                                                       const int side)
+{
+  switch (side) {
+    case LRT_BA_SIDE_LEFT:
+      return &ba->lp;
+    case LRT_BA_SIDE_RIGHT:
+      return &ba->rp;
+    case LRT_BA_SIDE_UP:
+      return &ba->up;
+    default:
+      return &ba->bp;
+  }
+}
+
+struct LineartCompactLeaf {
+  LineartBoundingArea *ba;
+  /* Offsets into the contiguous arrays in #LineartData::qtree. */
+  int64_t triangle_offset;
+  int64_t bounds_offset;
+  int64_t neighbor_offset;
+};
+
+static void lineart_bounding_area_collect_leaves(LineartBoundingArea *ba,
+                                                 blender::Vector<LineartCompactLeaf> &leaves)
+{
+  if (ba->child) {
+    for (int i = 0; i < 4; i++) {
+      lineart_bounding_area_collect_leaves(&ba->child[i], leaves);
+    }
+    return;
+  }
+  leaves.append({ba, 0, 0, 0});
+}
+
+struct LineartCompactData {
+  LineartData *ld;
+  LineartCompactLeaf *leaves;
+};
+
+static void lineart_bounding_area_compact_task(void *__restrict userdata,
+                                               const int i,
+                                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  LineartCompactData *data = static_cast<LineartCompactData *>(userdata);
+  LineartData *ld = data->ld;
+  LineartCompactLeaf *leaf = &data->leaves[i];
+  LineartBoundingArea *ba = leaf->ba;
+
+  LineartTriangle **triangles = &ld->qtree.compact_triangles[leaf->triangle_offset];
+  if (ba->triangle_count) {
+    memcpy(triangles, ba->linked_triangles, sizeof(LineartTriangle *) * ba->triangle_count);
+  }
+  if (ba->linked_triangles && !ba->compacted) {
+    MEM_freeN(ba->linked_triangles);
+  }
+  ba->linked_triangles = triangles;
+  ba->max_triangle_count = ba->triangle_count;
+
+  ba->triangle_bounds = &ld->qtree.compact_triangle_bounds[leaf->bounds_offset];
+  lineart_bounding_area_build_triangle_bounds(ba);
+
+  LineartBoundingArea **neighbor = &ld->qtree.compact_neighbors[leaf->neighbor_offset];
+  ba->neighbors = neighbor;
+  for (int side = 0; side < 4; side++) {
+    LISTBASE_FOREACH (LinkData *, lip, lineart_bounding_area_side_list(ba, side)) {
+      *neighbor++ = static_cast<LineartBoundingArea *>(lip->data);
+    }
+  }
+
+  ba->compacted = true;
+}
+
+/**
+ * Once all triangles are inserted, move the triangle arrays, triangle bounds and adjacency of all
+ * leaf tiles into a few contiguous arrays ordered by a depth first walk of the tiles, so that
+ * occlusion and chaining read them linearly. Safe to call again after the first time, the arrays
+ * are rebuilt.
+ */
+static void lineart_main_bounding_areas_compact(LineartData *ld)
+{
+  blender::Vector<LineartCompactLeaf> leaves;
+  for (int i = 0; i < ld->qtree.count_x * ld->qtree.count_y; i++) {
+    lineart_bounding_area_collect_leaves(&ld->qtree.initials[i], leaves);
+  }
+
+  int64_t triangle_total = 0, bounds_total = 0, neighbor_total = 0;
+  for (LineartCompactLeaf &leaf : leaves) {
+    LineartBoundingArea *ba = leaf.ba;
+    leaf.triangle_offset = triangle_total;
+    leaf.bounds_offset = bounds_total;
+    leaf.neighbor_offset = neighbor_total;
+    triangle_total += ba->triangle_count;
+    bounds_total += int64_t(lineart_triangle_bounds_stride(ba->triangle_count)) *
+                    LRT_TRIANGLE_BOUNDS_ROWS;
+    for (int side = 0; side < 4; side++) {
+      ba->neighbor_count[side] = BLI_listbase_count(lineart_bounding_area_side_list(ba, side));
+      neighbor_total += ba->neighbor_count[side];
+    }
+  }
+
+  /* Leaves that were already compacted still reference the previous arrays while copying. */
+  LineartTriangle **old_triangles = ld->qtree.compact_triangles;
+  float *old_bounds = ld->qtree.compact_triangle_bounds;
+  LineartBoundingArea **old_neighbors = ld->qtree.compact_neighbors;
+
+  ld->qtree.compact_triangles = static_cast<LineartTriangle **>(
+      MEM_malloc_arrayN(MAX2(triangle_total, 1), sizeof(LineartTriangle *), __func__));
+  ld->qtree.compact_triangle_bounds = static_cast<float *>(
+      MEM_malloc_arrayN(MAX2(bounds_total, 1), sizeof(float), __func__));
+  ld->qtree.compact_neighbors = static_cast<LineartBoundingArea **>(
+      MEM_malloc_arrayN(MAX2(neighbor_total, 1), sizeof(LineartBoundingArea *), __func__));
+
+  LineartCompactData data = {ld, leaves.data()};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, leaves.size(), &data, lineart_bounding_area_compact_task, &settings);
+
+  MEM_SAFE_FREE(old_triangles);
+  MEM_SAFE_FREE(old_bounds);
+  MEM_SAFE_FREE(old_neighbors);
+}
+
+/**
+ * Find the tile adjacent to #self on #side whose span along that side contains #at. The span is
+ * the vertical one for the left and right sides and the horizontal one for up and bottom.
+ * #include_low decides which end of the span is inclusive.
+ */
+static LineartBoundingArea *lineart_bounding_area_neighbor_at(const LineartBoundingArea *self,
+                                                              const int side,
+                                                              const double at,
+                                                              const bool include_low)
+{
+  const bool vertical_span = ELEM(side, LRT_BA_SIDE_LEFT, LRT_BA_SIDE_RIGHT);
+  auto covers = [&](const LineartBoundingArea *ba) {
+    const double low = vertical_span ? ba->b : ba->l;
+    const double high = vertical_span ? ba->u : ba->r;
+    return include_low ? (high > at && low <= at) : (high >= at && low < at);
+  };
+
+  if (self->compacted) {
+    LineartBoundingArea *const *neighbors = self->neighbors;
+    for (int i = 0; i < side; i++) {
+      neighbors += self->neighbor_count[i];
+    }
+    for (int i = 0; i < self->neighbor_count[side]; i++) {
+      if (covers(neighbors[i])) {
+        return neighbors[i];
+      }
+    }
+    return nullptr;
+  }
+
+  LISTBASE_FOREACH (LinkData *, lip, lineart_bounding_area_side_list(self, side)) {
+    LineartBoundingArea *ba = static_cast<LineartBoundingArea *>(lip->data);
+    if (covers(ba)) {
+      return ba;
+    }
+  }
+  return nullptr;
+}
+
+int lineart_triangle_bounds_reject_mask_scalar(const float *bounds,
+                                               const int stride,
+                                               const int start,
+                                               const float edge_bounds[5])
+{
+  const float *min_x = bounds + start, *max_x = min_x + stride, *min_y = max_x + stride,
+              *max_y = min_y + stride, *min_w = max_y + stride;
+  int mask = 0;
+  for (int i = 0; i < LRT_TRIANGLE_BOUNDS_WIDTH; i++) {
+    if ((max_x[i] < edge_bounds[0]) || (min_x[i] > edge_bounds[1]) ||
+        (max_y[i] < edge_bounds[2]) || (min_y[i] > edge_bounds[3]) ||
+        (min_w[i] > edge_bounds[4])) {
+      mask |= (1 << i);
+    }
+  }
+  return mask;
+}
+
+int lineart_triangle_bounds_reject_mask(const float *bounds,
+                                        const int stride,
+                                        const int start,
+                                        const float edge_bounds[5])
+{
+#ifdef BLI_HAVE_SSE2
+  const float *min_x = bounds + start, *max_x = min_x + stride, *min_y = max_x + stride,
+              *max_y = min_y + stride, *min_w = max_y + stride;
+  __m128 reject = _mm_cmplt_ps(_mm_loadu_ps(max_x), _mm_set1_ps(edge_bounds[0]));
+  reject = _mm_or_ps(reject, _mm_cmpgt_ps(_mm_loadu_ps(min_x), _mm_set1_ps(edge_bounds[1])));
+  reject = _mm_or_ps(reject, _mm_cmplt_ps(_mm_loadu_ps(max_y), _mm_set1_ps(edge_bounds[2])));
+  reject = _mm_or_ps(reject, _mm_cmpgt_ps(_mm_loadu_ps(min_y), _mm_set1_ps(edge_bounds[3])));
+  reject = _mm_or_ps(reject, _mm_cmpgt_ps(_mm_loadu_ps(min_w), _mm_set1_ps(edge_bounds[4])));
+  return _mm_movemask_ps(reject);
+#else
+  return lineart_triangle_bounds_reject_mask_scalar(bounds, stride, start, edge_bounds);
+#endif
+}
+
+/* Relative error allowed for the float edge functions, this covers rounding the edge end points,
+ * the edge function and its evaluation. */
+#define LRT_FLOAT_OCCLUSION_ERROR (8.0f * FLT_EPSILON)
+
+int lineart_triangle_edges_reject_mask_scalar(const float *bounds,
+                                              const int stride,
+                                              const int start,
+                                              const float edge_points[5])
+{
+  const float *edges = bounds + stride * LRT_TRIANGLE_BOUNDS_EDGES_ROW + start;
+  const float *extent = edges + stride * 9;
+  int mask = 0;
+  for (int i = 0; i < LRT_TRIANGLE_BOUNDS_WIDTH; i++) {
+    const float limit = -((extent[i] + edge_points[4]) * LRT_FLOAT_OCCLUSION_ERROR +
+                          float(DBL_LOOSER));
+    for (int k = 0; k < 3; k++) {
+      const float x = edges[stride * (k * 3) + i], y = edges[stride * (k * 3 + 1) + i],
+                  c = edges[stride * (k * 3 + 2) + i];
+      if ((x * edge_points[0] + y * edge_points[1] + c < limit) &&
+          (x * edge_points[2] + y * edge_points[3] + c < limit)) {
+        mask |= (1 << i);
+        break;
+      }
+    }
+  }
+  return mask;
+}
+
+int lineart_triangle_edges_reject_mask(const float *bounds,
+                                       const int stride,
+                                       const int start,
+                                       const float edge_points[5])
+{
+#ifdef BLI_HAVE_SSE2
+  const float *edges = bounds + stride * LRT_TRIANGLE_BOUNDS_EDGES_ROW + start;
+  const float *extent = edges + stride * 9;
+  const __m128 x1 = _mm_set1_ps(edge_points[0]), y1 = _mm_set1_ps(edge_points[1]),
+               x2 = _mm_set1_ps(edge_points[2]), y2 = _mm_set1_ps(edge_points[3]);
+  const __m128 margin = _mm_add_ps(
+      _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(extent), _mm_set1_ps(edge_points[4])),
+                 _mm_set1_ps(LRT_FLOAT_OCCLUSION_ERROR)),
+      _mm_set1_ps(float(DBL_LOOSER)));
+  const __m128 limit = _mm_sub_ps(_mm_setzero_ps(), margin);
+  __m128 reject = _mm_setzero_ps();
+  for (int k = 0; k < 3; k++) {
+    const __m128 x = _mm_loadu_ps(edges + stride * (k * 3));
+    const __m128 y = _mm_loadu_ps(edges + stride * (k * 3 + 1));
+    const __m128 c = _mm_loadu_ps(edges + stride * (k * 3 + 2));
+    const __m128 s1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x1), _mm_mul_ps(y, y1)), c);
+    const __m128 s2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x2), _mm_mul_ps(y, y2)), c);
+    reject = _mm_or_ps(reject, _mm_and_ps(_mm_cmplt_ps(s1, limit), _mm_cmplt_ps(s2, limit)));
+  }
+  return _mm_movemask_ps(reject);
+#else
+  return lineart_triangle_edges_reject_mask_scalar(bounds, stride, start, edge_points);
+#endif
+}
+
+void lineart_edge_reject_data_get(const LineartEdge *e,
+                                  float r_edge_bounds[5],
+                                  float r_edge_points[5])
+{
+  const double *LFBC = e->v1->fbcoord, *RFBC = e->v2->fbcoord;
+  r_edge_bounds[0] = lineart_float_round_down(MIN2(LFBC[0], RFBC[0]));
+  r_edge_bounds[1] = lineart_float_round_up(MAX2(LFBC[0], RFBC[0]));
+  r_edge_bounds[2] = lineart_float_round_down(MIN2(LFBC[1], RFBC[1]));
+  r_edge_bounds[3] = lineart_float_round_up(MAX2(LFBC[1], RFBC[1]));
+  r_edge_bounds[4] = lineart_float_round_up(MAX2(LFBC[3], RFBC[3]));
+  r_edge_points[0] = float(LFBC[0]);
+  r_edge_points[1] = float(LFBC[1]);
+  r_edge_points[2] = float(RFBC[0]);
+  r_edge_points[3] = float(RFBC[1]);
+  r_edge_points[4] = float(MAX4(fabs(LFBC[0]), fabs(LFBC[1]), fabs(RFBC[0]), fabs(RFBC[1])));
+}
+
 static void lineart_occlusion_single_line(LineartData *ld, LineartEdge *e, int thread_id)
 {
   LineartTriangleThread *tri;
   double l, r;
+  float edge_bounds[5], edge_points[5];
+  lineart_edge_reject_data_get(e, edge_bounds, edge_points);
+  /* Projected shadow edges are occluded by their own triangle without any overlap test. */
+  const bool use_edge_functions = !(e->flags & LRT_EDGE_FLAG_PROJECTED_SHADOW);
   LRT_EDGE_BA_MARCHING_BEGIN(e->v1->fbcoord, e->v2->fbcoord)
   {
+    const int stride = lineart_triangle_bounds_stride(nba->triangle_count);
+    int reject_mask = 0, edges_reject_mask = 0;
     for (int i = 0; i < nba->triangle_count; i++) {
+      const int lane = i % LRT_TRIANGLE_BOUNDS_WIDTH;
+      if (lane == 0 && nba->triangle_bounds) {
+        /* Test a batch of triangle bounds against the edge at once. */
+        reject_mask = lineart_triangle_bounds_reject_mask(
+            nba->triangle_bounds, stride, i, edge_bounds);
+        /* Then the edge functions, unless the whole batch is already rejected. */
+        const bool batch_rejected = reject_mask == (1 << LRT_TRIANGLE_BOUNDS_WIDTH) - 1;
+        edges_reject_mask = (use_edge_functions && !batch_rejected) ?
+                                lineart_triangle_edges_reject_mask(
+                                    nba->triangle_bounds, stride, i, edge_points) :
+                                0;
+      }
       tri = (LineartTriangleThread *)nba->linked_triangles[i];
+      if (reject_mask & (1 << lane)) {
+        BLI_assert(!lineart_triangle_can_occlude((const LineartTriangle *)tri) ||
+                   lineart_triangle_edge_bounds_reject((const LineartTriangle *)tri, e));
+        continue;
+      }
+      if (edges_reject_mask & (1 << lane)) {
+        BLI_assert(!lineart_triangle_edge_image_space_occlusion((const LineartTriangle *)tri,
+                                                                e,
+                                                                ld->conf.camera_pos,
+                                                                ld->conf.cam_is_persp,
+                                                                ld->conf.allow_overlapping_edges,
+                                                                ld->conf.view_projection,
+                                                                ld->conf.view_vector,
+                                                                ld->conf.shift_x,
+                                                                ld->conf.shift_y,
+                                                                &l,
+                                                                &r));
+        continue;
+      }
       /* If we are already testing the line in this thread, then don't do it. */
       if (tri->testing_e[thread_id] == e || (tri->base.flags & LRT_TRIANGLE_INTERSECTION_ONLY) ||
           /* Ignore this triangle if an intersection line directly comes from it, */
@@ -420,67 +924,301 @@ static void lineart_occlusion_single_line(LineartData *ld, LineartEdge *e, int t
   LRT_EDGE_BA_MARCHING_END
 }
 
-static int lineart_occlusion_make_task_info(LineartData *ld, LineartRenderTaskInfo *rti)
-{
-  int res = 0;
-  int starting_index;
+struct LineartEdgeCost {
+  float cost;
+  LineartEdge *e;
+};
 
-  BLI_spin_lock(&ld->lock_task);
+struct LineartEdgeCostData {
+  LineartData *ld;
+  LineartEdge **edges;
+  LineartEdgeCost *costs;
+};
 
-  starting_index = ld->scheduled_count;
-  ld->scheduled_count += LRT_THREAD_EDGE_COUNT;
+/**
+ * Estimate how expensive an edge is for occlusion: the triangle density of the tiles around its
+ * end points, times roughly how many tiles it marches through.
+ */
+static void lineart_occlusion_edge_cost_task(void *__restrict userdata,
+                                             const int i,
+                                             const TaskParallelTLS *__restrict /*tls*/)
+{
+  LineartEdgeCostData *data = static_cast<LineartEdgeCostData *>(userdata);
+  LineartData *ld = data->ld;
+  LineartEdge *e = data->edges[i];
+
+  const LineartBoundingArea *ba1 = lineart_get_bounding_area(
+      ld, e->v1->fbcoord[0], e->v1->fbcoord[1]);
+  const LineartBoundingArea *ba2 = lineart_get_bounding_area(
+      ld, e->v2->fbcoord[0], e->v2->fbcoord[1]);
+  const double tile_size = max_dd(MIN2(ba1->r - ba1->l, ba2->r - ba2->l), DBL_EPSILON);
+  const double tiles_crossed = 1.0 + len_v2v2_db(e->v1->fbcoord, e->v2->fbcoord) / tile_size;
+
+  const float cost = float(double(ba1->triangle_count + ba2->triangle_count) * 0.5 *
+                           tiles_crossed);
+  /* Keep the sorting order strict even for degenerate coordinates. */
+  data->costs[i].cost = isfinite(cost) ? cost : 0.0f;
+  data->costs[i].e = e;
+}
 
-  BLI_spin_unlock(&ld->lock_task);
+static bool lineart_occlusion_take_edges(LineartRenderTaskInfo *rti)
+{
+  BLI_spin_lock(&rti->lock);
+  const int begin = rti->queue_begin;
+  const int count = MIN2(rti->queue_end - begin, LRT_THREAD_EDGE_COUNT);
+  if (count > 0) {
+    rti->queue_begin += count;
+  }
+  BLI_spin_unlock(&rti->lock);
 
-  if (starting_index >= ld->pending_edges.next) {
-    res = 0;
+  if (count <= 0) {
+    return false;
   }
-  else {
-    rti->pending_edges.array = &ld->pending_edges.array[starting_index];
-    int remaining = ld->pending_edges.next - starting_index;
-    rti->pending_edges.max = MIN2(remaining, LRT_THREAD_EDGE_COUNT);
-    res = 1;
+  rti->pending_edges.array = &rti->queue[begin];
+  rti->pending_edges.max = count;
+  return true;
+}
+
+/**
+ * Move the cheaper half of the remaining edges of the busiest thread into the (empty) queue of
+ * #rti. Returns false when there's no work left anywhere.
+ */
+static bool lineart_occlusion_steal_edges(LineartRenderTaskInfo *rti)
+{
+  while (true) {
+    LineartRenderTaskInfo *victim = nullptr;
+    int victim_remaining = 0;
+    for (int i = 0; i < rti->task_count; i++) {
+      LineartRenderTaskInfo *other = &rti->all_tasks[i];
+      if (other == rti) {
+        continue;
+      }
+      BLI_spin_lock(&other->lock);
+      const int remaining = other->queue_end - other->queue_begin;
+      BLI_spin_unlock(&other->lock);
+      if (remaining > victim_remaining) {
+        victim = other;
+        victim_remaining = remaining;
+      }
+    }
+    if (!victim) {
+      return false;
+    }
+
+    BLI_spin_lock(&victim->lock);
+    const int remaining = victim->queue_end - victim->queue_begin;
+    if (remaining <= 0) {
+      /* Another thread got there first, look again. */
+      BLI_spin_unlock(&victim->lock);
+      continue;
+    }
+    const int steal = (remaining + 1) / 2;
+    const int end = victim->queue_end;
+    victim->queue_end -= steal;
+    BLI_spin_unlock(&victim->lock);
+
+    BLI_spin_lock(&rti->lock);
+    rti->queue_begin = end - steal;
+    rti->queue_end = end;
+    BLI_spin_unlock(&rti->lock);
+
+    rti->steal_count++;
+    return true;
   }
+}
 
-  return res;
+static bool lineart_occlusion_make_task_info(LineartRenderTaskInfo *rti)
+{
+  if (lineart_occlusion_take_edges(rti)) {
+    return true;
+  }
+  return lineart_occlusion_steal_edges(rti) && lineart_occlusion_take_edges(rti);
 }
 
 static void lineart_occlusion_worker(TaskPool *__restrict /*pool*/, LineartRenderTaskInfo *rti)
 {
   LineartData *ld = rti->ld;
   LineartEdge *eip;
+  const double t_start = PIL_check_seconds_timer();
 
-  while (lineart_occlusion_make_task_info(ld, rti)) {
+  while (lineart_occlusion_make_task_info(rti)) {
     for (int i = 0; i < rti->pending_edges.max; i++) {
       eip = rti->pending_edges.array[i];
       lineart_occlusion_single_line(ld, eip, rti->thread_id);
     }
+    rti->edge_count += rti->pending_edges.max;
+  }
+
+  rti->time = PIL_check_seconds_timer() - t_start;
+}
+
+static bool lineart_incremental_edge_is_changed(const LineartIncrementalData &incremental,
+                                                const LineartEdge *e)
+{
+  const double *fbc1 = e->v1->fbcoord, *fbc2 = e->v2->fbcoord;
+  const double min_x = MIN2(fbc1[0], fbc2[0]), max_x = MAX2(fbc1[0], fbc2[0]);
+  const double min_y = MIN2(fbc1[1], fbc2[1]), max_y = MAX2(fbc1[1], fbc2[1]);
+  for (const blender::double4 &area : incremental.changed_areas) {
+    /* Written so that NaN coordinates count as changed. */
+    if (!(max_x < area[0] || max_y < area[1] || min_x > area[2] || min_y > area[3])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Give the edges of restored objects that don't overlap any changed area their occlusion from the
+ * previous calculation. Returns the edges whose occlusion still has to be calculated.
+ */
+static blender::Vector<LineartEdge *> lineart_incremental_reuse_occlusion(LineartData *ld)
+{
+  using namespace blender;
+  LineartIncrementalData &incremental = *ld->incremental;
+  Set<const LineartEdge *> reused;
+  for (std::unique_ptr<LineartObjectSnapshot> &snapshot : incremental.snapshots) {
+    if (!snapshot->reuse || snapshot->segment_offsets.is_empty()) {
+      continue;
+    }
+    for (const int i : snapshot->pending_edges.index_range()) {
+      LineartEdge *e = &snapshot->current_edges[snapshot->pending_edges[i]];
+      if (lineart_incremental_edge_is_changed(incremental, e)) {
+        continue;
+      }
+      const IndexRange range(snapshot->segment_offsets[i],
+                             snapshot->segment_offsets[i + 1] - snapshot->segment_offsets[i]);
+      LineartEdgeSegment *es = static_cast<LineartEdgeSegment *>(
+          lineart_mem_acquire(ld->edge_data_pool, sizeof(LineartEdgeSegment) * range.size()));
+      BLI_listbase_clear(&e->segments);
+      for (const int j : IndexRange(range.size())) {
+        es[j] = snapshot->segments[range[j]];
+        BLI_addtail(&e->segments, &es[j]);
+      }
+      e->min_occ = snapshot->min_occ[i];
+      reused.add(e);
+    }
+  }
+  incremental.reused_edge_count = int(reused.size());
+
+  Vector<LineartEdge *> edges;
+  edges.reserve(ld->pending_edges.next - reused.size());
+  for (const int i : IndexRange(ld->pending_edges.next)) {
+    if (!reused.contains(ld->pending_edges.array[i])) {
+      edges.append(ld->pending_edges.array[i]);
+    }
   }
+  return edges;
 }
 
 /**
  * All internal functions starting with lineart_main_ is called inside
  * #MOD_lineart_compute_feature_lines function.
  * This function handles all occlusion calculation.
+ *
+ * Edges are sorted from the most to the least expensive (see
+ * #lineart_occlusion_edge_cost_task) and dealt out to per-thread queues, threads that run out of
+ * work steal from the busiest one.
  */
 void lineart_main_occlusion_begin(LineartData *ld)
 {
   int thread_count = ld->thread_count;
+  int i;
+
+  /* Triangles are all linked into tiles by now, flatten the tiles and prepare the triangle bounds
+   * for batched rejection. */
+  double t_stage = PIL_check_seconds_timer();
+  lineart_main_bounding_areas_compact(ld);
+  lineart_profile_stage_end(ld, LRT_PROFILE_QUADTREE, t_stage);
+  t_stage = PIL_check_seconds_timer();
+
+  blender::Vector<LineartEdge *> changed_edges;
+  LineartEdge **edges = ld->pending_edges.array;
+  int edge_count = ld->pending_edges.next;
+  if (ld->incremental) {
+    changed_edges = lineart_incremental_reuse_occlusion(ld);
+    edges = changed_edges.data();
+    edge_count = int(changed_edges.size());
+  }
+
+  if (!edge_count) {
+    lineart_profile_stage_end(ld, LRT_PROFILE_OCCLUSION, t_stage);
+    return;
+  }
+
+  LineartEdgeCost *costs = static_cast<LineartEdgeCost *>(
+      MEM_malloc_arrayN(edge_count, sizeof(LineartEdgeCost), __func__));
+  LineartEdgeCostData cost_data = {ld, edges, costs};
+  TaskParallelSettings cost_settings;
+  BLI_parallel_range_settings_defaults(&cost_settings);
+  cost_settings.min_iter_per_thread = 10000;
+  BLI_task_parallel_range(
+      0, edge_count, &cost_data, lineart_occlusion_edge_cost_task, &cost_settings);
+
+  blender::parallel_sort(
+      costs, costs + edge_count, [](const LineartEdgeCost &a, const LineartEdgeCost &b) {
+        return a.cost > b.cost;
+      });
+
+  /* Deal sorted edges to the threads in turns so every queue starts with a similar amount of
+   * work, each one still ordered from the most expensive edge. */
+  LineartEdge **queue = static_cast<LineartEdge **>(
+      MEM_malloc_arrayN(edge_count, sizeof(LineartEdge *), __func__));
   LineartRenderTaskInfo *rti = static_cast<LineartRenderTaskInfo *>(
       MEM_callocN(sizeof(LineartRenderTaskInfo) * thread_count, __func__));
-  int i;
+  const int per_thread = edge_count / thread_count, extra = edge_count % thread_count;
+  for (i = 0; i < thread_count; i++) {
+    rti[i].queue = queue;
+    rti[i].queue_begin = i * per_thread + MIN2(i, extra);
+    rti[i].queue_end = rti[i].queue_begin + per_thread + (i < extra ? 1 : 0);
+  }
+  for (int k = 0; k < edge_count; k++) {
+    LineartRenderTaskInfo *owner = &rti[k % thread_count];
+    queue[owner->queue_begin + k / thread_count] = costs[k].e;
+  }
+  MEM_freeN(costs);
 
   TaskPool *tp = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
 
   for (i = 0; i < thread_count; i++) {
     rti[i].thread_id = i;
     rti[i].ld = ld;
+    rti[i].all_tasks = rti;
+    rti[i].task_count = thread_count;
+    BLI_spin_init(&rti[i].lock);
     BLI_task_pool_push(tp, (TaskRunFunction)lineart_occlusion_worker, &rti[i], false, nullptr);
   }
   BLI_task_pool_work_and_wait(tp);
   BLI_task_pool_free(tp);
 
+  double max_time = 0, total_time = 0;
+  for (i = 0; i < thread_count; i++) {
+    max_time = max_dd(max_time, rti[i].time);
+    total_time += rti[i].time;
+  }
+  if (ld->profile) {
+    ld->profile->stages[LRT_PROFILE_OCCLUSION].thread_time += total_time;
+  }
+  lineart_profile_stage_end(ld, LRT_PROFILE_OCCLUSION, t_stage);
+
+  if (G.debug_value == 4000) {
+    for (i = 0; i < thread_count; i++) {
+      printf("Thread %d occlusion: %d edges, %d steals, %f s\n",
+             i,
+             rti[i].edge_count,
+             rti[i].steal_count,
+             rti[i].time);
+    }
+    if (total_time > 0) {
+      printf("Line art occlusion load imbalance (slowest / average thread): %f\n",
+             max_time * thread_count / total_time);
+    }
+  }
+
+  for (i = 0; i < thread_count; i++) {
+    BLI_spin_end(&rti[i].lock);
+  }
   MEM_freeN(rti);
+  MEM_freeN(queue);
 }
 
 /**
@@ -1947,6 +2685,159 @@ static LineartEdgeNeighbor *lineart_build_edge_neighbor(Mesh *me, int total_edge
   return edge_nabr;
 }
 
+/**
+ * Move a pointer into the array that started at `old_base` to the same element of the array at
+ * `new_base`.
+ */
+template<typename T>
+static T *lineart_relocate(const T *ptr, const void *old_base, const void *new_base)
+{
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  const uintptr_t offset = uintptr_t(ptr) - uintptr_t(old_base);
+  return reinterpret_cast<T *>(uintptr_t(new_base) + offset);
+}
+
+/** Copy what #lineart_geometry_object_load() created for the object into its snapshot. */
+static void lineart_incremental_snapshot_fill(LineartObjectInfo *obi,
+                                              LineartData *ld,
+                                              const LineartVert *v_arr,
+                                              const int v_count,
+                                              const LineartTriangle *tri_arr,
+                                              const int tri_count,
+                                              const LineartTriangleAdjacent *tri_adj,
+                                              const LineartEdge *e_arr,
+                                              const int e_count)
+{
+  using namespace blender;
+  LineartObjectSnapshot &snapshot = *obi->snapshot;
+  snapshot.sizeof_triangle = ld->sizeof_triangle;
+  snapshot.verts = Span<LineartVert>(v_arr, v_count);
+  snapshot.triangles = Span<uint8_t>(reinterpret_cast<const uint8_t *>(tri_arr),
+                                     int64_t(tri_count) * ld->sizeof_triangle);
+  snapshot.triangle_adjacent = Span<LineartTriangleAdjacent>(tri_adj, tri_count);
+  snapshot.edges = Span<LineartEdge>(e_arr, e_count);
+  snapshot.pending_edges.reinitialize(obi->pending_edges.next);
+  for (const int i : snapshot.pending_edges.index_range()) {
+    snapshot.pending_edges[i] = int(obi->pending_edges.array[i] - e_arr);
+  }
+  snapshot.verts_base = v_arr;
+  snapshot.triangles_base = tri_arr;
+  snapshot.triangle_adjacent_base = tri_adj;
+  snapshot.edges_base = e_arr;
+  snapshot.segment_offsets = {};
+  snapshot.segments.clear();
+  snapshot.min_occ = {};
+  snapshot.loaded = true;
+  snapshot.current_verts = const_cast<LineartVert *>(v_arr);
+  snapshot.current_edges = const_cast<LineartEdge *>(e_arr);
+}
+
+/**
+ * Create the same data as #lineart_geometry_object_load() from the snapshot of an object that
+ * didn't change since it was loaded.
+ */
+static void lineart_incremental_snapshot_restore(LineartObjectInfo *obi, LineartData *ld)
+{
+  using namespace blender;
+  LineartObjectSnapshot &snapshot = *obi->snapshot;
+  BLI_assert(snapshot.sizeof_triangle == ld->sizeof_triangle);
+  const int v_count = int(snapshot.verts.size());
+  const int tri_count = int(snapshot.triangle_adjacent.size());
+  const int e_count = int(snapshot.edges.size());
+  Object *orig_ob = obi->original_ob;
+
+  LineartVert *v_arr = static_cast<LineartVert *>(
+      lineart_mem_acquire_thread(&ld->render_data_pool, sizeof(LineartVert) * v_count));
+  memcpy(v_arr, snapshot.verts.data(), sizeof(LineartVert) * v_count);
+  LineartTriangle *tri_arr = static_cast<LineartTriangle *>(
+      lineart_mem_acquire_thread(&ld->render_data_pool, snapshot.triangles.size()));
+  memcpy(tri_arr, snapshot.triangles.data(), snapshot.triangles.size());
+
+  BLI_spin_lock(&ld->lock_task);
+  LineartElementLinkNode *v_eln = static_cast<LineartElementLinkNode *>(
+      lineart_list_append_pointer_pool_sized_thread(&ld->geom.vertex_buffer_pointers,
+                                                    &ld->render_data_pool,
+                                                    v_arr,
+                                                    sizeof(LineartElementLinkNode)));
+  LineartElementLinkNode *tri_eln = static_cast<LineartElementLinkNode *>(
+      lineart_list_append_pointer_pool_sized_thread(&ld->geom.triangle_buffer_pointers,
+                                                    &ld->render_data_pool,
+                                                    tri_arr,
+                                                    sizeof(LineartElementLinkNode)));
+  BLI_spin_unlock(&ld->lock_task);
+
+  v_eln->obindex = obi->obindex;
+  v_eln->element_count = v_count;
+  v_eln->object_ref = orig_ob;
+  if (orig_ob->type == OB_FONT) {
+    v_eln->flags |= LRT_ELEMENT_BORDER_ONLY;
+  }
+  obi->v_eln = v_eln;
+
+  tri_eln->element_count = tri_count;
+  tri_eln->object_ref = orig_ob;
+  tri_eln->flags = eLineArtElementNodeFlag(
+      tri_eln->flags |
+      ((obi->usage == OBJECT_LRT_NO_INTERSECTION) ? LRT_ELEMENT_NO_INTERSECTION : 0));
+
+  /* Note this memory is not from pool, will be deleted after culling. */
+  LineartTriangleAdjacent *tri_adj = static_cast<LineartTriangleAdjacent *>(
+      MEM_malloc_arrayN(tri_count, sizeof(LineartTriangleAdjacent), "LineartTriangleAdjacent"));
+  memcpy(tri_adj, snapshot.triangle_adjacent.data(), sizeof(LineartTriangleAdjacent) * tri_count);
+  BLI_spin_lock(&ld->lock_task);
+  lineart_list_append_pointer_pool_thread(
+      &ld->geom.triangle_adjacent_pointers, &ld->render_data_pool, tri_adj);
+  BLI_spin_unlock(&ld->lock_task);
+
+  LineartEdge *e_arr = static_cast<LineartEdge *>(
+      lineart_mem_acquire_thread(ld->edge_data_pool, sizeof(LineartEdge) * e_count));
+  memcpy(e_arr, snapshot.edges.data(), sizeof(LineartEdge) * e_count);
+  LineartEdgeSegment *seg_arr = static_cast<LineartEdgeSegment *>(
+      lineart_mem_acquire_thread(ld->edge_data_pool, sizeof(LineartEdgeSegment) * e_count));
+  BLI_spin_lock(&ld->lock_task);
+  LineartElementLinkNode *e_eln = static_cast<LineartElementLinkNode *>(
+      lineart_list_append_pointer_pool_sized_thread(&ld->geom.line_buffer_pointers,
+                                                    ld->edge_data_pool,
+                                                    e_arr,
+                                                    sizeof(LineartElementLinkNode)));
+  BLI_spin_unlock(&ld->lock_task);
+  e_eln->element_count = e_count;
+  e_eln->object_ref = orig_ob;
+  e_eln->obindex = obi->obindex;
+
+  /* The object index can differ when other objects were added or removed. */
+  for (const int i : IndexRange(tri_count)) {
+    LineartTriangle *tri = lineart_triangle_from_index(ld, tri_arr, i);
+    for (int k = 0; k < 3; k++) {
+      tri->v[k] = lineart_relocate(tri->v[k], snapshot.verts_base, v_arr);
+    }
+    tri->target_reference = (obi->obindex | (i & LRT_OBINDEX_LOWER));
+    /* Re-use this field to refer to adjacent info, will be cleared after culling stage. */
+    tri->intersecting_verts = static_cast<LinkNode *>((void *)&tri_adj[i]);
+    for (int k = 0; k < 3; k++) {
+      tri_adj[i].e[k] = lineart_relocate(tri_adj[i].e[k], snapshot.edges_base, e_arr);
+    }
+  }
+  for (const int i : IndexRange(e_count)) {
+    LineartEdge *e = &e_arr[i];
+    e->v1 = lineart_relocate(e->v1, snapshot.verts_base, v_arr);
+    e->v2 = lineart_relocate(e->v2, snapshot.verts_base, v_arr);
+    e->t1 = lineart_relocate(e->t1, snapshot.triangles_base, tri_arr);
+    e->t2 = lineart_relocate(e->t2, snapshot.triangles_base, tri_arr);
+    e->edge_identifier = LRT_EDGE_IDENTIFIER(obi, e);
+    BLI_listbase_clear(&e->segments);
+    BLI_addtail(&e->segments, &seg_arr[i]);
+  }
+  for (const int i : snapshot.pending_edges) {
+    lineart_add_edge_to_array_thread(obi, &e_arr[i]);
+  }
+
+  snapshot.current_verts = v_arr;
+  snapshot.current_edges = e_arr;
+}
+
 static void lineart_geometry_object_load(LineartObjectInfo *ob_info,
                                          LineartData *la_data,
                                          ListBase *shadow_elns)
@@ -2283,6 +3174,18 @@ static void lineart_geometry_object_load(LineartObjectInfo *ob_info,
 
   MEM_freeN(edge_feat_data.edge_nabr);
 
+  if (ob_info->snapshot) {
+    lineart_incremental_snapshot_fill(ob_info,
+                                      la_data,
+                                      la_v_arr,
+                                      me->totvert,
+                                      la_tri_arr,
+                                      int(looptris.size()),
+                                      tri_adj,
+                                      la_edge_arr,
+                                      allocate_la_e);
+  }
+
   if (ob_info->free_use_mesh) {
     BKE_id_free(nullptr, me);
   }
@@ -2292,7 +3195,12 @@ static void lineart_object_load_worker(TaskPool *__restrict /*pool*/,
                                        LineartObjectLoadTaskInfo *olti)
 {
   for (LineartObjectInfo *obi = olti->pending; obi; obi = obi->next) {
-    lineart_geometry_object_load(obi, olti->ld, olti->shadow_elns);
+    if (obi->snapshot && obi->snapshot->reuse) {
+      lineart_incremental_snapshot_restore(obi, olti->ld);
+    }
+    else {
+      lineart_geometry_object_load(obi, olti->ld, olti->shadow_elns);
+    }
   }
 }
 
@@ -2448,7 +3356,62 @@ static bool lineart_geometry_check_visible(double model_view_proj[4][4],
   return true;
 }
 
-static void lineart_object_load_single_instance(LineartData *ld,
+static bool lineart_incremental_materials_tagged(Object *eval_ob)
+{
+  const int materials_num = BKE_object_material_count_eval(eval_ob);
+  for (int i = 0; i < materials_num; i++) {
+    const Material *ma = BKE_object_material_get_eval(eval_ob, i + 1);
+    if (ma && ma->id.recalc) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Whether the object or one of its materials is tagged for an update in this evaluation. */
+static bool lineart_incremental_object_is_tagged(Object *eval_ob)
+{
+  return (eval_ob->id.recalc & ID_RECALC_GEOMETRY) ||
+         lineart_incremental_materials_tagged(eval_ob);
+}
+
+/**
+ * Find the snapshot of an instance of `original_ob` that was loaded with the same transform in
+ * the previous calculation and move it to the snapshots of this one.
+ */
+static LineartObjectSnapshot *lineart_incremental_snapshot_reuse(LineartData *ld,
+                                                                 Object *original_ob,
+                                                                 float object_to_world[4][4])
+{
+  LineartIncrementalData &incremental = *ld->incremental;
+  for (const int i : incremental.previous_by_object.lookup(original_ob)) {
+    std::unique_ptr<LineartObjectSnapshot> &snapshot = incremental.previous[i];
+    if (!snapshot || !snapshot->loaded || snapshot->sizeof_triangle != ld->sizeof_triangle ||
+        !equals_m4m4(snapshot->object_to_world, object_to_world)) {
+      continue;
+    }
+    snapshot->reuse = true;
+    incremental.snapshots.append(std::move(snapshot));
+    incremental.reused_object_count++;
+    return incremental.snapshots.last().get();
+  }
+  return nullptr;
+}
+
+/** A new snapshot, filled when the object is loaded. */
+static LineartObjectSnapshot *lineart_incremental_snapshot_add(LineartData *ld,
+                                                               Object *original_ob,
+                                                               float object_to_world[4][4])
+{
+  std::unique_ptr<LineartObjectSnapshot> snapshot = std::make_unique<LineartObjectSnapshot>();
+  snapshot->original_ob = original_ob;
+  copy_m4_m4(snapshot->object_to_world, object_to_world);
+  INIT_MINMAX2(snapshot->bounds_min, snapshot->bounds_max);
+  ld->incremental->snapshots.append(std::move(snapshot));
+  return ld->incremental->snapshots.last().get();
+}
+
+static void lineart_object_load_single_instance(LineartData *ld,
                                                 Depsgraph *depsgraph,
                                                 Scene *scene,
                                                 Object *ob,
@@ -2480,6 +3443,7 @@ static void lineart_object_load_single_instance(LineartData *ld,
   if (!ELEM(ob->type, OB_MESH, OB_MBALL, OB_CURVES_LEGACY, OB_SURF, OB_FONT)) {
     return;
   }
+
   if (ob->type == OB_MESH) {
     use_mesh = BKE_object_get_evaluated_mesh(ob);
     if ((!use_mesh) || use_mesh->edit_mesh) {
@@ -2489,7 +3453,21 @@ static void lineart_object_load_single_instance(LineartData *ld,
       return;
     }
   }
-  else {
+
+  Object *original_ob = (ref_ob->id.orig_id ? (Object *)ref_ob->id.orig_id : (Object *)ref_ob);
+  if (ld->incremental && !lineart_incremental_object_is_tagged(ob)) {
+    /* Restore the object from the previous calculation instead of loading its mesh. */
+    obi->snapshot = lineart_incremental_snapshot_reuse(ld, original_ob, use_mat);
+    if (obi->snapshot) {
+      obi->original_ob = original_ob;
+      obi->original_ob_eval = DEG_get_evaluated_object(depsgraph, original_ob);
+      lineart_geometry_load_assign_thread(
+          olti, obi, thread_count, int(obi->snapshot->triangle_adjacent.size()));
+      return;
+    }
+  }
+
+  if (ob->type != OB_MESH) {
     use_mesh = BKE_mesh_new_from_object(depsgraph, ob, true, true);
   }
 
@@ -2514,8 +3492,11 @@ static void lineart_object_load_single_instance(LineartData *ld,
   copy_m4d_m4(obi->normal, imat);
 
   obi->original_me = use_mesh;
-  obi->original_ob = (ref_ob->id.orig_id ? (Object *)ref_ob->id.orig_id : (Object *)ref_ob);
+  obi->original_ob = original_ob;
   obi->original_ob_eval = DEG_get_evaluated_object(depsgraph, obi->original_ob);
+  if (ld->incremental) {
+    obi->snapshot = lineart_incremental_snapshot_add(ld, original_ob, use_mat);
+  }
   lineart_geometry_load_assign_thread(olti, obi, thread_count, use_mesh->totpoly);
 }
 
@@ -2799,17 +3780,17 @@ bool lineart_edge_from_triangle(const LineartTriangle *tri,
  * While current "edge aligned" fix isn't ideal, it does solve most of the precision issue
  * especially in orthographic camera mode.
  */
-static bool lineart_triangle_edge_image_space_occlusion(const LineartTriangle *tri,
-                                                        const LineartEdge *e,
-                                                        const double *override_camera_loc,
-                                                        const bool override_cam_is_persp,
-                                                        const bool allow_overlapping_edges,
-                                                        const double m_view_projection[4][4],
-                                                        const double camera_dir[3],
-                                                        const float cam_shift_x,
-                                                        const float cam_shift_y,
-                                                        double *from,
-                                                        double *to)
+bool lineart_triangle_edge_image_space_occlusion(const LineartTriangle *tri,
+                                                 const LineartEdge *e,
+                                                 const double *override_camera_loc,
+                                                 const bool override_cam_is_persp,
+                                                 const bool allow_overlapping_edges,
+                                                 const double m_view_projection[4][4],
+                                                 const double camera_dir[3],
+                                                 const float cam_shift_x,
+                                                 const float cam_shift_y,
+                                                 double *from,
+                                                 double *to)
 {
   double cross_ratios[3] = {0};
   int cross_order[3];
@@ -2833,11 +3814,7 @@ static bool lineart_triangle_edge_image_space_occlusion(const LineartTriangle *t
          *FBC1 = tri->v[1]->fbcoord, *FBC2 = tri->v[2]->fbcoord;
 
   /* Overlapping not possible, return early. */
-  if ((MAX3(FBC0[0], FBC1[0], FBC2[0]) < MIN2(LFBC[0], RFBC[0])) ||
-      (MIN3(FBC0[0], FBC1[0], FBC2[0]) > MAX2(LFBC[0], RFBC[0])) ||
-      (MAX3(FBC0[1], FBC1[1], FBC2[1]) < MIN2(LFBC[1], RFBC[1])) ||
-      (MIN3(FBC0[1], FBC1[1], FBC2[1]) > MAX2(LFBC[1], RFBC[1])) ||
-      (MIN3(FBC0[3], FBC1[3], FBC2[3]) > MAX2(LFBC[3], RFBC[3]))) {
+  if (lineart_triangle_edge_bounds_reject(tri, e)) {
     return false;
   }
 
@@ -3382,6 +4359,44 @@ static void lineart_destroy_isec_thread(LineartIsecData *d)
   MEM_freeN(d->threads);
 }
 
+/**
+ * Test a pair of triangles and record their intersection line in #th, shared by the tile based and
+ * the BVH based intersection stages.
+ */
+static void lineart_triangle_pair_intersect(LineartTriangle *tri,
+                                            LineartTriangle *testing_triangle,
+                                            LineartIsecThread *th)
+{
+  if (!((testing_triangle->flags | tri->flags) & LRT_TRIANGLE_FORCE_INTERSECTION)) {
+    if (((testing_triangle->flags | tri->flags) & LRT_TRIANGLE_NO_INTERSECTION) ||
+        (testing_triangle->flags & tri->flags & LRT_TRIANGLE_INTERSECTION_ONLY)) {
+      return;
+    }
+  }
+
+  double *G0 = tri->v[0]->gloc, *G1 = tri->v[1]->gloc, *G2 = tri->v[2]->gloc;
+  double *RG0 = testing_triangle->v[0]->gloc, *RG1 = testing_triangle->v[1]->gloc,
+         *RG2 = testing_triangle->v[2]->gloc;
+
+  /* Bounding box not overlapping or triangles share edges, not potential of intersecting. */
+  if ((MIN3(G0[2], G1[2], G2[2]) > MAX3(RG0[2], RG1[2], RG2[2])) ||
+      (MAX3(G0[2], G1[2], G2[2]) < MIN3(RG0[2], RG1[2], RG2[2])) ||
+      (MIN3(G0[0], G1[0], G2[0]) > MAX3(RG0[0], RG1[0], RG2[0])) ||
+      (MAX3(G0[0], G1[0], G2[0]) < MIN3(RG0[0], RG1[0], RG2[0])) ||
+      (MIN3(G0[1], G1[1], G2[1]) > MAX3(RG0[1], RG1[1], RG2[1])) ||
+      (MAX3(G0[1], G1[1], G2[1]) < MIN3(RG0[1], RG1[1], RG2[1])) ||
+      lineart_triangle_share_edge(tri, testing_triangle)) {
+    return;
+  }
+
+  /* If we do need to compute intersection, then finally do it. */
+
+  double iv1[3], iv2[3];
+  if (lineart_triangle_intersect_math(tri, testing_triangle, iv1, iv2)) {
+    lineart_add_isec_thread(th, iv1, iv2, tri, testing_triangle);
+  }
+}
+
 static void lineart_triangle_intersect_in_bounding_area(LineartTriangle *tri,
                                                         LineartBoundingArea *ba,
                                                         LineartIsecThread *th,
@@ -3393,8 +4408,6 @@ static void lineart_triangle_intersect_in_bounding_area(LineartTriangle *tri,
     return;
   }
 
-  double *G0 = tri->v[0]->gloc, *G1 = tri->v[1]->gloc, *G2 = tri->v[2]->gloc;
-
   /* If this _is_ the smallest subdivision bounding area, then do the intersections there. */
   for (int i = 0; i < up_to; i++) {
     /* Testing_triangle->testing[0] is used to store pairing triangle reference.
@@ -3407,33 +4420,7 @@ static void lineart_triangle_intersect_in_bounding_area(LineartTriangle *tri,
     }
     tt->testing_e[th->thread_id] = (LineartEdge *)tri;
 
-    if (!((testing_triangle->flags | tri->flags) & LRT_TRIANGLE_FORCE_INTERSECTION)) {
-      if (((testing_triangle->flags | tri->flags) & LRT_TRIANGLE_NO_INTERSECTION) ||
-          (testing_triangle->flags & tri->flags & LRT_TRIANGLE_INTERSECTION_ONLY)) {
-        continue;
-      }
-    }
-
-    double *RG0 = testing_triangle->v[0]->gloc, *RG1 = testing_triangle->v[1]->gloc,
-           *RG2 = testing_triangle->v[2]->gloc;
-
-    /* Bounding box not overlapping or triangles share edges, not potential of intersecting. */
-    if ((MIN3(G0[2], G1[2], G2[2]) > MAX3(RG0[2], RG1[2], RG2[2])) ||
-        (MAX3(G0[2], G1[2], G2[2]) < MIN3(RG0[2], RG1[2], RG2[2])) ||
-        (MIN3(G0[0], G1[0], G2[0]) > MAX3(RG0[0], RG1[0], RG2[0])) ||
-        (MAX3(G0[0], G1[0], G2[0]) < MIN3(RG0[0], RG1[0], RG2[0])) ||
-        (MIN3(G0[1], G1[1], G2[1]) > MAX3(RG0[1], RG1[1], RG2[1])) ||
-        (MAX3(G0[1], G1[1], G2[1]) < MIN3(RG0[1], RG1[1], RG2[1])) ||
-        lineart_triangle_share_edge(tri, testing_triangle)) {
-      continue;
-    }
-
-    /* If we do need to compute intersection, then finally do it. */
-
-    double iv1[3], iv2[3];
-    if (lineart_triangle_intersect_math(tri, testing_triangle, iv1, iv2)) {
-      lineart_add_isec_thread(th, iv1, iv2, tri, testing_triangle);
-    }
+    lineart_triangle_pair_intersect(tri, testing_triangle, th);
   }
 }
 
@@ -3661,6 +4648,7 @@ static LineartData *lineart_create_render_buffer(Scene *scene,
   ld->conf.use_material = (edge_types & LRT_EDGE_FLAG_MATERIAL) != 0;
   ld->conf.use_edge_marks = (edge_types & LRT_EDGE_FLAG_EDGE_MARK) != 0;
   ld->conf.use_intersections = (edge_types & LRT_EDGE_FLAG_INTERSECTION) != 0;
+  ld->conf.use_bvh_intersections = (lmd->calculation_flags & LRT_USE_BVH_INTERSECTION) != 0;
   ld->conf.use_loose = (edge_types & LRT_EDGE_FLAG_LOOSE) != 0;
   ld->conf.use_light_contour = ((edge_types & LRT_EDGE_FLAG_LIGHT_CONTOUR) != 0 &&
                                 (lmd->light_contour_object != nullptr));
@@ -4221,7 +5209,8 @@ static void lineart_free_bounding_area_memory(LineartBoundingArea *ba, bool recu
   if (ba->linked_lines) {
     MEM_freeN(ba->linked_lines);
   }
-  if (ba->linked_triangles) {
+  /* Compacted tiles point into the arrays in #LineartData::qtree. */
+  if (ba->linked_triangles && !ba->compacted) {
     MEM_freeN(ba->linked_triangles);
   }
   if (recursive && ba->child) {
@@ -4237,6 +5226,9 @@ static void lineart_free_bounding_area_memories(LineartData *ld)
       lineart_free_bounding_area_memory(&ld->qtree.initials[i * ld->qtree.count_x + j], true);
     }
   }
+  MEM_SAFE_FREE(ld->qtree.compact_triangles);
+  MEM_SAFE_FREE(ld->qtree.compact_triangle_bounds);
+  MEM_SAFE_FREE(ld->qtree.compact_neighbors);
 }
 
 static void lineart_bounding_area_link_edge(LineartData *ld,
@@ -4533,6 +5525,7 @@ LineartBoundingArea *MOD_lineart_get_bounding_area(LineartData *ld, double x, do
 static void lineart_add_triangles_worker(TaskPool *__restrict /*pool*/, LineartIsecThread *th)
 {
   LineartData *ld = th->ld;
+  const double t_start = PIL_check_seconds_timer();
   // int _dir_control = 0; /* UNUSED */
   while (lineart_schedule_new_triangle_task(th)) {
     for (LineartElementLinkNode *eln = th->pending_from; eln != th->pending_to->next;
@@ -4558,7 +5551,7 @@ static void lineart_add_triangles_worker(TaskPool *__restrict /*pool*/, LineartI
                                                   nullptr,
                                                   1,
                                                   0,
-                                                  true,
+                                                  !ld->conf.use_bvh_intersections,
                                                   th);
             }
           }
@@ -4567,6 +5560,7 @@ static void lineart_add_triangles_worker(TaskPool *__restrict /*pool*/, LineartI
       }
     }
   }
+  th->time = PIL_check_seconds_timer() - t_start;
 }
 
 static void lineart_create_edges_from_isec_data(LineartIsecData *d)
@@ -4678,16 +5672,208 @@ static void lineart_create_edges_from_isec_data(LineartIsecData *d)
   }
 }
 
+/** Triangles are only split into several BVH trees when each gets at least this many. */
+#define LRT_BVH_GROUP_MIN_TRIANGLES 1024
+
+/** Triangles of one BVH tree, along the axis they are sorted on. */
+struct LineartIsecBVHGroup {
+  LineartTriangle **triangles;
+  int triangle_count;
+  BVHTree *tree;
+};
+
+/** Overlap test between two groups, or of a group with itself. */
+struct LineartIsecBVHPair {
+  const LineartIsecBVHGroup *group_a, *group_b;
+  LineartIsecThread *isec_thread;
+};
+
+struct LineartIsecBVHData {
+  LineartIsecBVHGroup *groups;
+  LineartIsecBVHPair *pairs;
+};
+
+/**
+ * Tiles only pair up triangles that share a tile inside the frame, do the same for pairs coming
+ * from the BVH so both stages give the same intersection lines.
+ */
+static bool lineart_triangle_pair_share_frame(const LineartTriangle *tri1,
+                                              const LineartTriangle *tri2)
+{
+  for (int axis = 0; axis < 2; axis++) {
+    const double low = MAX3(
+        MIN3(tri1->v[0]->fbcoord[axis], tri1->v[1]->fbcoord[axis], tri1->v[2]->fbcoord[axis]),
+        MIN3(tri2->v[0]->fbcoord[axis], tri2->v[1]->fbcoord[axis], tri2->v[2]->fbcoord[axis]),
+        -1.0);
+    const double high = MIN3(
+        MAX3(tri1->v[0]->fbcoord[axis], tri1->v[1]->fbcoord[axis], tri1->v[2]->fbcoord[axis]),
+        MAX3(tri2->v[0]->fbcoord[axis], tri2->v[1]->fbcoord[axis], tri2->v[2]->fbcoord[axis]),
+        1.0);
+    if (low > high) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool lineart_isec_bvh_overlap_cb(void *userdata,
+                                        int index_a,
+                                        int index_b,
+                                        int /*thread*/)
+{
+  LineartIsecBVHPair *pair = static_cast<LineartIsecBVHPair *>(userdata);
+  LineartTriangle *tri1 = pair->group_a->triangles[index_a];
+  LineartTriangle *tri2 = pair->group_b->triangles[index_b];
+  if (tri1 != tri2 && lineart_triangle_pair_share_frame(tri1, tri2)) {
+    lineart_triangle_pair_intersect(tri1, tri2, pair->isec_thread);
+  }
+  /* Results are already stored per pair of groups, the pair itself isn't needed. */
+  return false;
+}
+
+static void lineart_isec_bvh_build_task(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict /*tls*/)
+{
+  LineartIsecBVHGroup *group = &static_cast<LineartIsecBVHData *>(userdata)->groups[i];
+  group->tree = BLI_bvhtree_new(group->triangle_count, 0.0f, 4, 6);
+  for (int t = 0; t < group->triangle_count; t++) {
+    const LineartTriangle *tri = group->triangles[t];
+    float co[2][3];
+    for (int axis = 0; axis < 3; axis++) {
+      co[0][axis] = lineart_float_round_down(MIN3(
+          tri->v[0]->gloc[axis], tri->v[1]->gloc[axis], tri->v[2]->gloc[axis]));
+      co[1][axis] = lineart_float_round_up(MAX3(
+          tri->v[0]->gloc[axis], tri->v[1]->gloc[axis], tri->v[2]->gloc[axis]));
+    }
+    BLI_bvhtree_insert(group->tree, t, co[0], 2);
+  }
+  BLI_bvhtree_balance(group->tree);
+}
+
+static void lineart_isec_bvh_overlap_task(void *__restrict userdata,
+                                          const int i,
+                                          const TaskParallelTLS *__restrict /*tls*/)
+{
+  LineartIsecBVHPair *pair = &static_cast<LineartIsecBVHData *>(userdata)->pairs[i];
+  const bool use_self = pair->group_a == pair->group_b;
+  uint overlap_num;
+  /* Not threaded itself, the pairs are distributed over the threads instead. */
+  BVHTreeOverlap *overlap = BLI_bvhtree_overlap_ex(
+      pair->group_a->tree,
+      pair->group_b->tree,
+      &overlap_num,
+      lineart_isec_bvh_overlap_cb,
+      pair,
+      0,
+      BVH_OVERLAP_RETURN_PAIRS | (use_self ? BVH_OVERLAP_SELF : 0));
+  MEM_SAFE_FREE(overlap);
+}
+
+/**
+ * Alternative to computing intersections while linking triangles into tiles, where every new
+ * triangle is tested against all triangles already in the tile. That is quadratic in tile
+ * population for dense overlapping geometry, while a BVH over the world space bounds of the same
+ * triangles only pairs up the ones that can actually touch.
+ *
+ * A threaded self overlap of a single tree uses at most as many threads as the root has children,
+ * so the triangles are sorted along the longest axis and split into one tree per thread instead.
+ * Every pair of trees is tested on its own, pairs of far apart trees are rejected by their roots.
+ */
+static void lineart_main_intersect_triangles_bvh(LineartData *ld)
+{
+  blender::Vector<LineartTriangle *> triangles;
+  float bounds_min[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+  float bounds_max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+  LISTBASE_FOREACH (LineartElementLinkNode *, eln, &ld->geom.triangle_buffer_pointers) {
+    LineartTriangle *tri = static_cast<LineartTriangle *>(eln->pointer);
+    for (int i = 0; i < eln->element_count; i++) {
+      int r1, r2, c1, c2;
+      /* Same selection as #lineart_add_triangles_worker. */
+      if (!(tri->flags & (LRT_CULL_USED | LRT_CULL_DISCARD)) &&
+          lineart_get_triangle_bounding_areas(ld, tri, &r1, &r2, &c1, &c2)) {
+        triangles.append(tri);
+        for (int axis = 0; axis < 3; axis++) {
+          bounds_min[axis] = min_ff(bounds_min[axis], float(tri->v[0]->gloc[axis]));
+          bounds_max[axis] = max_ff(bounds_max[axis], float(tri->v[0]->gloc[axis]));
+        }
+      }
+      tri = static_cast<LineartTriangle *>((void *)(((uchar *)tri) + ld->sizeof_triangle));
+    }
+  }
+  if (triangles.size() < 2) {
+    return;
+  }
+
+  const int group_count = clamp_i(
+      int(triangles.size() / LRT_BVH_GROUP_MIN_TRIANGLES), 1, ld->thread_count);
+  if (group_count > 1) {
+    float extent[3];
+    sub_v3_v3v3(extent, bounds_max, bounds_min);
+    const int axis = axis_dominant_v3_single(extent);
+    /* Sort by the first vertex, ties are broken by the loading order so the groups are the same
+     * on every run. */
+    blender::Array<int> order(triangles.size());
+    for (const int i : order.index_range()) {
+      order[i] = i;
+    }
+    blender::parallel_sort(order.begin(), order.end(), [&](const int a, const int b) {
+      const double key_a = triangles[a]->v[0]->gloc[axis];
+      const double key_b = triangles[b]->v[0]->gloc[axis];
+      return key_a < key_b || (key_a == key_b && a < b);
+    });
+    blender::Vector<LineartTriangle *> sorted(triangles.size());
+    for (const int i : order.index_range()) {
+      sorted[i] = triangles[order[i]];
+    }
+    triangles = std::move(sorted);
+  }
+
+  blender::Array<LineartIsecBVHGroup> groups(group_count);
+  for (const int i : groups.index_range()) {
+    const int64_t start = triangles.size() * i / group_count;
+    const int64_t end = triangles.size() * (i + 1) / group_count;
+    groups[i].triangles = triangles.data() + start;
+    groups[i].triangle_count = int(end - start);
+    groups[i].tree = nullptr;
+  }
+
+  const int pair_count = group_count * (group_count + 1) / 2;
+  LineartIsecData d = {nullptr};
+  lineart_init_isec_thread(&d, ld, pair_count);
+  blender::Array<LineartIsecBVHPair> pairs(pair_count);
+  int pair_index = 0;
+  for (const int a : groups.index_range()) {
+    for (int b = a; b < group_count; b++) {
+      pairs[pair_index] = {&groups[a], &groups[b], &d.threads[pair_index]};
+      pair_index++;
+    }
+  }
+
+  LineartIsecBVHData data = {groups.data(), pairs.data()};
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, group_count, &data, lineart_isec_bvh_build_task, &settings);
+  BLI_task_parallel_range(0, pair_count, &data, lineart_isec_bvh_overlap_task, &settings);
+
+  for (LineartIsecBVHGroup &group : groups) {
+    BLI_bvhtree_free(group.tree);
+  }
+
+  /* Pairs have their own results, so the lines are created in the same order on every run. */
+  lineart_create_edges_from_isec_data(&d);
+  lineart_destroy_isec_thread(&d);
+}
+
 /**
  * Sequentially add triangles into render buffer, intersection lines between those triangles will
- * also be computed at the same time.
+ * also be computed at the same time, unless #LineartData::conf.use_bvh_intersections is set, in
+ * which case they are computed afterwards by #lineart_main_intersect_triangles_bvh.
  */
 void lineart_main_add_triangles(LineartData *ld)
 {
-  double t_start;
-  if (G.debug_value == 4000) {
-    t_start = PIL_check_seconds_timer();
-  }
+  double t_start = PIL_check_seconds_timer();
 
   /* Initialize per-thread data for thread task scheduling information and storing intersection
    * results. */
@@ -4702,15 +5888,30 @@ void lineart_main_add_triangles(LineartData *ld)
   BLI_task_pool_work_and_wait(tp);
   BLI_task_pool_free(tp);
 
+  if (ld->profile) {
+    for (int i = 0; i < ld->thread_count; i++) {
+      ld->profile->stages[LRT_PROFILE_INTERSECTION].thread_time += d.threads[i].time;
+    }
+  }
+
   if (ld->conf.use_intersections) {
-    lineart_create_edges_from_isec_data(&d);
+    if (ld->conf.use_bvh_intersections) {
+      lineart_main_intersect_triangles_bvh(ld);
+    }
+    else {
+      lineart_create_edges_from_isec_data(&d);
+    }
   }
 
   lineart_destroy_isec_thread(&d);
 
+  lineart_profile_stage_end(ld, LRT_PROFILE_INTERSECTION, t_start);
+
   if (G.debug_value == 4000) {
     double t_elapsed = PIL_check_seconds_timer() - t_start;
-    printf("Line art intersection time: %f\n", t_elapsed);
+    printf("Line art intersection time%s: %f\n",
+           ld->conf.use_bvh_intersections ? " (BVH)" : "",
+           t_elapsed);
   }
 }
 
@@ -4784,24 +5985,18 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
 
       /* We reached the right side before the top side. */
       if (r1 <= r2) {
-        LISTBASE_FOREACH (LinkData *, lip, &self->rp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->u >= ry && ba->b < ry) {
-            *next_x = rx;
-            *next_y = ry;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_RIGHT, ry, false))) {
+          *next_x = rx;
+          *next_y = ry;
+          return ba;
         }
       }
       /* We reached the top side before the right side. */
       else {
-        LISTBASE_FOREACH (LinkData *, lip, &self->up) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->r >= ux && ba->l < ux) {
-            *next_x = ux;
-            *next_y = uy;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_UP, ux, false))) {
+          *next_x = ux;
+          *next_y = uy;
+          return ba;
         }
       }
     }
@@ -4815,23 +6010,17 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
         return nullptr;
       }
       if (r1 <= r2) {
-        LISTBASE_FOREACH (LinkData *, lip, &self->rp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->u >= ry && ba->b < ry) {
-            *next_x = rx;
-            *next_y = ry;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_RIGHT, ry, false))) {
+          *next_x = rx;
+          *next_y = ry;
+          return ba;
         }
       }
       else {
-        LISTBASE_FOREACH (LinkData *, lip, &self->bp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->r >= bx && ba->l < bx) {
-            *next_x = bx;
-            *next_y = by;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_BOTTOM, bx, false))) {
+          *next_x = bx;
+          *next_y = by;
+          return ba;
         }
       }
     }
@@ -4841,13 +6030,10 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
       if (r1 > 1) {
         return nullptr;
       }
-      LISTBASE_FOREACH (LinkData *, lip, &self->rp) {
-        ba = static_cast<LineartBoundingArea *>(lip->data);
-        if (ba->u >= y && ba->b < y) {
-          *next_x = self->r;
-          *next_y = y;
-          return ba;
-        }
+      if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_RIGHT, y, false))) {
+        *next_x = self->r;
+        *next_y = y;
+        return ba;
       }
     }
   }
@@ -4867,23 +6053,17 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
         return nullptr;
       }
       if (r1 <= r2) {
-        LISTBASE_FOREACH (LinkData *, lip, &self->lp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->u >= ly && ba->b < ly) {
-            *next_x = lx;
-            *next_y = ly;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_LEFT, ly, false))) {
+          *next_x = lx;
+          *next_y = ly;
+          return ba;
         }
       }
       else {
-        LISTBASE_FOREACH (LinkData *, lip, &self->up) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->r >= ux && ba->l < ux) {
-            *next_x = ux;
-            *next_y = uy;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_UP, ux, false))) {
+          *next_x = ux;
+          *next_y = uy;
+          return ba;
         }
       }
     }
@@ -4898,23 +6078,17 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
         return nullptr;
       }
       if (r1 <= r2) {
-        LISTBASE_FOREACH (LinkData *, lip, &self->lp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->u >= ly && ba->b < ly) {
-            *next_x = lx;
-            *next_y = ly;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_LEFT, ly, false))) {
+          *next_x = lx;
+          *next_y = ly;
+          return ba;
         }
       }
       else {
-        LISTBASE_FOREACH (LinkData *, lip, &self->bp) {
-          ba = static_cast<LineartBoundingArea *>(lip->data);
-          if (ba->r >= bx && ba->l < bx) {
-            *next_x = bx;
-            *next_y = by;
-            return ba;
-          }
+        if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_BOTTOM, bx, false))) {
+          *next_x = bx;
+          *next_y = by;
+          return ba;
         }
       }
     }
@@ -4924,13 +6098,10 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
       if (r1 > 1) {
         return nullptr;
       }
-      LISTBASE_FOREACH (LinkData *, lip, &self->lp) {
-        ba = static_cast<LineartBoundingArea *>(lip->data);
-        if (ba->u >= y && ba->b < y) {
-          *next_x = self->l;
-          *next_y = y;
-          return ba;
-        }
+      if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_LEFT, y, false))) {
+        *next_x = self->l;
+        *next_y = y;
+        return ba;
       }
     }
   }
@@ -4941,13 +6112,10 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
       if (r1 > 1) {
         return nullptr;
       }
-      LISTBASE_FOREACH (LinkData *, lip, &self->up) {
-        ba = static_cast<LineartBoundingArea *>(lip->data);
-        if (ba->r > x && ba->l <= x) {
-          *next_x = x;
-          *next_y = self->u;
-          return ba;
-        }
+      if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_UP, x, true))) {
+        *next_x = x;
+        *next_y = self->u;
+        return ba;
       }
     }
     else if (positive_y < 0) {
@@ -4955,13 +6123,10 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
       if (r1 > 1) {
         return nullptr;
       }
-      LISTBASE_FOREACH (LinkData *, lip, &self->bp) {
-        ba = static_cast<LineartBoundingArea *>(lip->data);
-        if (ba->r > x && ba->l <= x) {
-          *next_x = x;
-          *next_y = self->b;
-          return ba;
-        }
+      if ((ba = lineart_bounding_area_neighbor_at(self, LRT_BA_SIDE_BOTTOM, x, true))) {
+        *next_x = x;
+        *next_y = self->b;
+        return ba;
       }
     }
     else {
@@ -4972,6 +6137,315 @@ LineartBoundingArea *lineart_bounding_area_next(LineartBoundingArea *self,
   return nullptr;
 }
 
+void MOD_lineart_incremental_cache_free(LineartIncrementalCache **lic)
+{
+  if (!(*lic)) {
+    return;
+  }
+  MEM_SAFE_FREE((*lic)->settings);
+  MEM_SAFE_FREE((*lic)->objects);
+  MOD_lineart_clear_cache(&(*lic)->result);
+  delete (*lic)->snapshots;
+  MEM_freeN(*lic);
+  (*lic) = nullptr;
+}
+
+static void lineart_incremental_get_view(Scene *scene,
+                                         LineartGpencilModifierData *lmd,
+                                         Object *camera,
+                                         Object *active_camera,
+                                         bool enable_stroke_depth_offset,
+                                         LineartIncrementalView *r_view)
+{
+  memset(r_view, 0, sizeof(LineartIncrementalView));
+
+  r_view->w = scene->r.xsch;
+  r_view->h = scene->r.ysch;
+  r_view->enable_stroke_depth_offset = enable_stroke_depth_offset;
+
+  Camera *c = static_cast<Camera *>(camera->data);
+  copy_m4_m4(r_view->camera_obmat, camera->object_to_world);
+  r_view->camera_type = c->type;
+  r_view->camera_lens = c->lens;
+  r_view->camera_ortho_scale = c->ortho_scale;
+  r_view->camera_clip_start = c->clip_start;
+  r_view->camera_clip_end = c->clip_end;
+  r_view->camera_shift_x = c->shiftx;
+  r_view->camera_shift_y = c->shifty;
+  r_view->camera_sensor_x = c->sensor_x;
+  r_view->camera_sensor_y = c->sensor_y;
+  r_view->camera_sensor_fit = c->sensor_fit;
+
+  if (active_camera) {
+    copy_v3_v3(r_view->active_camera_pos, active_camera->object_to_world[3]);
+  }
+
+  if (lmd->light_contour_object) {
+    Object *light_obj = lmd->light_contour_object;
+    copy_m4_m4(r_view->light_obmat, light_obj->object_to_world);
+    if (light_obj->type == OB_LAMP) {
+      r_view->light_type = ((Light *)light_obj->data)->type;
+    }
+  }
+}
+
+/**
+ * Gather every object #lineart_main_load_geometries() would consider, in the same order. Returns
+ * true when any of them, or one of their materials, is tagged for an update in this evaluation.
+ * Transform tags are ignored, moved objects are found by comparing the stored matrices.
+ */
+static bool lineart_incremental_get_objects(Depsgraph *depsgraph,
+                                            bool allow_duplicates,
+                                            blender::Vector<LineartIncrementalObject> &r_objects)
+{
+  eEvaluationMode eval_mode = DEG_get_mode(depsgraph);
+  bool any_tagged = false;
+
+  int flags = DEG_ITER_OBJECT_FLAG_LINKED_DIRECTLY | DEG_ITER_OBJECT_FLAG_LINKED_VIA_SET |
+              DEG_ITER_OBJECT_FLAG_VISIBLE;
+  if (allow_duplicates) {
+    flags |= DEG_ITER_OBJECT_FLAG_DUPLI;
+  }
+
+  DEGObjectIterSettings deg_iter_settings = {nullptr};
+  deg_iter_settings.depsgraph = depsgraph;
+  deg_iter_settings.flags = flags;
+
+  DEG_OBJECT_ITER_BEGIN (&deg_iter_settings, ob) {
+    Object *eval_ob = DEG_get_evaluated_object(depsgraph, ob);
+    if (!eval_ob) {
+      continue;
+    }
+    if (allow_duplicates && ELEM(ob->type, OB_CURVES_LEGACY, OB_FONT, OB_SURF)) {
+      continue;
+    }
+    if (!ELEM(eval_ob->type, OB_MESH, OB_MBALL, OB_CURVES_LEGACY, OB_SURF, OB_FONT)) {
+      continue;
+    }
+    if (!(BKE_object_visibility(eval_ob, eval_mode) & OB_VISIBLE_SELF)) {
+      continue;
+    }
+    if (!any_tagged && lineart_incremental_object_is_tagged(eval_ob)) {
+      any_tagged = true;
+    }
+    LineartIncrementalObject lio;
+    lio.original_ob = eval_ob->id.orig_id ? (Object *)eval_ob->id.orig_id : eval_ob;
+    copy_m4_m4(lio.object_to_world, eval_ob->object_to_world);
+    r_objects.append(lio);
+  }
+  DEG_OBJECT_ITER_END;
+
+  return any_tagged;
+}
+
+/** Whether the previous result was calculated with the same settings and view. */
+static bool lineart_incremental_view_matches(const LineartIncrementalCache *lic,
+                                             const LineartGpencilModifierData *lmd,
+                                             const LineartIncrementalView *view)
+{
+  if (!lic || !lic->result) {
+    return false;
+  }
+  /* Compare all DNA settings, but not the runtime pointers at the end of the struct. */
+  const size_t settings_begin = offsetof(LineartGpencilModifierData, edge_types);
+  const size_t settings_end = offsetof(LineartGpencilModifierData, cache);
+  if (memcmp(POINTER_OFFSET(lic->settings, settings_begin),
+             POINTER_OFFSET(lmd, settings_begin),
+             settings_end - settings_begin) != 0) {
+    return false;
+  }
+  return memcmp(&lic->view, view, sizeof(LineartIncrementalView)) == 0;
+}
+
+/** Whether the previous result loaded the same objects with the same transforms. */
+static bool lineart_incremental_objects_match(
+    const LineartIncrementalCache *lic, const blender::Vector<LineartIncrementalObject> &objects)
+{
+  if (lic->object_count != objects.size()) {
+    return false;
+  }
+  for (const int i : objects.index_range()) {
+    const LineartIncrementalObject &lio = lic->objects[i];
+    if (lio.original_ob != objects[i].original_ob ||
+        !equals_m4m4(lio.object_to_world, objects[i].object_to_world)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Start an incremental calculation. The snapshots of the previous one are only reused when
+ * `use_snapshots` is set, the view and everything else that affects all objects are the same.
+ */
+static void lineart_incremental_begin(LineartData *ld,
+                                      LineartIncrementalData *incremental,
+                                      LineartIncrementalCache *lic,
+                                      const bool use_snapshots)
+{
+  if (use_snapshots && lic && lic->snapshots) {
+    incremental->previous = std::move(lic->snapshots->items);
+    for (const int i : incremental->previous.index_range()) {
+      incremental->previous_by_object.add(incremental->previous[i]->original_ob, i);
+    }
+  }
+  ld->incremental = incremental;
+}
+
+static void lineart_incremental_add_changed_area(LineartIncrementalData &incremental,
+                                                 const LineartObjectSnapshot &snapshot)
+{
+  if (snapshot.bounds_min[0] > snapshot.bounds_max[0]) {
+    return;
+  }
+  const blender::double4 area(snapshot.bounds_min[0],
+                              snapshot.bounds_min[1],
+                              snapshot.bounds_max[0],
+                              snapshot.bounds_max[1]);
+  if (incremental.changed_areas.size() < LRT_INCREMENTAL_MAX_CHANGED_AREAS) {
+    incremental.changed_areas.append(area);
+    return;
+  }
+  blender::double4 &merged = incremental.changed_areas.last();
+  merged[0] = min_dd(merged[0], area[0]);
+  merged[1] = min_dd(merged[1], area[1]);
+  merged[2] = max_dd(merged[2], area[2]);
+  merged[3] = max_dd(merged[3], area[3]);
+}
+
+/**
+ * Find the image space bounds of every loaded object, needs the perspective division to be done.
+ * The bounds of the objects that were loaded again and of the previous objects that are gone or
+ * changed make up the changed areas.
+ */
+static void lineart_incremental_update_bounds(LineartData *ld)
+{
+  using namespace blender;
+  LineartIncrementalData &incremental = *ld->incremental;
+  threading::parallel_for(incremental.snapshots.index_range(), 16, [&](const IndexRange range) {
+    for (const int i : range) {
+      LineartObjectSnapshot &snapshot = *incremental.snapshots[i];
+      if (!snapshot.loaded) {
+        continue;
+      }
+      INIT_MINMAX2(snapshot.bounds_min, snapshot.bounds_max);
+      for (const int v : snapshot.verts.index_range()) {
+        const double *fbcoord = snapshot.current_verts[v].fbcoord;
+        if (ld->conf.cam_is_persp && !(fbcoord[3] > 0.0)) {
+          /* Triangles behind the camera are clipped, which can reach any point of the image. */
+          snapshot.bounds_min[0] = snapshot.bounds_min[1] = -DBL_MAX;
+          snapshot.bounds_max[0] = snapshot.bounds_max[1] = DBL_MAX;
+          break;
+        }
+        snapshot.bounds_min[0] = min_dd(snapshot.bounds_min[0], fbcoord[0]);
+        snapshot.bounds_min[1] = min_dd(snapshot.bounds_min[1], fbcoord[1]);
+        snapshot.bounds_max[0] = max_dd(snapshot.bounds_max[0], fbcoord[0]);
+        snapshot.bounds_max[1] = max_dd(snapshot.bounds_max[1], fbcoord[1]);
+      }
+    }
+  });
+
+  for (const std::unique_ptr<LineartObjectSnapshot> &snapshot : incremental.previous) {
+    if (snapshot && snapshot->loaded) {
+      lineart_incremental_add_changed_area(incremental, *snapshot);
+    }
+  }
+  for (const std::unique_ptr<LineartObjectSnapshot> &snapshot : incremental.snapshots) {
+    if (snapshot->loaded && !snapshot->reuse) {
+      lineart_incremental_add_changed_area(incremental, *snapshot);
+    }
+  }
+}
+
+/** Keep the occlusion of all pending edges of the loaded objects for the next calculation. */
+static void lineart_incremental_save_occlusion(LineartData *ld)
+{
+  using namespace blender;
+  LineartIncrementalData &incremental = *ld->incremental;
+  threading::parallel_for(incremental.snapshots.index_range(), 16, [&](const IndexRange range) {
+    for (const int i : range) {
+      LineartObjectSnapshot &snapshot = *incremental.snapshots[i];
+      if (!snapshot.loaded) {
+        continue;
+      }
+      const int edge_count = int(snapshot.pending_edges.size());
+      snapshot.segment_offsets.reinitialize(edge_count + 1);
+      snapshot.min_occ.reinitialize(edge_count);
+      snapshot.segments.clear();
+      for (const int e_i : IndexRange(edge_count)) {
+        const LineartEdge *e = &snapshot.current_edges[snapshot.pending_edges[e_i]];
+        snapshot.segment_offsets[e_i] = int(snapshot.segments.size());
+        LISTBASE_FOREACH (const LineartEdgeSegment *, es, &e->segments) {
+          snapshot.segments.append(*es);
+        }
+        snapshot.min_occ[e_i] = e->min_occ;
+      }
+      snapshot.segment_offsets.last() = int(snapshot.segments.size());
+    }
+  });
+}
+
+static void lineart_incremental_store(LineartGpencilModifierData *lmd,
+                                      const LineartIncrementalView *view,
+                                      const blender::Vector<LineartIncrementalObject> &objects,
+                                      const LineartCache *lc,
+                                      LineartData *ld)
+{
+  LineartObjectSnapshots *snapshots = nullptr;
+  if (ld->incremental) {
+    if (G.debug_value == 4000) {
+      printf("Line art reused %d of %d objects and the occlusion of %d edges.\n",
+             ld->incremental->reused_object_count,
+             int(ld->incremental->snapshots.size()),
+             ld->incremental->reused_edge_count);
+    }
+    snapshots = new LineartObjectSnapshots();
+    snapshots->items = std::move(ld->incremental->snapshots);
+    for (std::unique_ptr<LineartObjectSnapshot> &snapshot : snapshots->items) {
+      snapshot->reuse = false;
+      snapshot->current_verts = nullptr;
+      snapshot->current_edges = nullptr;
+    }
+    ld->incremental = nullptr;
+  }
+
+  MOD_lineart_incremental_cache_free(&lmd->la_incremental_ptr);
+
+  LineartIncrementalCache *lic = static_cast<LineartIncrementalCache *>(
+      MEM_callocN(sizeof(LineartIncrementalCache), "Lineart Incremental Cache"));
+  lic->settings = static_cast<LineartGpencilModifierData *>(MEM_dupallocN(lmd));
+  memcpy(&lic->view, view, sizeof(LineartIncrementalView));
+  lic->object_count = objects.size();
+  if (lic->object_count) {
+    lic->objects = static_cast<LineartIncrementalObject *>(MEM_malloc_arrayN(
+        lic->object_count, sizeof(LineartIncrementalObject), "Lineart Incremental Objects"));
+    memcpy(lic->objects, objects.data(), sizeof(LineartIncrementalObject) * lic->object_count);
+  }
+  lic->result = lineart_init_cache();
+  lic->result->all_enabled_edge_types = lc->all_enabled_edge_types;
+  MOD_lineart_chain_list_copy(&lic->result->chains, &lic->result->chain_data_pool, &lc->chains);
+  lic->snapshots = snapshots;
+
+  lmd->la_incremental_ptr = lic;
+}
+
+/**
+ * Account the memory of the calculation's pools to `usage`, the modifier can run for several
+ * objects at the same time so the pools of others must not be counted.
+ */
+static void lineart_mem_usage_attach(LineartData *ld, LineartCache *lc, LineartMemUsage *usage)
+{
+  ld->render_data_pool.usage = usage;
+  lc->chain_data_pool.usage = usage;
+  lc->shadow_data_pool.usage = usage;
+}
+
+/** The pools outlive the calculation, stop accounting to its (stack allocated) usage. */
+static void lineart_mem_usage_detach(LineartData *ld, LineartCache *lc)
+{
+  lineart_mem_usage_attach(ld, lc, nullptr);
+}
+
 /**
  * This is the entry point of all line art calculations.
  *
@@ -4987,10 +6461,8 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
   int intersections_only = 0; /* Not used right now, but preserve for future. */
   Object *use_camera;
 
-  double t_start;
-  if (G.debug_value == 4000) {
-    t_start = PIL_check_seconds_timer();
-  }
+  double t_start = PIL_check_seconds_timer();
+  LineartMemUsage mem_usage = {0};
 
   if (lmd->calculation_flags & LRT_USE_CUSTOM_CAMERA) {
     if (!lmd->source_camera ||
@@ -5013,6 +6485,52 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
   *cached_result = lc;
 
   ld = lineart_create_render_buffer(scene, lmd, use_camera, scene->camera, lc);
+  /* The shadow pass copies `ld`, so its render pool is accounted here too. */
+  lineart_mem_usage_attach(ld, lc, &mem_usage);
+
+  if (!lmd->la_profile_ptr) {
+    lmd->la_profile_ptr = static_cast<LineartProfile *>(
+        MEM_callocN(sizeof(LineartProfile), "Lineart Profile"));
+  }
+  else {
+    memset(lmd->la_profile_ptr, 0, sizeof(LineartProfile));
+  }
+  LineartProfile *profile = lmd->la_profile_ptr;
+  profile->thread_count = ld->thread_count;
+  ld->profile = profile;
+
+  const bool use_incremental = (lmd->calculation_flags & LRT_USE_INCREMENTAL) != 0;
+  LineartIncrementalView incremental_view;
+  blender::Vector<LineartIncrementalObject> incremental_objects;
+  bool incremental_view_matches = false;
+  if (use_incremental) {
+    lineart_incremental_get_view(
+        scene, lmd, use_camera, scene->camera, enable_stroke_depth_offset, &incremental_view);
+    const bool any_tagged = lineart_incremental_get_objects(
+        depsgraph, lmd->calculation_flags & LRT_ALLOW_DUPLI_OBJECTS, incremental_objects);
+    /* Line art usage and intersection masks of collections are only read from the collections,
+     * a change there can affect any object. */
+    incremental_view_matches = lineart_incremental_view_matches(
+                                   lmd->la_incremental_ptr, lmd, &incremental_view) &&
+                               !DEG_id_type_updated(depsgraph, ID_GR);
+    if (!any_tagged && incremental_view_matches &&
+        lineart_incremental_objects_match(lmd->la_incremental_ptr, incremental_objects)) {
+      MOD_lineart_chain_list_copy(
+          &lc->chains, &lc->chain_data_pool, &lmd->la_incremental_ptr->result->chains);
+      profile->reused = true;
+      profile->chain_count = BLI_listbase_count(&lc->chains);
+      profile->chain_pool_bytes = lineart_mem_pool_size(&lc->chain_data_pool);
+      profile->total_time = PIL_check_seconds_timer() - t_start;
+      if (G.debug_value == 4000) {
+        printf("Line art reused the previous result, nothing has changed.\n");
+      }
+      lineart_mem_usage_detach(ld, lc);
+      return true;
+    }
+  }
+  else {
+    MOD_lineart_incremental_cache_free(&lmd->la_incremental_ptr);
+  }
 
   /* Triangle thread testing data size varies depending on the thread count.
    * See definition of LineartTriangleThread for details. */
@@ -5021,6 +6539,7 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
   LineartData *shadow_rb = nullptr;
   LineartElementLinkNode *shadow_veln, *shadow_eeln;
   ListBase *shadow_elns = ld->conf.shadow_selection ? &lc->shadow_elns : nullptr;
+  double t_stage = PIL_check_seconds_timer();
   bool shadow_generated = lineart_main_try_generate_shadow(depsgraph,
                                                            scene,
                                                            ld,
@@ -5030,8 +6549,18 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
                                                            &shadow_eeln,
                                                            shadow_elns,
                                                            &shadow_rb);
+  lineart_profile_stage_end(ld, LRT_PROFILE_SHADOW, t_stage);
+
+  /* Objects that are not changed are restored from the previous calculation, together with the
+   * occlusion of their edges. Shadow cuts depend on all objects, so everything is loaded again
+   * when they are used. */
+  LineartIncrementalData incremental;
+  if (use_incremental && !shadow_generated && !shadow_elns) {
+    lineart_incremental_begin(ld, &incremental, lmd->la_incremental_ptr, incremental_view_matches);
+  }
 
   /* Get view vector before loading geometries, because we detect feature lines there. */
+  t_stage = PIL_check_seconds_timer();
   lineart_main_get_view_vector(ld);
 
   lineart_main_load_geometries(depsgraph,
@@ -5041,22 +6570,33 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
                                lmd->calculation_flags & LRT_ALLOW_DUPLI_OBJECTS,
                                false,
                                shadow_elns);
+  lineart_profile_stage_end(ld, LRT_PROFILE_LOAD, t_stage);
 
   if (shadow_generated) {
+    t_stage = PIL_check_seconds_timer();
     lineart_main_transform_and_add_shadow(ld, shadow_veln, shadow_eeln);
+    lineart_profile_stage_end(ld, LRT_PROFILE_SHADOW, t_stage);
   }
 
   if (!ld->geom.vertex_buffer_pointers.first) {
     /* No geometry loaded, return early. */
+    if (use_incremental) {
+      lineart_incremental_store(lmd, &incremental_view, incremental_objects, lc, ld);
+    }
+    profile->total_time = PIL_check_seconds_timer() - t_start;
+    lineart_mem_usage_detach(ld, lc);
     return true;
   }
 
   /* Initialize the bounding box acceleration structure, it's a lot like BVH in 3D. */
+  t_stage = PIL_check_seconds_timer();
   lineart_main_bounding_area_make_initial(ld);
+  lineart_profile_stage_end(ld, LRT_PROFILE_QUADTREE, t_stage);
 
   /* We need to get cut into triangles that are crossing near/far plans, only this way can we get
    * correct coordinates of those clipped lines. Done in two steps,
    * setting clip_far==false for near plane. */
+  t_stage = PIL_check_seconds_timer();
   lineart_main_cull_triangles(ld, false);
   /* `clip_far == true` for far plane. */
   lineart_main_cull_triangles(ld, true);
@@ -5067,7 +6607,12 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
   /* Do the perspective division after clipping is done. */
   lineart_main_perspective_division(ld);
 
+  if (ld->incremental) {
+    lineart_incremental_update_bounds(ld);
+  }
+
   lineart_main_discard_out_of_frame_edges(ld);
+  lineart_profile_stage_end(ld, LRT_PROFILE_CULL, t_stage);
 
   /* Triangle intersections are done here during sequential adding of them. Only after this,
    * triangles and lines are all linked with acceleration structure, and the 2D occlusion stage
@@ -5075,16 +6620,20 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
   lineart_main_add_triangles(ld);
 
   /* Add shadow cuts to intersection lines as well. */
+  t_stage = PIL_check_seconds_timer();
   lineart_register_intersection_shadow_cuts(ld, shadow_elns);
+  lineart_profile_stage_end(ld, LRT_PROFILE_SHADOW, t_stage);
 
   /* Re-link bounding areas because they have been subdivided by worker threads and we need
    * adjacent info. */
+  t_stage = PIL_check_seconds_timer();
   lineart_main_bounding_areas_connect_post(ld);
 
   /* Link lines to acceleration structure, this can only be done after perspective division, if
    * we do it after triangles being added, the acceleration structure has already been
    * subdivided, this way we do less list manipulations. */
   lineart_main_link_lines(ld);
+  lineart_profile_stage_end(ld, LRT_PROFILE_QUADTREE, t_stage);
 
   /* "intersection_only" is preserved for being called in a standalone fashion.
    * If so the data will already be available at the stage. Otherwise we do the occlusion and
@@ -5095,8 +6644,15 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
     /* Occlusion is work-and-wait. This call will not return before work is completed. */
     lineart_main_occlusion_begin(ld);
 
+    if (ld->incremental) {
+      lineart_incremental_save_occlusion(ld);
+    }
+
+    t_stage = PIL_check_seconds_timer();
     lineart_main_make_enclosed_shapes(ld, shadow_rb);
+    lineart_profile_stage_end(ld, LRT_PROFILE_SHADOW, t_stage);
 
+    t_stage = PIL_check_seconds_timer();
     lineart_main_remove_unused_lines_from_tiles(ld);
 
     /* Chaining is all single threaded. See lineart_chain.c
@@ -5116,7 +6672,11 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
       /* Keeping UI range of 0-1 for ease of read while scaling down the actual value for best
        * effective range in image-space (Coordinate only goes from -1 to 1). This value is
        * somewhat arbitrary, but works best for the moment. */
+      lineart_profile_stage_end(ld, LRT_PROFILE_CHAINING, t_stage);
+      t_stage = PIL_check_seconds_timer();
       MOD_lineart_smooth_chains(ld, ld->conf.chain_smooth_tolerance / 50);
+      lineart_profile_stage_end(ld, LRT_PROFILE_SMOOTHING, t_stage);
+      t_stage = PIL_check_seconds_timer();
     }
 
     if (ld->conf.use_image_boundary_trimming) {
@@ -5143,8 +6703,22 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
     MOD_lineart_chain_clear_picked_flag(lc);
 
     MOD_lineart_finalize_chains(ld);
+    lineart_profile_stage_end(ld, LRT_PROFILE_CHAINING, t_stage);
   }
 
+  LISTBASE_FOREACH (LineartElementLinkNode *, eln, &ld->geom.triangle_buffer_pointers) {
+    profile->triangle_count += eln->element_count;
+  }
+  profile->edge_count = ld->pending_edges.next;
+  for (int i = 0; i < ld->pending_edges.next; i++) {
+    profile->segment_count += BLI_listbase_count(&ld->pending_edges.array[i]->segments);
+  }
+  profile->chain_count = BLI_listbase_count(&lc->chains);
+  profile->render_pool_bytes = lineart_mem_pool_size(&ld->render_data_pool);
+  profile->chain_pool_bytes = lineart_mem_pool_size(&lc->chain_data_pool);
+  profile->shadow_pool_bytes = lineart_mem_pool_size(&lc->shadow_data_pool);
+  profile->peak_bytes = mem_usage.peak;
+
   lineart_mem_destroy(&lc->shadow_data_pool);
 
   if (ld->conf.shadow_enclose_shapes && shadow_rb) {
@@ -5152,13 +6726,21 @@ bool MOD_lineart_compute_feature_lines(Depsgraph *depsgraph,
     MEM_freeN(shadow_rb);
   }
 
+  if (use_incremental) {
+    lineart_incremental_store(lmd, &incremental_view, incremental_objects, lc, ld);
+  }
+
   if (G.debug_value == 4000) {
     lineart_count_and_print_render_buffer_memory(ld);
+    printf("Line art peak memory: %zu Bytes\n", profile->peak_bytes);
+  }
 
-    double t_elapsed = PIL_check_seconds_timer() - t_start;
-    printf("Line art total time: %lf\n", t_elapsed);
+  profile->total_time = PIL_check_seconds_timer() - t_start;
+  if (G.debug_value == 4000) {
+    printf("Line art total time: %lf\n", profile->total_time);
   }
 
+  lineart_mem_usage_detach(ld, lc);
   return true;
 }
 
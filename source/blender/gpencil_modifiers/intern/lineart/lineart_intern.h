@@ -51,6 +51,10 @@ struct LineartStaticMemPoolNode *lineart_mem_new_static_pool(struct LineartStati
                                                              size_t size);
 void *lineart_mem_acquire(struct LineartStaticMemPool *smp, size_t size);
 void *lineart_mem_acquire_thread(struct LineartStaticMemPool *smp, size_t size);
+/**
+ * Give all memory of the pool back. Nodes are kept as spare nodes for a while, so the next
+ * calculation (usually the next frame) reuses memory that is already mapped.
+ */
 void lineart_mem_destroy(struct LineartStaticMemPool *smp);
 
 void lineart_prepend_pool(LinkNode **first, struct LineartStaticMemPool *smp, void *link);
@@ -69,6 +73,54 @@ int lineart_count_intersection_segment_count(struct LineartData *ld);
 
 void lineart_count_and_print_render_buffer_memory(struct LineartData *ld);
 
+size_t lineart_mem_pool_size(const struct LineartStaticMemPool *smp);
+/** Add the time since `t_start` to a stage of #LineartData::profile, if there is one. */
+void lineart_profile_stage_end(struct LineartData *ld, int stage, double t_start);
+
+/**
+ * Returns a bit for each of the #LRT_TRIANGLE_BOUNDS_WIDTH triangles starting at `start` in the
+ * batched #LineartBoundingArea.triangle_bounds, which is set when the triangle bounds are disjoint
+ * with the edge bounds, in the same way as #lineart_triangle_edge_bounds_reject.
+ * `edge_bounds` is `min_x, max_x, min_y, max_y, max_w`.
+ */
+int lineart_triangle_bounds_reject_mask(const float *bounds,
+                                        int stride,
+                                        int start,
+                                        const float edge_bounds[5]);
+/**
+ * Returns a bit for each of the #LRT_TRIANGLE_BOUNDS_WIDTH triangles starting at `start` which is
+ * set when both edge end points are clearly outside of one of the triangle edges. The margin
+ * scales with the coordinates and has an absolute floor well above the tolerances of
+ * #lineart_triangle_edge_image_space_occlusion, so a rejected triangle never occludes the edge
+ * there either. Cases closer than that are left to the double precision test.
+ * `edge_points` is `x1, y1, x2, y2` of the edge followed by its largest absolute coordinate.
+ */
+int lineart_triangle_edges_reject_mask(const float *bounds,
+                                       int stride,
+                                       int start,
+                                       const float edge_points[5]);
+/**
+ * Reference versions of the reject masks above, which use SIMD when it's available. Both must
+ * give the same masks, see `lineart_test.cc`.
+ */
+int lineart_triangle_bounds_reject_mask_scalar(const float *bounds,
+                                               int stride,
+                                               int start,
+                                               const float edge_bounds[5]);
+int lineart_triangle_edges_reject_mask_scalar(const float *bounds,
+                                              int stride,
+                                              int start,
+                                              const float edge_points[5]);
+/**
+ * Fill #LineartBoundingArea.triangle_bounds for the linked triangles of a tile, including the edge
+ * functions used by #lineart_triangle_edges_reject_mask.
+ */
+void lineart_bounding_area_build_triangle_bounds(struct LineartBoundingArea *ba);
+/** The `edge_bounds` and `edge_points` of an edge for the reject masks above. */
+void lineart_edge_reject_data_get(const struct LineartEdge *e,
+                                  float r_edge_bounds[5],
+                                  float r_edge_points[5]);
+
 #define LRT_ITER_ALL_LINES_BEGIN \
   { \
     LineartEdge *e; \
@@ -149,6 +201,21 @@ void lineart_register_intersection_shadow_cuts(struct LineartData *ld,
 bool lineart_edge_from_triangle(const struct LineartTriangle *tri,
                                 const struct LineartEdge *e,
                                 bool allow_overlapping_edges);
+/**
+ * Whether `tri` occludes `e`, the occluded part goes from `from` to `to` along the edge in image
+ * space.
+ */
+bool lineart_triangle_edge_image_space_occlusion(const struct LineartTriangle *tri,
+                                                 const struct LineartEdge *e,
+                                                 const double *override_camera_loc,
+                                                 bool override_cam_is_persp,
+                                                 bool allow_overlapping_edges,
+                                                 const double m_view_projection[4][4],
+                                                 const double camera_dir[3],
+                                                 float cam_shift_x,
+                                                 float cam_shift_y,
+                                                 double *from,
+                                                 double *to);
 LineartBoundingArea *lineart_edge_first_bounding_area(struct LineartData *ld,
                                                       double *fbcoord1,
                                                       double *fbcoord2);
@@ -238,16 +238,27 @@ static void lineart_gpencil_bake_startjob(void *customdata,
     }
 
     BKE_scene_frame_set(bj->scene, frame);
-    BKE_scene_graph_update_for_newframe(bj->dg);
+    /* Keep the recalc flags until all targets are baked, #LRT_USE_INCREMENTAL relies on them to
+     * know which objects changed on this frame. */
+    BKE_scene_graph_update_for_newframe_ex(bj->dg, false);
 
+    LinkNode *touched_objects = NULL;
     for (LinkNode *l = bj->objects; l; l = l->next) {
       Object *ob = l->link;
       if (lineart_gpencil_bake_single_target(bj, ob, frame)) {
-        DEG_id_tag_update((struct ID *)ob->data, ID_RECALC_GEOMETRY);
-        WM_event_add_notifier(bj->C, NC_GPENCIL | ND_DATA | NA_EDITED, ob);
+        BLI_linklist_prepend(&touched_objects, ob);
       }
     }
 
+    DEG_ids_clear_recalc(bj->dg, false);
+
+    for (LinkNode *l = touched_objects; l; l = l->next) {
+      Object *ob = l->link;
+      DEG_id_tag_update((struct ID *)ob->data, ID_RECALC_GEOMETRY);
+      WM_event_add_notifier(bj->C, NC_GPENCIL | ND_DATA | NA_EDITED, ob);
+    }
+    BLI_linklist_free(touched_objects, NULL);
+
     /* Update and refresh the progress bar. */
     *bj->progress = (float)(frame - bj->frame_begin) / (bj->frame_end - bj->frame_begin);
     *bj->do_update = true;
@@ -1120,35 +1120,14 @@ static void lineart_shadow_register_enclosed_shapes(LineartData *ld, LineartData
   }
 }
 
-/* This call would internally duplicate #original_ld, override necessary configurations for shadow
- * computations. It will return:
- *
- * 1) Generated shadow edges in format of `LineartElementLinkNode` which can be directly loaded
- * into later main view camera occlusion stage.
- * 2) Shadow render buffer if 3rd stage reprojection is need for silhouette/lit/shaded region
- * selection. Otherwise the shadow render buffer is deleted before this function returns.
+/**
+ * Make the data for the pass from the light's point of view, with the configuration of
+ * `original_ld` adjusted for it. Nothing is loaded yet.
  */
-bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
-                                      Scene *scene,
-                                      LineartData *original_ld,
-                                      LineartGpencilModifierData *lmd,
-                                      LineartStaticMemPool *shadow_data_pool,
-                                      LineartElementLinkNode **r_veln,
-                                      LineartElementLinkNode **r_eeln,
-                                      ListBase *r_calculated_edges_eln_list,
-                                      LineartData **r_shadow_ld_if_reproject)
+static LineartData *lineart_shadow_data_create(LineartData *original_ld,
+                                               LineartGpencilModifierData *lmd,
+                                               LineartStaticMemPool *shadow_data_pool)
 {
-  if ((!original_ld->conf.use_shadow && !original_ld->conf.use_light_contour &&
-       !original_ld->conf.shadow_selection) ||
-      (!lmd->light_contour_object)) {
-    return false;
-  }
-
-  double t_start;
-  if (G.debug_value == 4000) {
-    t_start = PIL_check_seconds_timer();
-  }
-
   bool is_persp = true;
 
   if (lmd->light_contour_object->type == OB_LAMP) {
@@ -1160,6 +1139,9 @@ bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
 
   LineartData *ld = MEM_callocN(sizeof(LineartData), "LineArt render buffer copied");
   memcpy(ld, original_ld, sizeof(LineartData));
+  /* Shadow stages are timed as a whole by the caller. */
+  ld->profile = NULL;
+  ld->incremental = NULL;
 
   BLI_spin_init(&ld->lock_task);
   BLI_spin_init(&ld->lock_cuts);
@@ -1232,6 +1214,22 @@ bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
   unit_m4_db(view);
   copy_m4_m4_db(ld->conf.view, view);
 
+  return ld;
+}
+
+/**
+ * Load the scene from the light's point of view and cast shadows, `ld` is freed unless it's
+ * returned in `r_shadow_ld_if_reproject`.
+ */
+static bool lineart_shadow_generate(Depsgraph *depsgraph,
+                                    Scene *scene,
+                                    LineartData *ld,
+                                    LineartGpencilModifierData *lmd,
+                                    LineartElementLinkNode **r_veln,
+                                    LineartElementLinkNode **r_eeln,
+                                    ListBase *r_calculated_edges_eln_list,
+                                    LineartData **r_shadow_ld_if_reproject)
+{
   lineart_main_get_view_vector(ld);
 
   lineart_main_load_geometries(
@@ -1266,7 +1264,7 @@ bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
     memcpy(r_calculated_edges_eln_list, &ld->geom.line_buffer_pointers, sizeof(ListBase));
   }
 
-  if (ld->conf.shadow_enclose_shapes) {
+  if (r_shadow_ld_if_reproject) {
     /* Need loaded data for re-projecting the 3rd time to get shape boundary against lit/shaded
      * region. */
     (*r_shadow_ld_if_reproject) = ld;
@@ -1276,6 +1274,413 @@ bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
     MEM_freeN(ld);
   }
 
+  return any_generated;
+}
+
+/* Shadow cache ================== */
+
+/**
+ * Everything the light pass depends on besides the scene itself, which can't change within one
+ * evaluation of the dependency graph. Only settings the light pass reads are used, so modifiers
+ * that only differ in chaining or in their own camera still share it.
+ */
+typedef struct LineartShadowCacheKey {
+  const Depsgraph *depsgraph;
+  uint64_t update_count;
+  struct Object *light;
+  bool allow_duplicates;
+  int w, h;
+
+  /* Light "camera", see #lineart_shadow_data_create. */
+  bool cam_is_persp;
+  float cam_obmat[4][4];
+  double near_clip, far_clip;
+  float shift_x, shift_y;
+
+  /* Viewing camera, only used for its contours when lit/shaded regions are selected. */
+  bool use_contour_secondary;
+  bool cam_is_persp_secondary;
+  float cam_obmat_secondary[4][4];
+  double camera_pos_secondary[3];
+  double view_vector_secondary[3];
+
+  /* Loaded edge types and how they are found. */
+  int shadow_selection;
+  int max_occlusion_level;
+  float crease_threshold;
+  bool use_contour;
+  bool use_crease;
+  bool use_material;
+  bool use_edge_marks;
+  bool use_intersections;
+  bool use_bvh_intersections;
+  bool use_loose;
+  bool use_light_contour;
+  bool use_loose_as_contour;
+  bool use_back_face_culling;
+  bool allow_boundaries;
+  bool allow_overlapping_edges;
+  bool allow_duplicated_types;
+  bool filter_face_mark;
+  bool filter_face_mark_invert;
+  bool filter_face_mark_boundaries;
+  bool filter_face_mark_keep_contour;
+  bool force_crease;
+  bool sharp_as_crease;
+} LineartShadowCacheKey;
+
+/**
+ * Result of one light pass, shared by all line art modifiers that need the same one. Several
+ * modifiers on one or more objects often use the same light and settings.
+ */
+typedef struct LineartShadowCacheEntry {
+  struct LineartShadowCacheEntry *next, *prev;
+  LineartShadowCacheKey key;
+
+  /** Held by the modifier computing the light pass, others that need it wait for this. */
+  ThreadMutex lock;
+  /** Modifiers using the result, protected by #lineart_shadow_cache_lock. */
+  int users;
+  /** Removed from the cache while in use, the last user frees it. */
+  bool removed;
+
+  /** Holds all of the result, used as #LineartData::shadow_data_pool of the light pass. */
+  LineartStaticMemPool pool;
+  bool generated;
+  LineartElementLinkNode *veln, *eeln;
+  ListBase calculated_edges_elns;
+} LineartShadowCacheEntry;
+
+/**
+ * Evaluations of any graph after which results of other graphs are dropped. Graphs evaluating at
+ * the same time (viewport and final render) keep sharing their results within that many.
+ */
+#define LRT_SHADOW_CACHE_MAX_AGE 64
+
+/** Only protects the list and the users of entries, never held during a light pass. */
+static ListBase lineart_shadow_cache = {NULL, NULL};
+static ThreadMutex lineart_shadow_cache_lock = BLI_MUTEX_INITIALIZER;
+
+static void lineart_shadow_cache_entry_free(LineartShadowCacheEntry *entry)
+{
+  BLI_mutex_end(&entry->lock);
+  lineart_mem_destroy(&entry->pool);
+  MEM_freeN(entry);
+}
+
+/** Needs #lineart_shadow_cache_lock. */
+static void lineart_shadow_cache_entry_remove(LineartShadowCacheEntry *entry)
+{
+  BLI_remlink(&lineart_shadow_cache, entry);
+  if (entry->users == 0) {
+    lineart_shadow_cache_entry_free(entry);
+  }
+  else {
+    entry->removed = true;
+  }
+}
+
+void MOD_lineart_shadow_cache_free(void)
+{
+  BLI_mutex_lock(&lineart_shadow_cache_lock);
+  LISTBASE_FOREACH_MUTABLE (LineartShadowCacheEntry *, entry, &lineart_shadow_cache) {
+    lineart_shadow_cache_entry_remove(entry);
+  }
+  BLI_mutex_unlock(&lineart_shadow_cache_lock);
+}
+
+static void lineart_shadow_cache_key_make(Depsgraph *depsgraph,
+                                          LineartData *shadow_ld,
+                                          LineartGpencilModifierData *lmd,
+                                          LineartShadowCacheKey *r_key)
+{
+  const struct _conf *conf = &shadow_ld->conf;
+
+  /* Compared with #memcmp, so padding has to be cleared. */
+  memset(r_key, 0, sizeof(LineartShadowCacheKey));
+  r_key->depsgraph = depsgraph;
+  r_key->update_count = DEG_get_update_count(depsgraph);
+  r_key->light = lmd->light_contour_object;
+  r_key->allow_duplicates = (lmd->flags & LRT_ALLOW_DUPLI_OBJECTS) != 0;
+  r_key->w = shadow_ld->w;
+  r_key->h = shadow_ld->h;
+
+  r_key->cam_is_persp = conf->cam_is_persp;
+  copy_m4_m4(r_key->cam_obmat, conf->cam_obmat);
+  r_key->near_clip = conf->near_clip;
+  r_key->far_clip = conf->far_clip;
+  r_key->shift_x = conf->shift_x;
+  r_key->shift_y = conf->shift_y;
+
+  r_key->use_contour_secondary = conf->use_contour_secondary;
+  if (conf->use_contour_secondary) {
+    r_key->cam_is_persp_secondary = conf->cam_is_persp_secondary;
+    copy_m4_m4(r_key->cam_obmat_secondary, conf->cam_obmat_secondary);
+    copy_v3_v3_db(r_key->camera_pos_secondary, conf->camera_pos_secondary);
+    copy_v3_v3_db(r_key->view_vector_secondary, conf->view_vector_secondary);
+  }
+
+  r_key->shadow_selection = conf->shadow_selection;
+  r_key->max_occlusion_level = conf->max_occlusion_level;
+  r_key->crease_threshold = conf->crease_threshold;
+  r_key->use_contour = conf->use_contour;
+  r_key->use_crease = conf->use_crease;
+  r_key->use_material = conf->use_material;
+  r_key->use_edge_marks = conf->use_edge_marks;
+  r_key->use_intersections = conf->use_intersections;
+  r_key->use_bvh_intersections = conf->use_bvh_intersections;
+  r_key->use_loose = conf->use_loose;
+  r_key->use_light_contour = conf->use_light_contour;
+  r_key->use_loose_as_contour = conf->use_loose_as_contour;
+  r_key->use_back_face_culling = conf->use_back_face_culling;
+  r_key->allow_boundaries = conf->allow_boundaries;
+  r_key->allow_overlapping_edges = conf->allow_overlapping_edges;
+  r_key->allow_duplicated_types = conf->allow_duplicated_types;
+  r_key->filter_face_mark = conf->filter_face_mark;
+  r_key->filter_face_mark_invert = conf->filter_face_mark_invert;
+  r_key->filter_face_mark_boundaries = conf->filter_face_mark_boundaries;
+  r_key->filter_face_mark_keep_contour = conf->filter_face_mark_keep_contour;
+  r_key->force_crease = conf->force_crease;
+  r_key->sharp_as_crease = conf->sharp_as_crease;
+}
+
+/**
+ * Results are only shared within one evaluation of a graph, see #DEG_get_update_count. Drop the
+ * results of older evaluations of the same graph, and results of other graphs that stopped using
+ * them a number of evaluations ago, as those graphs are done with them or don't exist anymore.
+ * Entries that are still copied from are freed by their last user.
+ */
+static void lineart_shadow_cache_evict(const LineartShadowCacheKey *key)
+{
+  LISTBASE_FOREACH_MUTABLE (LineartShadowCacheEntry *, entry, &lineart_shadow_cache) {
+    if ((entry->key.depsgraph == key->depsgraph &&
+         entry->key.update_count != key->update_count) ||
+        entry->key.update_count + LRT_SHADOW_CACHE_MAX_AGE < key->update_count) {
+      lineart_shadow_cache_entry_remove(entry);
+    }
+  }
+}
+
+static LineartEdgeSegment *lineart_shadow_copy_segments(LineartStaticMemPool *smp,
+                                                        const ListBase *src,
+                                                        ListBase *dst)
+{
+  BLI_listbase_clear(dst);
+  LISTBASE_FOREACH (LineartEdgeSegment *, es, src) {
+    LineartEdgeSegment *new_es = lineart_mem_acquire(smp, sizeof(LineartEdgeSegment));
+    memcpy(new_es, es, sizeof(LineartEdgeSegment));
+    BLI_addtail(dst, new_es);
+  }
+  return dst->first;
+}
+
+/** Copy edges and their segments, vertex pointers are moved to `vert_dst` when given. */
+static LineartElementLinkNode *lineart_shadow_copy_edges(LineartStaticMemPool *smp,
+                                                         const LineartElementLinkNode *eln,
+                                                         const LineartVert *vert_src,
+                                                         LineartVert *vert_dst)
+{
+  LineartElementLinkNode *new_eln = lineart_mem_acquire(smp, sizeof(LineartElementLinkNode));
+  memcpy(new_eln, eln, sizeof(LineartElementLinkNode));
+  new_eln->next = new_eln->prev = NULL;
+
+  const LineartEdge *e = eln->pointer;
+  LineartEdge *new_e = lineart_mem_acquire(smp, sizeof(LineartEdge) * eln->element_count);
+  memcpy(new_e, e, sizeof(LineartEdge) * eln->element_count);
+  new_eln->pointer = new_e;
+
+  for (int i = 0; i < eln->element_count; i++) {
+    lineart_shadow_copy_segments(smp, &e[i].segments, &new_e[i].segments);
+    if (vert_dst) {
+      new_e[i].v1 = &vert_dst[e[i].v1 - vert_src];
+      new_e[i].v2 = &vert_dst[e[i].v2 - vert_src];
+    }
+  }
+  return new_eln;
+}
+
+/**
+ * The modifier changes the light pass result when adding it to its own data, so every user gets
+ * its own copy in `smp`.
+ */
+static void lineart_shadow_cache_entry_copy(const LineartShadowCacheEntry *entry,
+                                            LineartStaticMemPool *smp,
+                                            LineartElementLinkNode **r_veln,
+                                            LineartElementLinkNode **r_eeln,
+                                            ListBase *r_calculated_edges_eln_list)
+{
+  if (entry->generated) {
+    LineartElementLinkNode *veln = lineart_mem_acquire(smp, sizeof(LineartElementLinkNode));
+    memcpy(veln, entry->veln, sizeof(LineartElementLinkNode));
+    veln->pointer = lineart_mem_acquire(smp, sizeof(LineartVert) * veln->element_count);
+    memcpy(veln->pointer, entry->veln->pointer, sizeof(LineartVert) * veln->element_count);
+    *r_veln = veln;
+    *r_eeln = lineart_shadow_copy_edges(smp, entry->eeln, entry->veln->pointer, veln->pointer);
+  }
+  if (r_calculated_edges_eln_list) {
+    BLI_listbase_clear(r_calculated_edges_eln_list);
+    LISTBASE_FOREACH (LineartElementLinkNode *, eln, &entry->calculated_edges_elns) {
+      /* Only segments of these are read, vertices are left as they are. */
+      BLI_addtail(r_calculated_edges_eln_list, lineart_shadow_copy_edges(smp, eln, NULL, NULL));
+    }
+  }
+}
+
+typedef struct LineartShadowGenerateData {
+  Depsgraph *depsgraph;
+  Scene *scene;
+  LineartData *ld;
+  LineartGpencilModifierData *lmd;
+  LineartShadowCacheEntry *entry;
+} LineartShadowGenerateData;
+
+static void lineart_shadow_generate_isolated(void *userdata)
+{
+  LineartShadowGenerateData *data = (LineartShadowGenerateData *)userdata;
+  LineartShadowCacheEntry *entry = data->entry;
+  entry->generated = lineart_shadow_generate(data->depsgraph,
+                                             data->scene,
+                                             data->ld,
+                                             data->lmd,
+                                             &entry->veln,
+                                             &entry->eeln,
+                                             &entry->calculated_edges_elns,
+                                             NULL);
+}
+
+static bool lineart_shadow_cache_get_or_generate(Depsgraph *depsgraph,
+                                                 Scene *scene,
+                                                 LineartData *ld,
+                                                 LineartGpencilModifierData *lmd,
+                                                 LineartStaticMemPool *shadow_data_pool,
+                                                 LineartElementLinkNode **r_veln,
+                                                 LineartElementLinkNode **r_eeln,
+                                                 ListBase *r_calculated_edges_eln_list)
+{
+  LineartShadowCacheKey key;
+  lineart_shadow_cache_key_make(depsgraph, ld, lmd, &key);
+
+  BLI_mutex_lock(&lineart_shadow_cache_lock);
+  lineart_shadow_cache_evict(&key);
+
+  LineartShadowCacheEntry *entry = NULL;
+  LISTBASE_FOREACH (LineartShadowCacheEntry *, iter, &lineart_shadow_cache) {
+    if (memcmp(&iter->key, &key, sizeof(LineartShadowCacheKey)) == 0) {
+      entry = iter;
+      break;
+    }
+  }
+
+  const bool is_new = entry == NULL;
+  if (is_new) {
+    entry = MEM_callocN(sizeof(LineartShadowCacheEntry), "LineartShadowCacheEntry");
+    memcpy(&entry->key, &key, sizeof(LineartShadowCacheKey));
+    BLI_mutex_init(&entry->lock);
+    /* Locked before the entry can be found, so nobody reads it before it's computed. */
+    BLI_mutex_lock(&entry->lock);
+    BLI_addtail(&lineart_shadow_cache, entry);
+  }
+  entry->users++;
+  BLI_mutex_unlock(&lineart_shadow_cache_lock);
+
+  if (is_new) {
+    ld->shadow_data_pool = &entry->pool;
+    if (ld->conf.shadow_selection) {
+      ld->edge_data_pool = &entry->pool;
+    }
+
+    /* Other modifiers that need the same light pass wait for the entry lock, don't let them run
+     * on this thread while it waits for its own tasks. */
+    LineartShadowGenerateData data = {depsgraph, scene, ld, lmd, entry};
+    BLI_task_isolate(lineart_shadow_generate_isolated, &data);
+  }
+  else {
+    BLI_spin_end(&ld->lock_task);
+    BLI_spin_end(&ld->lock_cuts);
+    BLI_spin_end(&ld->render_data_pool.lock_mem);
+    MEM_freeN(ld);
+
+    /* Wait until the result is computed, it isn't modified anymore after that. */
+    BLI_mutex_lock(&entry->lock);
+    if (G.debug_value == 4000) {
+      printf("Line art shadow reused from another modifier.\n");
+    }
+  }
+  BLI_mutex_unlock(&entry->lock);
+
+  lineart_shadow_cache_entry_copy(
+      entry, shadow_data_pool, r_veln, r_eeln, r_calculated_edges_eln_list);
+  const bool generated = entry->generated;
+
+  BLI_mutex_lock(&lineart_shadow_cache_lock);
+  entry->users--;
+  if (entry->removed && entry->users == 0) {
+    lineart_shadow_cache_entry_free(entry);
+  }
+  BLI_mutex_unlock(&lineart_shadow_cache_lock);
+
+  return generated;
+}
+
+/* This call would internally duplicate #original_ld, override necessary configurations for shadow
+ * computations. It will return:
+ *
+ * 1) Generated shadow edges in format of `LineartElementLinkNode` which can be directly loaded
+ * into later main view camera occlusion stage.
+ * 2) Shadow render buffer if 3rd stage reprojection is need for silhouette/lit/shaded region
+ * selection. Otherwise the shadow render buffer is deleted before this function returns.
+ *
+ * Without 3rd stage reprojection, the result is shared with other modifiers that need the same
+ * one during the same evaluation, see #LineartShadowCacheEntry.
+ */
+bool lineart_main_try_generate_shadow(Depsgraph *depsgraph,
+                                      Scene *scene,
+                                      LineartData *original_ld,
+                                      LineartGpencilModifierData *lmd,
+                                      LineartStaticMemPool *shadow_data_pool,
+                                      LineartElementLinkNode **r_veln,
+                                      LineartElementLinkNode **r_eeln,
+                                      ListBase *r_calculated_edges_eln_list,
+                                      LineartData **r_shadow_ld_if_reproject)
+{
+  if ((!original_ld->conf.use_shadow && !original_ld->conf.use_light_contour &&
+       !original_ld->conf.shadow_selection) ||
+      (!lmd->light_contour_object)) {
+    return false;
+  }
+
+  double t_start;
+  if (G.debug_value == 4000) {
+    t_start = PIL_check_seconds_timer();
+  }
+
+  LineartData *ld = lineart_shadow_data_create(original_ld, lmd, shadow_data_pool);
+
+  bool any_generated;
+  if (ld->conf.shadow_enclose_shapes) {
+    /* The light pass data is kept for re-projecting, which can't be shared. */
+    any_generated = lineart_shadow_generate(depsgraph,
+                                            scene,
+                                            ld,
+                                            lmd,
+                                            r_veln,
+                                            r_eeln,
+                                            r_calculated_edges_eln_list,
+                                            r_shadow_ld_if_reproject);
+  }
+  else {
+    any_generated = lineart_shadow_cache_get_or_generate(depsgraph,
+                                                         scene,
+                                                         ld,
+                                                         lmd,
+                                                         shadow_data_pool,
+                                                         r_veln,
+                                                         r_eeln,
+                                                         ld->conf.shadow_selection ?
+                                                             r_calculated_edges_eln_list :
+                                                             NULL);
+  }
+
   if (G.debug_value == 4000) {
     double t_elapsed = PIL_check_seconds_timer() - t_start;
     printf("Line art shadow stage 1 time: %f\n", t_elapsed);
@@ -1416,8 +1821,6 @@ void lineart_main_make_enclosed_shapes(LineartData *ld, LineartData *shadow_ld)
     lineart_add_edge_to_array(&shadow_ld->pending_edges, &se[i]);
   }
 
-  shadow_ld->scheduled_count = 0;
-
   lineart_main_clear_linked_edges(shadow_ld);
   lineart_main_link_lines(shadow_ld);
   lineart_main_occlusion_begin(shadow_ld);
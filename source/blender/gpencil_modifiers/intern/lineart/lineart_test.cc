@@ -0,0 +1,192 @@
+/* SPDX-License-Identifier: GPL-2.0-or-later */
+
+/** \file
+ * \ingroup editors
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_math_matrix.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+
+#include "MOD_lineart.h"
+
+#include "lineart_intern.h"
+
+namespace blender::lineart::tests {
+
+static constexpr int triangle_count = 64;
+
+/**
+ * Coordinates on a coarse grid, so that edges often lie exactly on the triangle bounds and the
+ * comparisons at the boundaries are covered too.
+ */
+static float random_coordinate(RandomNumberGenerator &rng)
+{
+  return float(rng.get_int32(17) - 8) * 0.25f;
+}
+
+static Vector<float> random_triangle_bounds(RandomNumberGenerator &rng, const int stride)
+{
+  Vector<float> bounds(stride * LRT_TRIANGLE_BOUNDS_ROWS);
+  for (const int i : IndexRange(triangle_count)) {
+    for (int axis = 0; axis < 2; axis++) {
+      const float a = random_coordinate(rng), b = random_coordinate(rng);
+      bounds[stride * (axis * 2) + i] = std::min(a, b);
+      bounds[stride * (axis * 2 + 1) + i] = std::max(a, b);
+    }
+    bounds[stride * 4 + i] = random_coordinate(rng);
+    /* Edge functions `x, y, c` of the three triangle edges. */
+    for (int row = 0; row < 9; row++) {
+      bounds[stride * (LRT_TRIANGLE_BOUNDS_EDGES_ROW + row) + i] = random_coordinate(rng);
+    }
+    bounds[stride * (LRT_TRIANGLE_BOUNDS_EDGES_ROW + 9) + i] = std::abs(random_coordinate(rng));
+  }
+  return bounds;
+}
+
+TEST(lineart, triangle_bounds_reject_mask)
+{
+  RandomNumberGenerator rng(42);
+  const int stride = triangle_count;
+  const Vector<float> bounds = random_triangle_bounds(rng, stride);
+
+  for (int iteration = 0; iteration < 1000; iteration++) {
+    const float x1 = random_coordinate(rng), x2 = random_coordinate(rng);
+    const float y1 = random_coordinate(rng), y2 = random_coordinate(rng);
+    const float edge_bounds[5] = {
+        std::min(x1, x2), std::max(x1, x2), std::min(y1, y2), std::max(y1, y2), x1};
+    for (int start = 0; start < triangle_count; start += LRT_TRIANGLE_BOUNDS_WIDTH) {
+      EXPECT_EQ(lineart_triangle_bounds_reject_mask(bounds.data(), stride, start, edge_bounds),
+                lineart_triangle_bounds_reject_mask_scalar(
+                    bounds.data(), stride, start, edge_bounds));
+    }
+  }
+}
+
+TEST(lineart, triangle_edges_reject_mask)
+{
+  RandomNumberGenerator rng(42);
+  const int stride = triangle_count;
+  const Vector<float> bounds = random_triangle_bounds(rng, stride);
+
+  for (int iteration = 0; iteration < 1000; iteration++) {
+    float edge_points[5];
+    for (int i = 0; i < 4; i++) {
+      edge_points[i] = random_coordinate(rng);
+    }
+    edge_points[4] = std::max(std::max(std::abs(edge_points[0]), std::abs(edge_points[1])),
+                              std::max(std::abs(edge_points[2]), std::abs(edge_points[3])));
+    for (int start = 0; start < triangle_count; start += LRT_TRIANGLE_BOUNDS_WIDTH) {
+      EXPECT_EQ(lineart_triangle_edges_reject_mask(bounds.data(), stride, start, edge_points),
+                lineart_triangle_edges_reject_mask_scalar(
+                    bounds.data(), stride, start, edge_points));
+    }
+  }
+}
+
+static void random_vert(RandomNumberGenerator &rng, LineartVert &v)
+{
+  for (int i = 0; i < 3; i++) {
+    v.gloc[i] = random_coordinate(rng);
+    /* Also cover coordinates just next to the grid. */
+    if (rng.get_int32(4) == 0) {
+      v.gloc[i] += (rng.get_double() - 0.5) * 1e-6;
+    }
+  }
+  /* Orthographic camera looking along Z, with the identity view projection. */
+  copy_v3_v3_db(v.fbcoord, v.gloc);
+  v.fbcoord[3] = 1.0;
+}
+
+/**
+ * Triangles rejected by the bounds and edge function prefilter must never occlude the edge, the
+ * others go through #lineart_triangle_edge_image_space_occlusion either way. So the occlusion
+ * found with the prefilter is the same as without it.
+ */
+TEST(lineart, triangle_edge_occlusion_prefilter)
+{
+  RandomNumberGenerator rng(42);
+  const double camera_pos[3] = {0.0, 0.0, 10.0};
+  const double camera_dir[3] = {0.0, 0.0, 1.0};
+  double view_projection[4][4];
+  unit_m4_db(view_projection);
+
+  int rejected_count = 0, occluded_count = 0;
+  for (int set = 0; set < 20; set++) {
+    Array<LineartVert> verts(triangle_count * 3);
+    Array<LineartTriangle> triangles(triangle_count);
+    Array<LineartTriangle *> triangle_pointers(triangle_count);
+    for (const int i : IndexRange(triangle_count)) {
+      LineartTriangle &tri = triangles[i];
+      memset(&tri, 0, sizeof(LineartTriangle));
+      for (int k = 0; k < 3; k++) {
+        random_vert(rng, verts[i * 3 + k]);
+        tri.v[k] = &verts[i * 3 + k];
+      }
+      double d1[3], d2[3];
+      sub_v3_v3v3_db(d1, tri.v[1]->gloc, tri.v[0]->gloc);
+      sub_v3_v3v3_db(d2, tri.v[2]->gloc, tri.v[0]->gloc);
+      cross_v3_v3v3_db(tri.gn, d1, d2);
+      normalize_v3_db(tri.gn);
+      tri.mat_occlusion = 1;
+      tri.target_reference = i + 1;
+      triangle_pointers[i] = &tri;
+    }
+
+    LineartBoundingArea ba;
+    memset(&ba, 0, sizeof(LineartBoundingArea));
+    Vector<float> bounds(triangle_count * LRT_TRIANGLE_BOUNDS_ROWS);
+    ba.triangle_count = triangle_count;
+    ba.linked_triangles = triangle_pointers.data();
+    ba.triangle_bounds = bounds.data();
+    lineart_bounding_area_build_triangle_bounds(&ba);
+
+    for (int iteration = 0; iteration < 100; iteration++) {
+      LineartVert v1, v2;
+      random_vert(rng, v1);
+      random_vert(rng, v2);
+      LineartEdge e;
+      memset(&e, 0, sizeof(LineartEdge));
+      e.v1 = &v1;
+      e.v2 = &v2;
+      float edge_bounds[5], edge_points[5];
+      lineart_edge_reject_data_get(&e, edge_bounds, edge_points);
+
+      for (int start = 0; start < triangle_count; start += LRT_TRIANGLE_BOUNDS_WIDTH) {
+        const float *data = bounds.data();
+        const int mask =
+            lineart_triangle_bounds_reject_mask(data, triangle_count, start, edge_bounds) |
+            lineart_triangle_edges_reject_mask(data, triangle_count, start, edge_points);
+        for (int lane = 0; lane < LRT_TRIANGLE_BOUNDS_WIDTH; lane++) {
+          double from, to;
+          const bool occluded = lineart_triangle_edge_image_space_occlusion(
+              &triangles[start + lane],
+              &e,
+              camera_pos,
+              false,
+              false,
+              view_projection,
+              camera_dir,
+              0.0f,
+              0.0f,
+              &from,
+              &to);
+          if (mask & (1 << lane)) {
+            EXPECT_FALSE(occluded);
+            rejected_count++;
+          }
+          occluded_count += occluded;
+        }
+      }
+    }
+  }
+  /* Both cases have to be covered for the comparison to mean anything. */
+  EXPECT_GT(rejected_count, 0);
+  EXPECT_GT(occluded_count, 0);
+}
+
+}  // namespace blender::lineart::tests
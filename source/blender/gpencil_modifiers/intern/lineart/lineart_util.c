@@ -13,9 +13,15 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "MOD_gpencil_lineart.h"
 #include "MOD_lineart.h"
 
+#include "BLI_dynstr.h"
 #include "BLI_math.h"
+#include "BLI_string.h"
+#include "BLI_timer.h"
+
+#include "PIL_time.h"
 
 #include "lineart_intern.h"
 
@@ -88,17 +94,132 @@ void lineart_list_remove_pointer_item_no_free(ListBase *h, LinkData *lip)
   BLI_remlink(h, (void *)lip);
 }
 
+/* Spare pool nodes, shared by all pools. */
+static ThreadMutex lineart_mem_spare_lock = BLI_MUTEX_INITIALIZER;
+static ListBase lineart_mem_spare_bins[LRT_MEMORY_SPARE_BINS];
+static size_t lineart_mem_spare_size = 0;
+
+/** Smallest bin with nodes large enough for `size`, or -1 if there is none. */
+static int lineart_mem_spare_bin(size_t size)
+{
+  for (int bin = 0; bin < LRT_MEMORY_SPARE_BINS; bin++) {
+    if (size <= ((size_t)LRT_MEMORY_POOL_1MB << bin)) {
+      return bin;
+    }
+  }
+  return -1;
+}
+
+/** Free spare nodes that haven't been used for a while, call with the lock held. */
+static void lineart_mem_spare_trim(double now)
+{
+  for (int bin = 0; bin < LRT_MEMORY_SPARE_BINS; bin++) {
+    LineartStaticMemPoolNode *smpn;
+    /* Nodes are added to the tail, so the oldest are at the head. */
+    while ((smpn = lineart_mem_spare_bins[bin].first) &&
+           now - smpn->spare_time > LRT_MEMORY_SPARE_LIFETIME) {
+      BLI_remlink(&lineart_mem_spare_bins[bin], smpn);
+      lineart_mem_spare_size -= smpn->size;
+      MEM_freeN(smpn);
+    }
+  }
+}
+
+static LineartStaticMemPoolNode *lineart_mem_spare_take(int bin)
+{
+  BLI_mutex_lock(&lineart_mem_spare_lock);
+  lineart_mem_spare_trim(PIL_check_seconds_timer());
+  LineartStaticMemPoolNode *smpn = bin >= 0 ? BLI_poptail(&lineart_mem_spare_bins[bin]) : NULL;
+  if (smpn) {
+    lineart_mem_spare_size -= smpn->size;
+  }
+  BLI_mutex_unlock(&lineart_mem_spare_lock);
+  return smpn;
+}
+
+static void lineart_mem_spare_give(LineartStaticMemPoolNode *smpn, LineartMemUsage *usage)
+{
+  const double now = PIL_check_seconds_timer();
+  const int bin = lineart_mem_spare_bin(smpn->size - sizeof(LineartStaticMemPoolNode));
+
+  BLI_mutex_lock(&lineart_mem_spare_lock);
+  lineart_mem_spare_trim(now);
+  if (usage) {
+    usage->used -= smpn->size;
+  }
+  if (bin >= 0 &&
+      smpn->size - sizeof(LineartStaticMemPoolNode) == ((size_t)LRT_MEMORY_POOL_1MB << bin) &&
+      lineart_mem_spare_size + smpn->size <= LRT_MEMORY_SPARE_MAX) {
+    smpn->spare_time = now;
+    BLI_addtail(&lineart_mem_spare_bins[bin], smpn);
+    lineart_mem_spare_size += smpn->size;
+    smpn = NULL;
+  }
+  BLI_mutex_unlock(&lineart_mem_spare_lock);
+
+  if (smpn) {
+    MEM_freeN(smpn);
+  }
+}
+
+void MOD_lineart_memory_free_spare(void)
+{
+  BLI_mutex_lock(&lineart_mem_spare_lock);
+  for (int bin = 0; bin < LRT_MEMORY_SPARE_BINS; bin++) {
+    BLI_freelistN(&lineart_mem_spare_bins[bin]);
+  }
+  lineart_mem_spare_size = 0;
+  BLI_mutex_unlock(&lineart_mem_spare_lock);
+}
+
+static double lineart_mem_spare_trim_timer(uintptr_t UNUSED(uuid), void *UNUSED(user_data))
+{
+  BLI_mutex_lock(&lineart_mem_spare_lock);
+  lineart_mem_spare_trim(PIL_check_seconds_timer());
+  BLI_mutex_unlock(&lineart_mem_spare_lock);
+  return LRT_MEMORY_SPARE_LIFETIME;
+}
+
+void MOD_lineart_memory_init(void)
+{
+  /* Line art may not run again for a long time, so don't rely on it to free its spare nodes. */
+  BLI_timer_register((uintptr_t)lineart_mem_spare_bins,
+                     lineart_mem_spare_trim_timer,
+                     NULL,
+                     NULL,
+                     LRT_MEMORY_SPARE_LIFETIME,
+                     true);
+}
+
 LineartStaticMemPoolNode *lineart_mem_new_static_pool(LineartStaticMemPool *smp, size_t size)
 {
-  size_t set_size = size;
-  if (set_size < LRT_MEMORY_POOL_1MB) {
-    set_size = LRT_MEMORY_POOL_1MB; /* Prevent too many small allocations. */
+  /* Prevent too many small allocations, and round up so the node can be reused by any request
+   * of the same bin. */
+  const int bin = lineart_mem_spare_bin(size);
+  const size_t set_size = bin >= 0 ? ((size_t)LRT_MEMORY_POOL_1MB << bin) : size;
+
+  LineartStaticMemPoolNode *smpn = lineart_mem_spare_take(bin);
+  if (smpn) {
+    /* Clear what the previous pool wrote, memory after that is still zero. */
+    memset(smpn + 1, 0, smpn->used_byte - sizeof(LineartStaticMemPoolNode));
+  }
+  else {
+    size_t total_size = set_size + sizeof(LineartStaticMemPoolNode);
+    smpn = MEM_callocN(total_size, "mempool");
+    smpn->size = total_size;
   }
-  size_t total_size = set_size + sizeof(LineartStaticMemPoolNode);
-  LineartStaticMemPoolNode *smpn = MEM_callocN(total_size, "mempool");
-  smpn->size = total_size;
   smpn->used_byte = sizeof(LineartStaticMemPoolNode);
   BLI_addhead(&smp->pools, smpn);
+
+  LineartMemUsage *usage = smp->usage;
+  if (usage) {
+    /* Pools of one calculation are filled from several threads. */
+    BLI_mutex_lock(&lineart_mem_spare_lock);
+    usage->used += smpn->size;
+    usage->peak = MAX2(usage->peak, usage->used);
+    BLI_mutex_unlock(&lineart_mem_spare_lock);
+  }
+
   return smpn;
 }
 void *lineart_mem_acquire(LineartStaticMemPool *smp, size_t size)
@@ -140,7 +261,7 @@ void lineart_mem_destroy(LineartStaticMemPool *smp)
 {
   LineartStaticMemPoolNode *smpn;
   while ((smpn = BLI_pophead(&smp->pools)) != NULL) {
-    MEM_freeN(smpn);
+    lineart_mem_spare_give(smpn, smp->usage);
   }
 }
 
@@ -213,7 +334,7 @@ void lineart_count_and_print_render_buffer_memory(LineartData *ld)
 
   LISTBASE_FOREACH (LineartStaticMemPoolNode *, smpn, &ld->render_data_pool.pools) {
     count_this++;
-    sum_this += LRT_MEMORY_POOL_1MB;
+    sum_this += smpn->size;
   }
   printf("LANPR Memory allocated %zu Standalone nodes, total %zu Bytes.\n", count_this, sum_this);
   total += sum_this;
@@ -240,3 +361,83 @@ void lineart_count_and_print_render_buffer_memory(LineartData *ld)
 
   (void)total; /* Ignored. */
 }
+
+size_t lineart_mem_pool_size(const LineartStaticMemPool *smp)
+{
+  size_t total = 0;
+  LISTBASE_FOREACH (LineartStaticMemPoolNode *, smpn, &smp->pools) {
+    total += smpn->size;
+  }
+  return total;
+}
+
+void lineart_profile_stage_end(LineartData *ld, int stage, double t_start)
+{
+  if (ld->profile) {
+    ld->profile->stages[stage].time += PIL_check_seconds_timer() - t_start;
+  }
+}
+
+static const char *lineart_profile_stage_names[LRT_PROFILE_STAGE_COUNT] = {
+    "load",
+    "cull",
+    "quadtree",
+    "intersection",
+    "occlusion",
+    "shadow",
+    "chaining",
+    "smoothing",
+    "gpencil",
+};
+
+int MOD_lineart_profile_to_json(const LineartProfile *profile, char *r_str, int maxlen)
+{
+  if (!profile) {
+    return (int)BLI_strncpy_rlen(r_str, "{}", maxlen);
+  }
+
+  DynStr *ds = BLI_dynstr_new();
+  BLI_dynstr_appendf(ds,
+                     "{\"reused\": %s, \"used_cache\": %s, \"total_time\": %.6f, "
+                     "\"thread_count\": %d, ",
+                     profile->reused ? "true" : "false",
+                     profile->used_cache ? "true" : "false",
+                     profile->total_time,
+                     profile->thread_count);
+  BLI_dynstr_appendf(ds,
+                     "\"triangles\": %d, \"edges\": %d, \"segments\": %d, \"chains\": %d, ",
+                     profile->triangle_count,
+                     profile->edge_count,
+                     profile->segment_count,
+                     profile->chain_count);
+  BLI_dynstr_appendf(ds,
+                     "\"memory\": {\"render_pool\": %zu, \"chain_pool\": %zu, "
+                     "\"shadow_pool\": %zu, \"peak\": %zu}, \"stages\": {",
+                     profile->render_pool_bytes,
+                     profile->chain_pool_bytes,
+                     profile->shadow_pool_bytes,
+                     profile->peak_bytes);
+  for (int i = 0; i < LRT_PROFILE_STAGE_COUNT; i++) {
+    const LineartProfileStage *stage = &profile->stages[i];
+    BLI_dynstr_appendf(ds,
+                       "%s\"%s\": {\"time\": %.6f",
+                       i ? ", " : "",
+                       lineart_profile_stage_names[i],
+                       stage->time);
+    if (stage->thread_time > 0.0 && stage->time > 0.0 && profile->thread_count) {
+      /* Share of the available thread time that was spent working. */
+      BLI_dynstr_appendf(ds,
+                         ", \"thread_time\": %.6f, \"utilization\": %.4f",
+                         stage->thread_time,
+                         stage->thread_time / (stage->time * profile->thread_count));
+    }
+    BLI_dynstr_append(ds, "}");
+  }
+  BLI_dynstr_append(ds, "}}");
+
+  char *str = BLI_dynstr_get_cstring(ds);
+  const int len = (int)BLI_strncpy_rlen(r_str, str, maxlen);
+  MEM_freeN(str);
+  BLI_dynstr_free(ds);
+  return len;
+}
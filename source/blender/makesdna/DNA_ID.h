@@ -900,6 +900,16 @@ enum {
    * RESET_NEVER
    */
   LIB_TAG_LIB_OVERRIDE_NEED_RESYNC = 1 << 21,
+
+  /**
+   * ID was modified since the last memfile undo push in a way that is not necessarily tracked by
+   * #ID.recalc_after_undo_push, e.g. renaming, editing ID properties or asset metadata. Set by
+   * generic editing interfaces (RNA, Python ID properties), and used to know whether the data of
+   * the last undo step can be reused for this ID.
+   *
+   * RESET_AFTER_USE
+   */
+  LIB_TAG_UNDO_CHANGED = 1 << 23,
 };
 
 /**
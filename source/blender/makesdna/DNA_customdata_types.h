@@ -21,8 +21,13 @@ namespace blender::bke {
 class AnonymousAttributeID;
 }  // namespace blender::bke
 using AnonymousAttributeIDHandle = blender::bke::AnonymousAttributeID;
+namespace blender {
+class ImplicitSharingInfo;
+}  // namespace blender
+using ImplicitSharingInfoHandle = blender::ImplicitSharingInfo;
 #else
 typedef struct AnonymousAttributeIDHandle AnonymousAttributeIDHandle;
+typedef struct ImplicitSharingInfoHandle ImplicitSharingInfoHandle;
 #endif
 
 /** Descriptor and storage for a custom data layer. */
@@ -53,6 +58,12 @@ typedef struct CustomDataLayer {
    * attribute was created.
    */
   const AnonymousAttributeIDHandle *anonymous_id;
+  /**
+   * Run-time user count of #data, which may be shared with layers of other #CustomData (e.g. the
+   * original and the evaluated mesh). Shared data has to be copied before it is modified.
+   * Null for layers that reference data they don't own (#CD_FLAG_NOFREE).
+   */
+  const ImplicitSharingInfoHandle *sharing_info;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 68
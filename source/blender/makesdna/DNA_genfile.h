@@ -122,6 +122,22 @@ void *DNA_struct_reconstruct(const struct DNA_ReconstructInfo *reconstruct_info,
                              int old_struct_nr,
                              int blocks,
                              const void *old_blocks);
+/**
+ * Size of one element of the struct after reconstruction, or 0 when the struct doesn't exist in
+ * the new SDNA anymore.
+ */
+int DNA_struct_reconstruct_size(const struct DNA_ReconstructInfo *reconstruct_info,
+                                int old_struct_nr);
+/**
+ * Like #DNA_struct_reconstruct, but converts into zero initialized memory of
+ * `blocks * DNA_struct_reconstruct_size()` bytes. Elements are converted independently of each
+ * other, so ranges of a large array can be converted on different threads.
+ */
+void DNA_struct_reconstruct_into(const struct DNA_ReconstructInfo *reconstruct_info,
+                                 int old_struct_nr,
+                                 int blocks,
+                                 const void *old_blocks,
+                                 void *new_blocks);
 
 /**
  * Returns the offset of the field with the specified name and type within the specified
@@ -1211,6 +1211,10 @@ typedef struct LineartGpencilModifierData {
   struct LineartCache *cache;
   /* Keep a pointer to the render buffer so we can call destroy from ModifierData. */
   struct LineartData *la_data_ptr;
+  /* Result of the previous evaluation, only kept when #LRT_USE_INCREMENTAL is set. */
+  struct LineartIncrementalCache *la_incremental_ptr;
+  /* Stage timings and counts of the last calculation done by this modifier. */
+  struct LineartProfile *la_profile_ptr;
 
 } LineartGpencilModifierData;
 
@@ -39,6 +39,10 @@ typedef enum eLineartMainFlags {
   LRT_USE_IMAGE_BOUNDARY_TRIMMING = (1 << 20),
   LRT_CHAIN_PRESERVE_DETAILS = (1 << 22),
   LRT_SHADOW_USE_SILHOUETTE = (1 << 24),
+  /** Reuse unchanged objects and their occlusion from the previous calculation. */
+  LRT_USE_INCREMENTAL = (1 << 25),
+  /** Find intersecting triangle pairs with a 3D BVH instead of shared screen space tiles. */
+  LRT_USE_BVH_INTERSECTION = (1 << 26),
 } eLineartMainFlags;
 
 typedef enum eLineartEdgeFlag {
@@ -1211,10 +1211,7 @@ static void reconstruct_structs(const DNA_ReconstructInfo *reconstruct_info,
   }
 }
 
-void *DNA_struct_reconstruct(const DNA_ReconstructInfo *reconstruct_info,
-                             int old_struct_nr,
-                             int blocks,
-                             const void *old_blocks)
+int DNA_struct_reconstruct_size(const DNA_ReconstructInfo *reconstruct_info, int old_struct_nr)
 {
   const SDNA *oldsdna = reconstruct_info->oldsdna;
   const SDNA *newsdna = reconstruct_info->newsdna;
@@ -1224,15 +1221,41 @@ void *DNA_struct_reconstruct(const DNA_ReconstructInfo *reconstruct_info,
   const int new_struct_nr = DNA_struct_find_nr(newsdna, type_name);
 
   if (new_struct_nr == -1) {
-    return NULL;
+    return 0;
   }
+  return newsdna->types_size[newsdna->structs[new_struct_nr]->type];
+}
 
-  const SDNA_Struct *new_struct = newsdna->structs[new_struct_nr];
-  const int new_block_size = newsdna->types_size[new_struct->type];
+void DNA_struct_reconstruct_into(const DNA_ReconstructInfo *reconstruct_info,
+                                 int old_struct_nr,
+                                 int blocks,
+                                 const void *old_blocks,
+                                 void *new_blocks)
+{
+  const SDNA *oldsdna = reconstruct_info->oldsdna;
+  const SDNA *newsdna = reconstruct_info->newsdna;
 
-  char *new_blocks = MEM_callocN(blocks * new_block_size, "reconstruct");
+  const SDNA_Struct *old_struct = oldsdna->structs[old_struct_nr];
+  const char *type_name = oldsdna->types[old_struct->type];
+  const int new_struct_nr = DNA_struct_find_nr(newsdna, type_name);
+
+  BLI_assert(new_struct_nr != -1);
   reconstruct_structs(
       reconstruct_info, blocks, old_struct_nr, new_struct_nr, old_blocks, new_blocks);
+}
+
+void *DNA_struct_reconstruct(const DNA_ReconstructInfo *reconstruct_info,
+                             int old_struct_nr,
+                             int blocks,
+                             const void *old_blocks)
+{
+  const int new_block_size = DNA_struct_reconstruct_size(reconstruct_info, old_struct_nr);
+  if (new_block_size == 0) {
+    return NULL;
+  }
+
+  char *new_blocks = MEM_callocN(blocks * new_block_size, "reconstruct");
+  DNA_struct_reconstruct_into(reconstruct_info, old_struct_nr, blocks, old_blocks, new_blocks);
   return new_blocks;
 }
 
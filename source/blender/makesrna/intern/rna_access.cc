@@ -2086,6 +2086,10 @@ static void rna_property_update(
   const bool is_rna = (prop->magic == RNA_MAGIC);
   prop = rna_ensure_property(prop);
 
+  if (ptr->owner_id != nullptr) {
+    ptr->owner_id->tag |= LIB_TAG_UNDO_CHANGED;
+  }
+
   if (is_rna) {
     if (prop->update) {
       /* ideally no context would be needed for update, but there's some
@@ -6293,6 +6297,10 @@ int RNA_function_call(
     bContext *C, ReportList *reports, PointerRNA *ptr, FunctionRNA *func, ParameterList *parms)
 {
   if (func->call) {
+    /* Functions can modify their owner in any way, without necessarily tagging it for update. */
+    if (ptr->owner_id != nullptr) {
+      ptr->owner_id->tag |= LIB_TAG_UNDO_CHANGED;
+    }
     func->call(C, reports, ptr, parms);
 
     return 0;
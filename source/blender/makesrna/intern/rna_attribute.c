@@ -264,6 +264,8 @@ static void rna_Attribute_data_begin(CollectionPropertyIterator *iter, PointerRN
   int length = BKE_id_attribute_data_length(id, layer);
   size_t struct_size;
 
+  CustomData_ensure_data_is_mutable(layer, length);
+
   switch (layer->type) {
     case CD_PROP_FLOAT:
       struct_size = sizeof(MFloatProperty);
@@ -26,6 +26,8 @@
 
 #include "BKE_animsys.h"
 
+#include "MOD_gpencil_lineart.h"
+
 #include "RNA_access.h"
 #include "RNA_define.h"
 #include "RNA_enum_types.h"
@@ -805,6 +807,19 @@ static void rna_Lineart_end_level_set(PointerRNA *ptr, int value)
   lmd->level_start = MIN2(value, lmd->level_start);
 }
 
+static void rna_LineartGpencilModifier_profile_json_get(PointerRNA *ptr, char *value)
+{
+  LineartGpencilModifierData *lmd = (LineartGpencilModifierData *)ptr->data;
+  MOD_lineart_profile_to_json(lmd->la_profile_ptr, value, LRT_PROFILE_JSON_MAXLEN);
+}
+
+static int rna_LineartGpencilModifier_profile_json_length(PointerRNA *ptr)
+{
+  LineartGpencilModifierData *lmd = (LineartGpencilModifierData *)ptr->data;
+  char buf[LRT_PROFILE_JSON_MAXLEN];
+  return MOD_lineart_profile_to_json(lmd->la_profile_ptr, buf, sizeof(buf));
+}
+
 static void rna_GpencilDash_segments_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   DashGpencilModifierData *dmd = (DashGpencilModifierData *)ptr->data;
@@ -3890,6 +3905,17 @@ static void rna_def_modifier_gpencillineart(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Is Baked", "This modifier has baked data");
   RNA_def_property_update(prop, 0, "rna_GpencilModifier_update");
 
+  prop = RNA_def_property(srna, "profile_json", PROP_STRING, PROP_NONE);
+  RNA_def_property_string_funcs(prop,
+                                "rna_LineartGpencilModifier_profile_json_get",
+                                "rna_LineartGpencilModifier_profile_json_length",
+                                NULL);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop,
+                           "Profile",
+                           "Per-stage timings, counts and memory use of the last calculation as "
+                           "JSON, read it from the evaluated modifier");
+
   prop = RNA_def_property(srna, "use_cache", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flags", LRT_GPENCIL_USE_CACHE);
   RNA_def_property_ui_text(prop,
@@ -3937,6 +3963,14 @@ static void rna_def_modifier_gpencillineart(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Masks", "Mask bits to match from Material Line Art settings");
   RNA_def_property_update(prop, 0, "rna_GpencilModifier_update");
 
+  prop = RNA_def_property(srna, "use_intersection_bvh", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "calculation_flags", LRT_USE_BVH_INTERSECTION);
+  RNA_def_property_ui_text(prop,
+                           "Use BVH",
+                           "Find intersecting faces with a bounding volume hierarchy, faster "
+                           "for dense overlapping geometry such as foliage and crowds");
+  RNA_def_property_update(prop, 0, "rna_GpencilModifier_update");
+
   prop = RNA_def_property(srna, "use_intersection_match", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "mask_switches", LRT_GPENCIL_INTERSECTION_MATCH);
   RNA_def_property_ui_text(
@@ -3977,6 +4011,15 @@ static void rna_def_modifier_gpencillineart(BlenderRNA *brna)
       "different occlusion levels than when disabled");
   RNA_def_property_update(prop, 0, "rna_GpencilModifier_update");
 
+  prop = RNA_def_property(srna, "use_incremental", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "calculation_flags", LRT_USE_INCREMENTAL);
+  RNA_def_property_ui_text(prop,
+                           "Incremental Update",
+                           "Keep the loaded objects between frames, only load the objects that "
+                           "changed and only test the occlusion of lines near them again (not "
+                           "used with shadows)");
+  RNA_def_property_update(prop, 0, "rna_GpencilModifier_update");
+
   prop = RNA_def_property(srna, "shadow_camera_near", PROP_FLOAT, PROP_NONE);
   RNA_def_property_ui_text(prop, "Shadow Camera Near", "Near clipping distance of shadow camera");
   RNA_def_property_ui_range(prop, 0.0f, 500.0f, 0.1f, 2);
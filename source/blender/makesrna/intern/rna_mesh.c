@@ -1042,6 +1042,7 @@ static void rna_MeshUVLoopLayer_data_begin(CollectionPropertyIterator *iter, Poi
 {
   Mesh *mesh = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, mesh->totloop);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(float[2]), (mesh->edit_mesh) ? 0 : mesh->totloop, 0, NULL);
 }
@@ -1145,6 +1146,7 @@ static void rna_MeshUVLoopLayer_uv_begin(CollectionPropertyIterator *iter, Point
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totloop);
 
   rna_iterator_array_begin(
       iter, layer->data, sizeof(float[2]), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
@@ -1157,6 +1159,7 @@ int rna_MeshUVLoopLayer_uv_lookup_int(PointerRNA *ptr, int index, PointerRNA *r_
     return 0;
   }
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, mesh->totloop);
 
   r_ptr->owner_id = &mesh->id;
   r_ptr->type = &RNA_Float2AttributeValue;
@@ -1252,6 +1255,7 @@ static void rna_MeshLoopColorLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totloop);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MLoopCol), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
 }
@@ -1355,6 +1359,7 @@ static void rna_MeshVertColorLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MPropCol), (me->edit_mesh) ? 0 : me->totvert, 0, NULL);
 }
@@ -1494,6 +1499,7 @@ static void rna_MeshSkinVertexLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MVertSkin), me->totvert, 0, NULL);
 }
 
@@ -1517,6 +1523,7 @@ static void rna_MeshVertexCreaseLayer_data_begin(CollectionPropertyIterator *ite
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(float), me->totvert, 0, NULL);
 }
 
@@ -1542,6 +1549,7 @@ static void rna_MeshEdgeCreaseLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totedge);
   rna_iterator_array_begin(iter, layer->data, sizeof(float), me->totedge, 0, NULL);
 }
 
@@ -1573,6 +1581,7 @@ static void rna_MeshPaintMaskLayer_data_begin(CollectionPropertyIterator *iter,
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MFloatProperty), (me->edit_mesh) ? 0 : me->totvert, 0, NULL);
 }
@@ -1603,6 +1612,7 @@ static void rna_MeshFaceMapLayer_data_begin(CollectionPropertyIterator *iter, Po
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totpoly);
   rna_iterator_array_begin(
       iter, layer->data, sizeof(int), (me->edit_mesh) ? 0 : me->totpoly, 0, NULL);
 }
@@ -2267,6 +2277,7 @@ static void rna_MeshVertexFloatPropertyLayer_data_begin(CollectionPropertyIterat
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonFloatPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -2274,6 +2285,7 @@ static void rna_MeshPolygonFloatPropertyLayer_data_begin(CollectionPropertyItera
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totpoly, 0, NULL);
 }
 
@@ -2318,6 +2330,7 @@ static void rna_MeshVertexIntPropertyLayer_data_begin(CollectionPropertyIterator
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonIntPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -2325,6 +2338,7 @@ static void rna_MeshPolygonIntPropertyLayer_data_begin(CollectionPropertyIterato
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totpoly, 0, NULL);
 }
 
@@ -2369,6 +2383,7 @@ static void rna_MeshVertexStringPropertyLayer_data_begin(CollectionPropertyItera
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totvert);
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totvert, 0, NULL);
 }
 static void rna_MeshPolygonStringPropertyLayer_data_begin(CollectionPropertyIterator *iter,
@@ -2376,6 +2391,7 @@ static void rna_MeshPolygonStringPropertyLayer_data_begin(CollectionPropertyIter
 {
   Mesh *me = rna_mesh(ptr);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
+  CustomData_ensure_data_is_mutable(layer, me->totpoly);
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totpoly, 0, NULL);
 }
 
@@ -144,7 +144,7 @@ static void deformVerts(ModifierData *md,
 
     if (collmd->time_xnew == -1000) { /* first time */
 
-      collmd->x = MEM_dupallocN(BKE_mesh_vert_positions(mesh_src)); /* frame start position */
+      collmd->x = BKE_mesh_vert_coords_alloc(mesh_src, NULL); /* frame start position */
 
       for (uint i = 0; i < mvert_num; i++) {
         /* we save global positions */
@@ -175,6 +175,14 @@ PyObject *BPy_IDGroup_WrapData(ID *id, IDProperty *prop, IDProperty *parent)
   }
 }
 
+/* Properties are modified directly, tag the owner so the change is not missed by undo. */
+static void idprop_py_tag_owner_changed(ID *owner_id)
+{
+  if (owner_id != NULL) {
+    owner_id->tag |= LIB_TAG_UNDO_CHANGED;
+  }
+}
+
 /* UNUSED, currently assignment overwrites into new properties, rather than setting in-place. */
 #if 0
 static int BPy_IDGroup_SetData(BPy_IDProperty *self, IDProperty *prop, PyObject *value)
@@ -266,6 +274,7 @@ static int BPy_IDGroup_SetName(BPy_IDProperty *self, PyObject *value, void *UNUS
     return -1;
   }
 
+  idprop_py_tag_owner_changed(self->owner_id);
   memcpy(self->prop->name, name, name_size);
   return 0;
 }
@@ -797,6 +806,7 @@ int BPy_Wrap_SetMapItem(IDProperty *prop, PyObject *key, PyObject *val)
 
 static int BPy_IDGroup_Map_SetItem(BPy_IDProperty *self, PyObject *key, PyObject *val)
 {
+  idprop_py_tag_owner_changed(self->owner_id);
   return BPy_Wrap_SetMapItem(self->prop, key, val);
 }
 
@@ -1336,6 +1346,7 @@ static PyObject *BPy_IDGroup_pop(BPy_IDProperty *self, PyObject *args)
     return NULL;
   }
 
+  idprop_py_tag_owner_changed(self->owner_id);
   idprop = IDP_GetPropertyFromGroup(self->prop, key);
   if (idprop == NULL) {
     if (def == NULL) {
@@ -1557,6 +1568,7 @@ PyDoc_STRVAR(BPy_IDGroup_clear_doc,
              "   Clear all members from this group.\n");
 static PyObject *BPy_IDGroup_clear(BPy_IDProperty *self)
 {
+  idprop_py_tag_owner_changed(self->owner_id);
   IDP_ClearProperty(self->prop);
   Py_RETURN_NONE;
 }
@@ -1791,6 +1803,8 @@ static int BPy_IDArray_SetItem(BPy_IDArray *self, Py_ssize_t index, PyObject *va
     return -1;
   }
 
+  idprop_py_tag_owner_changed(self->owner_id);
+
   switch (self->prop->subtype) {
     case IDP_FLOAT: {
       const float f = (float)PyFloat_AsDouble(value);
@@ -1902,6 +1916,7 @@ static int BPy_IDArray_ass_slice(BPy_IDArray *self, int begin, int end, PyObject
   size_t size;
   void *vec;
 
+  idprop_py_tag_owner_changed(self->owner_id);
   CLAMP(begin, 0, prop->len);
   CLAMP(end, 0, prop->len);
   begin = MIN2(begin, end);
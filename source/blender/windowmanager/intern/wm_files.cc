@@ -66,6 +66,7 @@
 #include "BKE_callbacks.h"
 #include "BKE_context.h"
 #include "BKE_global.h"
+#include "BKE_gpencil_modifier_legacy.h"
 #include "BKE_idprop.h"
 #include "BKE_lib_id.h"
 #include "BKE_lib_override.h"
@@ -636,6 +637,7 @@ static void wm_file_read_pre(bool use_data, bool /*use_userdef*/)
 {
   if (use_data) {
     BLI_timer_on_file_load();
+    BKE_gpencil_modifier_free_caches();
   }
 
   /* Always do this as both startup and preferences may have loaded in many font's
@@ -820,6 +822,7 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
   double duration_lib_override_resync_minutes, duration_lib_override_resync_seconds;
   double duration_lib_override_recursive_resync_minutes,
       duration_lib_override_recursive_resync_seconds;
+  double duration_data_conversion_minutes, duration_data_conversion_seconds;
 
   BLI_math_time_seconds_decompose(bf_reports->duration.whole,
                                   nullptr,
@@ -851,9 +854,20 @@ static void file_read_reports_finalize(BlendFileReadReport *bf_reports)
                                   &duration_lib_override_recursive_resync_minutes,
                                   &duration_lib_override_recursive_resync_seconds,
                                   nullptr);
+  BLI_math_time_seconds_decompose(bf_reports->duration.data_conversion,
+                                  nullptr,
+                                  nullptr,
+                                  &duration_data_conversion_minutes,
+                                  &duration_data_conversion_seconds,
+                                  nullptr);
 
   CLOG_INFO(
       &LOG, 0, "Blender file read in %.0fm%.2fs", duration_whole_minutes, duration_whole_seconds);
+  CLOG_INFO(&LOG,
+            0,
+            " * Converting data: %.0fm%.2fs",
+            duration_data_conversion_minutes,
+            duration_data_conversion_seconds);
   CLOG_INFO(&LOG,
             0,
             " * Loading libraries: %.0fm%.2fs",